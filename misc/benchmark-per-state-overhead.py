@@ -0,0 +1,116 @@
+#! /usr/bin/env python3
+
+"""
+Measure the per-state overhead of eager and lazy search.
+
+The configurations use cheap heuristics, so the search time is dominated by
+the work done for each generated state (creating evaluation contexts,
+looking up cached evaluator results, inserting into open lists, etc.). For
+each configuration, the script reports the median search time per generated
+state over several runs. Pass --baseline to compare two builds, e.g., before
+and after a change to the evaluator cache:
+
+    ./misc/benchmark-per-state-overhead.py \\
+        --baseline old-build/bin/downward task.sas
+
+Tasks can be PDDL problem files (which are translated first) or SAS files.
+"""
+
+import argparse
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(DIR)
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+DEFAULT_DOWNWARD_BIN = os.path.join(
+    REPO, "builds", "release", "bin", "downward")
+DEFAULT_TASK = os.path.join(
+    REPO, "misc", "tests", "benchmarks", "gripper", "prob01.pddl")
+
+CONFIGS = {
+    "eager-blind": "astar(blind())",
+    "eager-goalcount": "eager_greedy([goalcount()])",
+    "eager-max": "astar(max([blind(), goalcount()]))",
+    "lazy-goalcount": "lazy_greedy([goalcount()])",
+    "lazy-alt": "lazy_greedy([goalcount(), blind()])",
+}
+
+SEARCH_TIME_REGEX = re.compile(r"Search time: (.+)s")
+GENERATED_REGEX = re.compile(r"Generated (\d+) state\(s\)\.")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("tasks", nargs="*", default=[DEFAULT_TASK],
+        help="PDDL problem files or SAS files (default: %(default)s)")
+    parser.add_argument("--downward", default=DEFAULT_DOWNWARD_BIN,
+        help="search binary to benchmark (default: %(default)s)")
+    parser.add_argument("--baseline",
+        help="search binary to compare against")
+    parser.add_argument("--repetitions", type=int, default=5,
+        help="number of runs per task and configuration (default: %(default)s)")
+    parser.add_argument("--configs", nargs="+", choices=sorted(CONFIGS),
+        default=sorted(CONFIGS), help="configurations to run (default: all)")
+    return parser.parse_args()
+
+
+def translate(task, sas_file):
+    subprocess.check_call(
+        [sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+         "--translate", task], stdout=subprocess.DEVNULL)
+
+
+def run_search(downward, sas_file, config):
+    with open(sas_file) as input_file:
+        output = subprocess.check_output(
+            [downward, "--search", config], stdin=input_file, text=True,
+            cwd=tempfile.gettempdir())
+    search_time = float(SEARCH_TIME_REGEX.search(output).group(1))
+    generated = int(GENERATED_REGEX.search(output).group(1))
+    return search_time, generated
+
+
+def measure(downward, sas_file, config, repetitions):
+    """Return the median search time per generated state in nanoseconds."""
+    times = []
+    for _ in range(repetitions):
+        search_time, generated = run_search(downward, sas_file, config)
+        times.append(search_time / max(generated, 1) * 1e9)
+    return statistics.median(times)
+
+
+def main():
+    args = parse_args()
+    binaries = [("new", os.path.abspath(args.downward))]
+    if args.baseline:
+        binaries.insert(0, ("baseline", os.path.abspath(args.baseline)))
+    header = ["task", "config"] + [
+        "{} [ns/state]".format(name) for name, _ in binaries]
+    if args.baseline:
+        header.append("change")
+    print("\t".join(header))
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for task in args.tasks:
+            sas_file = task
+            if not task.endswith(".sas"):
+                sas_file = os.path.join(tmp_dir, "output.sas")
+                translate(task, sas_file)
+            for config_name in args.configs:
+                config = CONFIGS[config_name]
+                results = [measure(binary, sas_file, config, args.repetitions)
+                           for _, binary in binaries]
+                row = [os.path.basename(task), config_name] + [
+                    "{:.1f}".format(result) for result in results]
+                if args.baseline:
+                    row.append("{:+.1%}".format(results[1] / results[0] - 1))
+                print("\t".join(row))
+
+
+if __name__ == "__main__":
+    main()
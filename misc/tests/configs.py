@@ -21,6 +21,9 @@ def configs_optimal_core():
         "astar_hmax": [
             "--search",
             "astar(hmax())"],
+        "hdastar_lmcut": [
+            "--search",
+            "hdastar(lmcut(), threads=2)"],
         "astar_merge_and_shrink_rl_fh": [
             "--search",
             "astar(merge_and_shrink("
@@ -59,6 +62,34 @@ def configs_optimal_core():
             "--search", "astar(blind(), pruning=stubborn_sets_ec())"],
         "blind-atom-centric-sss": [
             "--search", "astar(blind(), pruning=atom_centric_stubborn_sets())"],
+        # Partial expansion A*
+        "peastar_lmcut": [
+            "--search",
+            "peastar(lmcut(), enhanced=false)"],
+        "epeastar_pdb": [
+            "--search",
+            "peastar(pdb())"],
+        # IDA*
+        "idastar_lmcut": [
+            "--search",
+            "idastar(lmcut())"],
+        # Breadth-first heuristic search
+        "bfhs_lmcut": [
+            "--search",
+            "bfhs(lmcut())"],
+        # Symbolic search
+        "symbolic_ucs_bidirectional": [
+            "--search",
+            "symbolic_ucs()"],
+        # Bidirectional search
+        "mm_lmcut": [
+            "--search",
+            "mm(lmcut())"],
+        # Memory fallback
+        "memory_fallback_astar_idastar": [
+            "--memory-budget", "2000",
+            "--search",
+            "let(h,lmcut(),memory_fallback(astar(h),idastar(h)))"],
     }
 
 
@@ -81,6 +112,17 @@ def configs_satisficing_core():
         "eager_greedy_cea": [
             "--search",
             "let(h,cea(),eager_greedy([h],preferred=[h]))"],
+        "eager_greedy_ff_hash_compaction": [
+            "--hash-compaction",
+            "--search",
+            "let(h,ff(),eager_greedy([h],preferred=[h]))"],
+        # Parallel GBFS needs a separate evaluator instance per thread.
+        "eager_greedy_ff_threads": [
+            "--search",
+            "eager_greedy([ff()],preferred=[ff()],threads=2)"],
+        "lazy_greedy_ff_threads": [
+            "--search",
+            "lazy_greedy([ff()],preferred=[ff()],threads=2)"],
         # lazy greedy
         "lazy_greedy_ff": [
             "--search",
@@ -117,6 +159,10 @@ def configs_optimal_extended():
         "pdb": [
             "--search",
             "astar(pdb())"],
+        # Keys that keep increasing beyond the dense window of bucket lists.
+        "uniform_cost_large_keys": [
+            "--search",
+            "eager(single(weight(g(),100000)))"],
     }
 
 
@@ -156,6 +202,10 @@ def configs_satisficing_extended():
             "--search",
             "let(h,ff(),iterated([lazy_wastar([h],w=10), lazy_wastar([h],w=5), lazy_wastar([h],w=3),"
             "lazy_wastar([h],w=2), lazy_wastar([h],w=1)]))"],
+        "iterated_wa_ff_shared_registry": [
+            "--search",
+            "let(h,ff(),iterated([lazy_wastar([h],w=5), lazy_wastar([h],w=3),"
+            "lazy_wastar([h],w=1)], share_state_registry=true))"],
         # pareto open list
         "pareto_ff": [
             "--search",
@@ -39,6 +39,7 @@ SEARCH_TASKS = {
     "axioms": "philosophers/p01-phil2.pddl",
     "cond-eff": "miconic-simpleadl/s1-0.pddl",
     "large": "satellite/p25-HC-pfile5.pddl",
+    "single-step": "single-step/prob01.pddl",
 }
 
 MERGE_AND_SHRINK = ('astar(merge_and_shrink('
@@ -121,6 +122,16 @@ SEARCH_TESTS = [
         defaultdict(lambda: returncodes.SEARCH_UNSUPPORTED)),
     ("cond-eff", [], MERGE_AND_SHRINK,
         defaultdict(lambda: returncodes.SUCCESS)),
+    # One direction of the bidirectional search reaches the start state of
+    # the other direction before the other direction expands it.
+    ("single-step", [], "symbolic_ucs(direction=bidirectional)",
+        defaultdict(lambda: returncodes.SUCCESS)),
+    ("single-step", [], "symbolic_ucs(direction=forward)",
+        defaultdict(lambda: returncodes.SUCCESS)),
+    ("single-step", [], "symbolic_ucs(direction=backward)",
+        defaultdict(lambda: returncodes.SUCCESS)),
+    ("single-step", [], "mm(blind())",
+        defaultdict(lambda: returncodes.SUCCESS)),
     # We cannot set/enforce memory limits on Windows/macOS and thus expect
     # DRIVER_UNSUPPORTED as exit code in those cases.
     ("large", ["--search-memory-limit", "100M"], MERGE_AND_SHRINK,
@@ -1,5 +1,6 @@
 import os
 import pipes
+import re
 import subprocess
 import sys
 
@@ -15,9 +16,11 @@ SAS_FILE = os.path.join(REPO, "test.sas")
 PLAN_FILE = os.path.join(REPO, "test.plan")
 TASK = os.path.join(BENCHMARKS_DIR, "miconic/s1-0.pddl")
 
-CONFIGS_NOLP = {}
-CONFIGS_NOLP.update(configs.default_configs_optimal(core=True, extended=True))
-CONFIGS_NOLP.update(configs.default_configs_satisficing(core=True, extended=True))
+CONFIGS_OPTIMAL_NOLP = configs.default_configs_optimal(core=True, extended=True)
+CONFIGS_SATISFICING_NOLP = configs.default_configs_satisficing(core=True, extended=True)
+# Optimal configurations must find plans with the cost of this configuration.
+REFERENCE_CONFIG = ["--search", "astar(blind())"]
+OPTIMAL_COST = None
 
 
 def escape_list(l):
@@ -38,6 +41,20 @@ def run_plan_script(task, config, debug):
     subprocess.check_call(cmd, cwd=REPO)
 
 
+def get_plan_cost():
+    with open(PLAN_FILE) as f:
+        for line in f:
+            match = re.match(r"; cost = (\d+) ", line)
+            if match:
+                return int(match.group(1))
+    raise ValueError("no plan cost found in {}".format(PLAN_FILE))
+
+
+def run_optimal_config(task, config, debug):
+    run_plan_script(task, config, debug)
+    assert get_plan_cost() == OPTIMAL_COST, config
+
+
 def translate(task):
     subprocess.check_call([
         sys.executable, FAST_DOWNWARD, "--sas-file", SAS_FILE, "--translate", task], cwd=REPO)
@@ -49,25 +66,34 @@ def cleanup():
 
 
 def setup_module(module):
+    global OPTIMAL_COST
     translate(TASK)
+    run_plan_script(SAS_FILE, REFERENCE_CONFIG, debug=False)
+    OPTIMAL_COST = get_plan_cost()
 
 
-@pytest.mark.parametrize("config", sorted(CONFIGS_NOLP.values()))
+@pytest.mark.parametrize("config", sorted(CONFIGS_OPTIMAL_NOLP.values()))
 @pytest.mark.parametrize("debug", [False, True])
-def test_configs_nolp(config, debug):
+def test_configs_optimal_nolp(config, debug):
+    run_optimal_config(SAS_FILE, config, debug)
+
+
+@pytest.mark.parametrize("config", sorted(CONFIGS_SATISFICING_NOLP.values()))
+@pytest.mark.parametrize("debug", [False, True])
+def test_configs_satisficing_nolp(config, debug):
     run_plan_script(SAS_FILE, config, debug)
 
 
 @pytest.mark.parametrize("config", sorted(configs.configs_optimal_lp(lp_solver="cplex").values()))
 @pytest.mark.parametrize("debug", [False, True])
 def test_configs_cplex(config, debug):
-    run_plan_script(SAS_FILE, config, debug)
+    run_optimal_config(SAS_FILE, config, debug)
 
 
 @pytest.mark.parametrize("config", sorted(configs.configs_optimal_lp(lp_solver="soplex").values()))
 @pytest.mark.parametrize("debug", [False, True])
 def test_configs_soplex(config, debug):
-    run_plan_script(SAS_FILE, config, debug)
+    run_optimal_config(SAS_FILE, config, debug)
 
 
 def teardown_module(module):
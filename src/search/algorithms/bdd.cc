@@ -0,0 +1,568 @@
+#include "bdd.h"
+
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+namespace bdd {
+enum CacheOperation {
+    NO_OPERATION = -1,
+    AND,
+    OR,
+    NOT,
+    DIFF,
+    EXISTS,
+    AND_EXISTS
+};
+
+static uint64_t hash_triple(int a, int b, int c) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, a);
+    utils::feed(hash_state, b);
+    utils::feed(hash_state, c);
+    return hash_state.get_hash64();
+}
+
+static size_t get_power_of_two_at_least(size_t n) {
+    size_t result = 1;
+    while (result < n) {
+        result *= 2;
+    }
+    return result;
+}
+
+BDD::BDD(BDDManager *manager, int root) : manager(manager), root(root) {
+    manager->ref(root);
+}
+
+BDD::BDD() : manager(nullptr), root(-1) {
+}
+
+BDD::BDD(const BDD &other) : manager(other.manager), root(other.root) {
+    if (manager) {
+        manager->ref(root);
+    }
+}
+
+BDD::BDD(BDD &&other) : manager(other.manager), root(other.root) {
+    other.manager = nullptr;
+    other.root = -1;
+}
+
+BDD::~BDD() {
+    if (manager) {
+        manager->unref(root);
+    }
+}
+
+BDD &BDD::operator=(const BDD &other) {
+    if (other.manager) {
+        other.manager->ref(other.root);
+    }
+    if (manager) {
+        manager->unref(root);
+    }
+    manager = other.manager;
+    root = other.root;
+    return *this;
+}
+
+BDD &BDD::operator=(BDD &&other) {
+    if (this != &other) {
+        if (manager) {
+            manager->unref(root);
+        }
+        manager = other.manager;
+        root = other.root;
+        other.manager = nullptr;
+        other.root = -1;
+    }
+    return *this;
+}
+
+bool BDD::is_false() const {
+    assert(manager);
+    return root == BDDManager::FALSE_NODE;
+}
+
+bool BDD::is_true() const {
+    assert(manager);
+    return root == BDDManager::TRUE_NODE;
+}
+
+BDD BDD::operator&(const BDD &other) const {
+    assert(manager && manager == other.manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(manager->apply_and(root, other.root));
+}
+
+BDD BDD::operator|(const BDD &other) const {
+    assert(manager && manager == other.manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(manager->apply_or(root, other.root));
+}
+
+BDD BDD::operator-(const BDD &other) const {
+    assert(manager && manager == other.manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(manager->apply_diff(root, other.root));
+}
+
+BDD BDD::operator!() const {
+    assert(manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(manager->apply_not(root));
+}
+
+BDD &BDD::operator&=(const BDD &other) {
+    *this = *this & other;
+    return *this;
+}
+
+BDD &BDD::operator|=(const BDD &other) {
+    *this = *this | other;
+    return *this;
+}
+
+BDD &BDD::operator-=(const BDD &other) {
+    *this = *this - other;
+    return *this;
+}
+
+BDD BDD::exists(const BDD &cube) const {
+    assert(manager && manager == cube.manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(manager->apply_exists(root, cube.root));
+}
+
+BDD BDD::and_exists(const BDD &other, const BDD &cube) const {
+    assert(manager && manager == other.manager && manager == cube.manager);
+    manager->collect_garbage_if_necessary();
+    return manager->make_bdd(
+        manager->apply_and_exists(root, other.root, cube.root));
+}
+
+int BDD::get_num_nodes() const {
+    assert(manager);
+    return manager->count_nodes(root);
+}
+
+double BDD::count_models() const {
+    assert(manager);
+    return manager->count_models(root);
+}
+
+vector<int> BDD::pick_model() const {
+    assert(manager);
+    return manager->pick_model(root);
+}
+
+BDDManager::BDDManager(int num_variables, int initial_gc_threshold)
+    : num_variables(num_variables),
+      unique_table_mask(0),
+      computed_cache_mask(0),
+      num_live_nodes(2),
+      gc_threshold(max(initial_gc_threshold, 1024)),
+      num_garbage_collections(0) {
+    // The terminal nodes are below all variables.
+    nodes.push_back({num_variables, FALSE_NODE, FALSE_NODE});
+    nodes.push_back({num_variables, TRUE_NODE, TRUE_NODE});
+    // Terminal nodes are never collected.
+    ref_counts.assign(2, 1);
+    resize_unique_table(1024);
+    size_t cache_size = get_power_of_two_at_least(gc_threshold / 4);
+    computed_cache.assign(cache_size, {NO_OPERATION, 0, 0, 0, 0});
+    computed_cache_mask = cache_size - 1;
+}
+
+void BDDManager::insert_into_unique_table(int node) {
+    const Node &n = nodes[node];
+    uint64_t slot = hash_triple(n.var, n.low, n.high) & unique_table_mask;
+    while (unique_table[slot] != -1) {
+        slot = (slot + 1) & unique_table_mask;
+    }
+    unique_table[slot] = node;
+}
+
+void BDDManager::resize_unique_table(size_t num_slots) {
+    assert(num_slots == get_power_of_two_at_least(num_slots));
+    unique_table.assign(num_slots, -1);
+    unique_table_mask = num_slots - 1;
+    for (size_t node = 2; node < nodes.size(); ++node) {
+        if (nodes[node].var != -1) {
+            insert_into_unique_table(node);
+        }
+    }
+}
+
+int BDDManager::make_node(int var, int low, int high) {
+    if (low == high) {
+        return low;
+    }
+    assert(var < get_var(low) && var < get_var(high));
+    uint64_t slot = hash_triple(var, low, high) & unique_table_mask;
+    while (unique_table[slot] != -1) {
+        const Node &n = nodes[unique_table[slot]];
+        if (n.var == var && n.low == low && n.high == high) {
+            return unique_table[slot];
+        }
+        slot = (slot + 1) & unique_table_mask;
+    }
+    int node;
+    if (free_nodes.empty()) {
+        node = nodes.size();
+        nodes.push_back({var, low, high});
+        ref_counts.push_back(0);
+    } else {
+        node = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[node] = {var, low, high};
+    }
+    ++num_live_nodes;
+    unique_table[slot] = node;
+    if (2 * static_cast<size_t>(num_live_nodes) > unique_table.size()) {
+        resize_unique_table(2 * unique_table.size());
+    }
+    return node;
+}
+
+void BDDManager::collect_garbage_if_necessary() {
+    if (num_live_nodes >= gc_threshold) {
+        collect_garbage();
+        if (num_live_nodes > gc_threshold / 2) {
+            gc_threshold *= 2;
+            size_t cache_size = get_power_of_two_at_least(gc_threshold / 4);
+            computed_cache.assign(cache_size, {NO_OPERATION, 0, 0, 0, 0});
+            computed_cache_mask = cache_size - 1;
+        }
+    }
+}
+
+void BDDManager::collect_garbage() {
+    vector<bool> marked(nodes.size(), false);
+    vector<int> stack;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        if (ref_counts[node] > 0) {
+            assert(nodes[node].var != -1);
+            stack.push_back(node);
+        }
+    }
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        if (!marked[node]) {
+            marked[node] = true;
+            if (node > TRUE_NODE) {
+                stack.push_back(nodes[node].low);
+                stack.push_back(nodes[node].high);
+            }
+        }
+    }
+
+    free_nodes.clear();
+    num_live_nodes = 0;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        if (marked[node]) {
+            ++num_live_nodes;
+        } else {
+            nodes[node].var = -1;
+            free_nodes.push_back(node);
+        }
+    }
+    // Reuse low node IDs first.
+    reverse(free_nodes.begin(), free_nodes.end());
+    resize_unique_table(unique_table.size());
+    fill(
+        computed_cache.begin(), computed_cache.end(),
+        CacheEntry{NO_OPERATION, 0, 0, 0, 0});
+    ++num_garbage_collections;
+}
+
+BDDManager::CacheEntry &BDDManager::get_cache_entry(
+    int op, int f, int g, int h) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, op);
+    utils::feed(hash_state, f);
+    utils::feed(hash_state, g);
+    utils::feed(hash_state, h);
+    return computed_cache[hash_state.get_hash64() & computed_cache_mask];
+}
+
+int BDDManager::lookup_cache(int op, int f, int g, int h) {
+    const CacheEntry &entry = get_cache_entry(op, f, g, h);
+    if (entry.op == op && entry.f == f && entry.g == g && entry.h == h) {
+        return entry.result;
+    }
+    return -1;
+}
+
+void BDDManager::store_in_cache(int op, int f, int g, int h, int result) {
+    get_cache_entry(op, f, g, h) = {op, f, g, h, result};
+}
+
+/*
+  The recursive operations below copy the children of nodes before
+  recursing, because creating nodes can reallocate the node vector.
+*/
+int BDDManager::apply_and(int f, int g) {
+    if (f == FALSE_NODE || g == FALSE_NODE)
+        return FALSE_NODE;
+    if (f == TRUE_NODE || f == g)
+        return g;
+    if (g == TRUE_NODE)
+        return f;
+    if (f > g)
+        swap(f, g);
+    int result = lookup_cache(AND, f, g, 0);
+    if (result != -1)
+        return result;
+    int var = min(get_var(f), get_var(g));
+    Node nf = nodes[f];
+    Node ng = nodes[g];
+    int f0 = nf.var == var ? nf.low : f;
+    int f1 = nf.var == var ? nf.high : f;
+    int g0 = ng.var == var ? ng.low : g;
+    int g1 = ng.var == var ? ng.high : g;
+    int low = apply_and(f0, g0);
+    int high = apply_and(f1, g1);
+    result = make_node(var, low, high);
+    store_in_cache(AND, f, g, 0, result);
+    return result;
+}
+
+int BDDManager::apply_or(int f, int g) {
+    if (f == TRUE_NODE || g == TRUE_NODE)
+        return TRUE_NODE;
+    if (f == FALSE_NODE || f == g)
+        return g;
+    if (g == FALSE_NODE)
+        return f;
+    if (f > g)
+        swap(f, g);
+    int result = lookup_cache(OR, f, g, 0);
+    if (result != -1)
+        return result;
+    int var = min(get_var(f), get_var(g));
+    Node nf = nodes[f];
+    Node ng = nodes[g];
+    int f0 = nf.var == var ? nf.low : f;
+    int f1 = nf.var == var ? nf.high : f;
+    int g0 = ng.var == var ? ng.low : g;
+    int g1 = ng.var == var ? ng.high : g;
+    int low = apply_or(f0, g0);
+    int high = apply_or(f1, g1);
+    result = make_node(var, low, high);
+    store_in_cache(OR, f, g, 0, result);
+    return result;
+}
+
+int BDDManager::apply_not(int f) {
+    if (f == FALSE_NODE)
+        return TRUE_NODE;
+    if (f == TRUE_NODE)
+        return FALSE_NODE;
+    int result = lookup_cache(NOT, f, 0, 0);
+    if (result != -1)
+        return result;
+    Node nf = nodes[f];
+    int low = apply_not(nf.low);
+    int high = apply_not(nf.high);
+    result = make_node(nf.var, low, high);
+    store_in_cache(NOT, f, 0, 0, result);
+    return result;
+}
+
+int BDDManager::apply_diff(int f, int g) {
+    if (f == FALSE_NODE || g == TRUE_NODE || f == g)
+        return FALSE_NODE;
+    if (g == FALSE_NODE)
+        return f;
+    if (f == TRUE_NODE)
+        return apply_not(g);
+    int result = lookup_cache(DIFF, f, g, 0);
+    if (result != -1)
+        return result;
+    int var = min(get_var(f), get_var(g));
+    Node nf = nodes[f];
+    Node ng = nodes[g];
+    int f0 = nf.var == var ? nf.low : f;
+    int f1 = nf.var == var ? nf.high : f;
+    int g0 = ng.var == var ? ng.low : g;
+    int g1 = ng.var == var ? ng.high : g;
+    int low = apply_diff(f0, g0);
+    int high = apply_diff(f1, g1);
+    result = make_node(var, low, high);
+    store_in_cache(DIFF, f, g, 0, result);
+    return result;
+}
+
+int BDDManager::apply_exists(int f, int cube) {
+    if (f == FALSE_NODE || f == TRUE_NODE)
+        return f;
+    int var = get_var(f);
+    while (get_var(cube) < var) {
+        cube = nodes[cube].high;
+    }
+    if (cube == TRUE_NODE)
+        return f;
+    int result = lookup_cache(EXISTS, f, cube, 0);
+    if (result != -1)
+        return result;
+    Node nf = nodes[f];
+    if (get_var(cube) == var) {
+        int next_cube = nodes[cube].high;
+        int low = apply_exists(nf.low, next_cube);
+        if (low == TRUE_NODE) {
+            result = TRUE_NODE;
+        } else {
+            result = apply_or(low, apply_exists(nf.high, next_cube));
+        }
+    } else {
+        int low = apply_exists(nf.low, cube);
+        int high = apply_exists(nf.high, cube);
+        result = make_node(var, low, high);
+    }
+    store_in_cache(EXISTS, f, cube, 0, result);
+    return result;
+}
+
+int BDDManager::apply_and_exists(int f, int g, int cube) {
+    if (f == FALSE_NODE || g == FALSE_NODE)
+        return FALSE_NODE;
+    if (f == TRUE_NODE || f == g)
+        return apply_exists(g, cube);
+    if (g == TRUE_NODE)
+        return apply_exists(f, cube);
+    if (f > g)
+        swap(f, g);
+    int var = min(get_var(f), get_var(g));
+    while (get_var(cube) < var) {
+        cube = nodes[cube].high;
+    }
+    if (cube == TRUE_NODE)
+        return apply_and(f, g);
+    int result = lookup_cache(AND_EXISTS, f, g, cube);
+    if (result != -1)
+        return result;
+    Node nf = nodes[f];
+    Node ng = nodes[g];
+    int f0 = nf.var == var ? nf.low : f;
+    int f1 = nf.var == var ? nf.high : f;
+    int g0 = ng.var == var ? ng.low : g;
+    int g1 = ng.var == var ? ng.high : g;
+    if (get_var(cube) == var) {
+        int next_cube = nodes[cube].high;
+        int low = apply_and_exists(f0, g0, next_cube);
+        if (low == TRUE_NODE) {
+            result = TRUE_NODE;
+        } else {
+            result = apply_or(low, apply_and_exists(f1, g1, next_cube));
+        }
+    } else {
+        int low = apply_and_exists(f0, g0, cube);
+        int high = apply_and_exists(f1, g1, cube);
+        result = make_node(var, low, high);
+    }
+    store_in_cache(AND_EXISTS, f, g, cube, result);
+    return result;
+}
+
+int BDDManager::count_nodes(int root) const {
+    utils::HashSet<int> visited;
+    vector<int> stack = {root};
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        if (visited.insert(node).second && node > TRUE_NODE) {
+            stack.push_back(nodes[node].low);
+            stack.push_back(nodes[node].high);
+        }
+    }
+    return visited.size();
+}
+
+double BDDManager::count_models(int root) const {
+    /*
+      We compute the fraction of all assignments that satisfy the BDD
+      rooted at each node, which does not depend on the variables skipped
+      above the node.
+    */
+    utils::HashMap<int, double> fractions;
+    fractions[FALSE_NODE] = 0;
+    fractions[TRUE_NODE] = 1;
+    vector<int> stack = {root};
+    while (!stack.empty()) {
+        int node = stack.back();
+        if (fractions.count(node)) {
+            stack.pop_back();
+            continue;
+        }
+        const Node &n = nodes[node];
+        auto low_it = fractions.find(n.low);
+        auto high_it = fractions.find(n.high);
+        if (low_it != fractions.end() && high_it != fractions.end()) {
+            fractions[node] = (low_it->second + high_it->second) / 2;
+            stack.pop_back();
+        } else {
+            stack.push_back(n.low);
+            stack.push_back(n.high);
+        }
+    }
+    return ldexp(fractions[root], num_variables);
+}
+
+vector<int> BDDManager::pick_model(int root) const {
+    assert(root != FALSE_NODE);
+    vector<int> values(num_variables, 0);
+    int node = root;
+    while (node != TRUE_NODE) {
+        const Node &n = nodes[node];
+        // Each non-false node has a path to the true node.
+        if (n.low != FALSE_NODE) {
+            node = n.low;
+        } else {
+            values[n.var] = 1;
+            node = n.high;
+        }
+    }
+    return values;
+}
+
+BDD BDDManager::get_false() {
+    return make_bdd(FALSE_NODE);
+}
+
+BDD BDDManager::get_true() {
+    return make_bdd(TRUE_NODE);
+}
+
+BDD BDDManager::variable(int var) {
+    assert(var >= 0 && var < num_variables);
+    collect_garbage_if_necessary();
+    return make_bdd(make_node(var, FALSE_NODE, TRUE_NODE));
+}
+
+BDD BDDManager::negated_variable(int var) {
+    assert(var >= 0 && var < num_variables);
+    collect_garbage_if_necessary();
+    return make_bdd(make_node(var, TRUE_NODE, FALSE_NODE));
+}
+
+BDD BDDManager::cube(const vector<int> &vars) {
+    collect_garbage_if_necessary();
+    vector<int> sorted_vars(vars);
+    sort(sorted_vars.begin(), sorted_vars.end());
+    sorted_vars.erase(
+        unique(sorted_vars.begin(), sorted_vars.end()), sorted_vars.end());
+    int root = TRUE_NODE;
+    for (auto it = sorted_vars.rbegin(); it != sorted_vars.rend(); ++it) {
+        root = make_node(*it, FALSE_NODE, root);
+    }
+    return make_bdd(root);
+}
+}
@@ -0,0 +1,191 @@
+#ifndef ALGORITHMS_BDD_H
+#define ALGORITHMS_BDD_H
+
+#include <cstdint>
+#include <vector>
+
+/*
+  A small package for reduced ordered binary decision diagrams (BDDs).
+
+  BDDManager stores the nodes of all BDDs over a fixed number of binary
+  variables, ordered by their indices. Nodes are unique: a unique table maps
+  each triple (variable, low child, high child) to its node, so two BDDs
+  represent the same function iff they have the same root node. Results of
+  operations are memoized in a direct-mapped computed cache, which is
+  overwritten on collisions.
+
+  Users only hold BDD objects, which count the references to their root
+  nodes. Nodes that are not reachable from any referenced root are garbage.
+  The manager collects garbage before an operation when the number of nodes
+  exceeds a threshold: it marks all nodes reachable from referenced roots,
+  puts the others on a free list and clears the computed cache. Garbage is
+  never collected during an operation, so intermediate results do not need
+  references.
+
+  Unlike the BDD packages usually used in symbolic planning (e.g., CUDD), we
+  do not use complement edges or dynamic variable reordering.
+*/
+namespace bdd {
+class BDDManager;
+
+class BDD {
+    friend class BDDManager;
+
+    BDDManager *manager;
+    int root;
+
+    BDD(BDDManager *manager, int root);
+
+public:
+    // Create an invalid BDD that can only be assigned to.
+    BDD();
+    BDD(const BDD &other);
+    BDD(BDD &&other);
+    ~BDD();
+    BDD &operator=(const BDD &other);
+    BDD &operator=(BDD &&other);
+
+    bool is_false() const;
+    bool is_true() const;
+
+    bool operator==(const BDD &other) const {
+        return root == other.root;
+    }
+
+    bool operator!=(const BDD &other) const {
+        return root != other.root;
+    }
+
+    BDD operator&(const BDD &other) const;
+    BDD operator|(const BDD &other) const;
+    // Set difference, i.e., conjunction with the negation of other.
+    BDD operator-(const BDD &other) const;
+    BDD operator!() const;
+    BDD &operator&=(const BDD &other);
+    BDD &operator|=(const BDD &other);
+    BDD &operator-=(const BDD &other);
+
+    /*
+      Existential quantification over the variables of the given cube, which
+      must be a conjunction of positive variables (see BDDManager::cube).
+    */
+    BDD exists(const BDD &cube) const;
+    // Compute (*this & other).exists(cube) without building the conjunction.
+    BDD and_exists(const BDD &other, const BDD &cube) const;
+
+    int get_num_nodes() const;
+    /*
+      Return the number of satisfying assignments of all variables of the
+      manager, as a double because it can exceed the range of integers.
+    */
+    double count_models() const;
+    /*
+      Return a satisfying assignment, which must exist, with value 0 for
+      variables the BDD does not depend on.
+    */
+    std::vector<int> pick_model() const;
+};
+
+class BDDManager {
+    friend class BDD;
+
+    struct Node {
+        // Variable of the node, or -1 for nodes on the free list.
+        int var;
+        int low;
+        int high;
+    };
+
+    struct CacheEntry {
+        int op;
+        int f;
+        int g;
+        int h;
+        int result;
+    };
+
+    static constexpr int FALSE_NODE = 0;
+    static constexpr int TRUE_NODE = 1;
+
+    const int num_variables;
+    std::vector<Node> nodes;
+    std::vector<int> ref_counts;
+    std::vector<int> free_nodes;
+    // Open addressing with linear probing, -1 for empty slots.
+    std::vector<int> unique_table;
+    std::uint64_t unique_table_mask;
+    std::vector<CacheEntry> computed_cache;
+    std::uint64_t computed_cache_mask;
+    int num_live_nodes;
+    int gc_threshold;
+    int num_garbage_collections;
+
+    int get_var(int node) const {
+        return nodes[node].var;
+    }
+
+    void ref(int node) {
+        ++ref_counts[node];
+    }
+
+    void unref(int node) {
+        --ref_counts[node];
+    }
+
+    int make_node(int var, int low, int high);
+    void insert_into_unique_table(int node);
+    void resize_unique_table(std::size_t num_slots);
+    void collect_garbage_if_necessary();
+    void collect_garbage();
+
+    CacheEntry &get_cache_entry(int op, int f, int g, int h);
+    int lookup_cache(int op, int f, int g, int h);
+    void store_in_cache(int op, int f, int g, int h, int result);
+
+    int apply_and(int f, int g);
+    int apply_or(int f, int g);
+    int apply_not(int f);
+    int apply_diff(int f, int g);
+    int apply_exists(int f, int cube);
+    int apply_and_exists(int f, int g, int cube);
+    int count_nodes(int root) const;
+    double count_models(int root) const;
+    std::vector<int> pick_model(int root) const;
+
+    BDD make_bdd(int root) {
+        return BDD(this, root);
+    }
+
+public:
+    /*
+      The manager collects garbage when the number of nodes reaches
+      initial_gc_threshold. If more than half of the nodes survive, the
+      threshold is doubled.
+    */
+    explicit BDDManager(int num_variables, int initial_gc_threshold = 1 << 20);
+
+    BDDManager(const BDDManager &) = delete;
+    BDDManager &operator=(const BDDManager &) = delete;
+
+    int get_num_variables() const {
+        return num_variables;
+    }
+
+    BDD get_false();
+    BDD get_true();
+    BDD variable(int var);
+    BDD negated_variable(int var);
+    // Conjunction of the given variables (in any order).
+    BDD cube(const std::vector<int> &vars);
+
+    int get_num_live_nodes() const {
+        return num_live_nodes;
+    }
+
+    int get_num_garbage_collections() const {
+        return num_garbage_collections;
+    }
+};
+}
+
+#endif
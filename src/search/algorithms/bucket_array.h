@@ -0,0 +1,386 @@
+#ifndef ALGORITHMS_BUCKET_ARRAY_H
+#define ALGORITHMS_BUCKET_ARRAY_H
+
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+  Building blocks for open lists with integer keys.
+
+  FifoBucket is a FIFO queue stored in a single vector. Unlike a deque, it
+  does not allocate memory when elements are pushed after the bucket has been
+  emptied, because clearing the vector keeps its capacity.
+
+  BucketArray maps integer keys to buckets. Buckets are stored in a dense
+  array indexed by key, so finding the bucket of a key takes constant time.
+  The array covers a window of at most MAX_DENSE_BUCKETS consecutive keys.
+  Keys outside of this window (e.g., very large f-values in tasks with high
+  action costs or "infinite" estimates) are stored in an ordered map instead,
+  so the memory usage is bounded even for sparse keys.
+
+  We cache the index of the first dense bucket that is possibly non-empty.
+  Since the keys popped from an open list are usually non-decreasing, the
+  cached minimum only moves forward most of the time and finding the minimum
+  takes amortized constant time. For the same reason, the window follows the
+  keys: when a key outside of the window is inserted after the minimum has
+  moved past the window (i.e., the dense part is empty) or past half of it,
+  the window starts anew at the minimum key, and the buckets of the map that
+  fall into it are moved into the dense array. Keys below the window move
+  the window down. Moving the window is amortized over the insertions, so
+  keys that alternate between distant ranges cannot make it move all the
+  time.
+
+  The bucket type must provide empty(), clear() and compact(), which
+  releases memory that the bucket does not need for its current entries.
+  BucketArray keeps track
+  of its non-empty buckets: every call to get_bucket_for_insertion() must be
+  followed by inserting into the returned bucket, and pop_min_bucket_if_empty()
+  must be called after removing elements from the minimum bucket. Buckets
+  can be BucketArrays themselves, which gives lexicographic orderings of
+  several keys.
+
+  BucketHeap offers the same interface for arbitrary ordered and hashable
+  keys such as tuples of evaluator values. A hash map finds the bucket of a
+  key and a binary heap contains the keys of all non-empty buckets. Only
+  creating and removing buckets touches the heap, so inserting into an
+  existing bucket takes constant time. Buckets are recycled, so their memory
+  is reused for later keys.
+*/
+namespace bucket_array {
+template<typename Entry>
+class FifoBucket {
+    std::vector<Entry> entries;
+    size_t head;
+
+public:
+    FifoBucket() : head(0) {
+    }
+
+    bool empty() const {
+        return head == entries.size();
+    }
+
+    void push(const Entry &entry) {
+        entries.push_back(entry);
+    }
+
+    Entry pop() {
+        assert(!empty());
+        Entry result = entries[head++];
+        if (head == entries.size()) {
+            entries.clear();
+            head = 0;
+        } else if (head >= 1024 && 2 * head >= entries.size()) {
+            // Reclaim the space of popped entries in long-lived buckets.
+            entries.erase(entries.begin(), entries.begin() + head);
+            head = 0;
+        }
+        return result;
+    }
+
+    void clear() {
+        entries.clear();
+        head = 0;
+    }
+
+    void compact() {
+        entries.erase(entries.begin(), entries.begin() + head);
+        head = 0;
+        entries.shrink_to_fit();
+    }
+};
+
+template<typename Bucket>
+class BucketArray {
+    static const int MAX_DENSE_BUCKETS = 1 << 16;
+    /*
+      Moving the window takes time linear in the number of dense buckets.
+      Each insertion pays for moving this many buckets, and we only move the
+      window if enough has been paid since the last move. This bounds the
+      amortized time per insertion even if the keys alternate between
+      distant ranges.
+    */
+    static const int MOVE_CREDITS_PER_INSERTION = 16;
+
+    // Bucket i of the dense array stores the entries with key offset + i.
+    std::vector<Bucket> buckets;
+    int offset;
+    // All dense buckets before this index are empty.
+    int min_index;
+    std::map<int, Bucket> sparse_buckets;
+    int num_non_empty_buckets;
+    long long move_credits;
+    // Whether the last call of get_min_bucket() returned a dense bucket.
+    bool min_bucket_was_dense;
+
+    bool is_in_dense_range(int key) const {
+        return key >= offset &&
+               static_cast<long long>(key) - offset < MAX_DENSE_BUCKETS;
+    }
+
+    Bucket &get_dense_bucket(int key) {
+        assert(is_in_dense_range(key));
+        int index = key - offset;
+        if (index >= static_cast<int>(buckets.size())) {
+            buckets.resize(index + 1);
+        }
+        if (index < min_index) {
+            min_index = index;
+        }
+        return buckets[index];
+    }
+
+    /*
+      Let the window start at the given key. Dense buckets outside of the new
+      window are moved to the sparse buckets and sparse buckets inside of it
+      are moved to the dense array.
+    */
+    void move_window(int new_offset) {
+        std::vector<Bucket> old_buckets;
+        old_buckets.swap(buckets);
+        int old_offset = offset;
+        int old_min_index = min_index;
+        offset = new_offset;
+        min_index = 0;
+        auto it = sparse_buckets.lower_bound(offset);
+        while (it != sparse_buckets.end() && is_in_dense_range(it->first)) {
+            get_dense_bucket(it->first) = std::move(it->second);
+            it = sparse_buckets.erase(it);
+        }
+        for (int index = old_min_index;
+             index < static_cast<int>(old_buckets.size()); ++index) {
+            if (!old_buckets[index].empty()) {
+                int key = old_offset + index;
+                if (is_in_dense_range(key)) {
+                    get_dense_bucket(key) = std::move(old_buckets[index]);
+                } else {
+                    sparse_buckets.emplace(key, std::move(old_buckets[index]));
+                }
+            }
+        }
+    }
+
+    /*
+      Called when the given key lies outside of the window. If the key is
+      smaller than the window, we move the window down and leave room for
+      smaller keys, because such keys often keep decreasing (e.g., heuristic
+      values in greedy search). If the dense part is empty or its minimum
+      has passed half of the window, the keys have grown (e.g., f-values in
+      A*), and we let the window start at the minimum key.
+    */
+    void try_move_window(int key) {
+        long long new_offset;
+        if (key < offset) {
+            new_offset = std::max<long long>(
+                std::numeric_limits<int>::min(),
+                static_cast<long long>(key) - MAX_DENSE_BUCKETS / 4);
+        } else if (dense_part_is_empty()) {
+            new_offset = key;
+            auto it = sparse_buckets.lower_bound(offset);
+            if (it != sparse_buckets.end() && it->first < key) {
+                new_offset = it->first;
+            }
+        } else if (min_index >= MAX_DENSE_BUCKETS / 2) {
+            new_offset = offset + min_index;
+        } else {
+            return;
+        }
+        long long cost = buckets.size();
+        if (move_credits >= cost) {
+            move_credits -= cost;
+            move_window(new_offset);
+        }
+    }
+
+    bool dense_part_is_empty() {
+        int num_buckets = buckets.size();
+        while (min_index < num_buckets && buckets[min_index].empty()) {
+            ++min_index;
+        }
+        return min_index == num_buckets;
+    }
+
+    bool min_bucket_is_dense() {
+        assert(!empty());
+        if (dense_part_is_empty()) {
+            return false;
+        }
+        return sparse_buckets.empty() ||
+               offset + min_index < sparse_buckets.begin()->first;
+    }
+
+public:
+    BucketArray()
+        : offset(0),
+          min_index(0),
+          num_non_empty_buckets(0),
+          move_credits(0),
+          min_bucket_was_dense(false) {
+    }
+
+    bool empty() const {
+        return num_non_empty_buckets == 0;
+    }
+
+    Bucket &get_bucket_for_insertion(int key) {
+        if (empty() && buckets.empty() && sparse_buckets.empty()) {
+            // Negative keys are rare, so we usually start the array at 0.
+            offset = key < 0 ? key : 0;
+        }
+        move_credits += MOVE_CREDITS_PER_INSERTION;
+        if (!is_in_dense_range(key)) {
+            try_move_window(key);
+        }
+        Bucket *bucket;
+        if (is_in_dense_range(key)) {
+            bucket = &get_dense_bucket(key);
+        } else {
+            bucket = &sparse_buckets[key];
+        }
+        if (bucket->empty()) {
+            ++num_non_empty_buckets;
+        }
+        return *bucket;
+    }
+
+    Bucket &get_min_bucket() {
+        min_bucket_was_dense = min_bucket_is_dense();
+        if (min_bucket_was_dense) {
+            return buckets[min_index];
+        }
+        return sparse_buckets.begin()->second;
+    }
+
+    /*
+      Remove the bucket returned by the last call of get_min_bucket() if it
+      is empty. There must be no insertions in between.
+    */
+    void pop_min_bucket_if_empty() {
+        if (min_bucket_was_dense) {
+            if (buckets[min_index].empty()) {
+                --num_non_empty_buckets;
+                ++min_index;
+            }
+        } else {
+            auto it = sparse_buckets.begin();
+            if (it->second.empty()) {
+                --num_non_empty_buckets;
+                sparse_buckets.erase(it);
+            }
+        }
+    }
+
+    void clear() {
+        for (Bucket &bucket : buckets) {
+            bucket.clear();
+        }
+        min_index = buckets.size();
+        sparse_buckets.clear();
+        num_non_empty_buckets = 0;
+    }
+
+    /*
+      Release unused memory: remove the empty dense buckets before the
+      minimum and after the maximum, and free the memory of the remaining
+      empty buckets.
+    */
+    void compact() {
+        dense_part_is_empty();
+        if (min_index > 0) {
+            move_window(offset + min_index);
+        }
+        while (!buckets.empty() && buckets.back().empty()) {
+            buckets.pop_back();
+        }
+        for (Bucket &bucket : buckets) {
+            if (bucket.empty()) {
+                bucket = Bucket();
+            } else {
+                bucket.compact();
+            }
+        }
+        buckets.shrink_to_fit();
+        for (auto &key_and_bucket : sparse_buckets) {
+            key_and_bucket.second.compact();
+        }
+    }
+};
+
+template<typename Key, typename Bucket>
+class BucketHeap {
+    using HeapEntry = std::pair<Key, int>;
+
+    std::vector<Bucket> buckets;
+    std::vector<int> free_bucket_ids;
+    utils::HashMap<Key, int> key_to_bucket_id;
+    std::priority_queue<
+        HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>>
+        heap;
+
+public:
+    bool empty() const {
+        return heap.empty();
+    }
+
+    Bucket &get_bucket_for_insertion(const Key &key) {
+        auto it = key_to_bucket_id.find(key);
+        if (it != key_to_bucket_id.end()) {
+            return buckets[it->second];
+        }
+        int bucket_id;
+        if (free_bucket_ids.empty()) {
+            bucket_id = buckets.size();
+            buckets.emplace_back();
+        } else {
+            bucket_id = free_bucket_ids.back();
+            free_bucket_ids.pop_back();
+        }
+        key_to_bucket_id.emplace(key, bucket_id);
+        heap.emplace(key, bucket_id);
+        return buckets[bucket_id];
+    }
+
+    Bucket &get_min_bucket() {
+        assert(!empty());
+        return buckets[heap.top().second];
+    }
+
+    void pop_min_bucket_if_empty() {
+        int bucket_id = heap.top().second;
+        if (buckets[bucket_id].empty()) {
+            key_to_bucket_id.erase(heap.top().first);
+            free_bucket_ids.push_back(bucket_id);
+            heap.pop();
+        }
+    }
+
+    void clear() {
+        buckets.clear();
+        free_bucket_ids.clear();
+        key_to_bucket_id.clear();
+        heap = decltype(heap)();
+    }
+
+    // Release unused memory, e.g., of recycled buckets.
+    void compact() {
+        for (Bucket &bucket : buckets) {
+            if (bucket.empty()) {
+                bucket = Bucket();
+            } else {
+                bucket.compact();
+            }
+        }
+    }
+};
+}
+
+#endif
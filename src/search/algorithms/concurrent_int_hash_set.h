@@ -0,0 +1,118 @@
+#ifndef ALGORITHMS_CONCURRENT_INT_HASH_SET_H
+#define ALGORITHMS_CONCURRENT_INT_HASH_SET_H
+
+#include "int_hash_set.h"
+
+#include "../utils/logging.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace int_hash_set {
+/*
+  Thread-safe hash set for storing non-negative integer keys.
+
+  The set is striped into NUM_SHARDS independent IntHashSets, each protected
+  by its own mutex. The shard of a key is determined by the uppermost bits of
+  its hash, while the IntHashSet of the shard uses the lowermost bits to find
+  the bucket, so both levels see uniformly distributed hashes. Threads only
+  contend if they access the same shard at the same time, and a shard that
+  grows only blocks the threads that access it.
+
+  In addition to insert(), the set offers find_or_insert(), which looks for an
+  object by hash and predicate and only creates a key for it if no matching
+  key exists. This makes it possible to store objects in an append-only
+  container (see ConcurrentSegmentedArrayVector) without storing duplicates.
+*/
+template<typename Hasher, typename Equal>
+class ConcurrentIntHashSet {
+    static const int NUM_SHARDS_LOG = 6;
+    static const int NUM_SHARDS = 1 << NUM_SHARDS_LOG;
+
+    struct Shard {
+        std::mutex mutex;
+        IntHashSet<Hasher, Equal> set;
+
+        Shard(const Hasher &hasher, const Equal &equal) : set(hasher, equal) {
+        }
+    };
+
+    Hasher hasher;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<int> num_entries;
+
+    Shard &get_shard(HashType hash) {
+        return *shards[hash >> (32 - NUM_SHARDS_LOG)];
+    }
+
+public:
+    ConcurrentIntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher), num_entries(0) {
+        shards.reserve(NUM_SHARDS);
+        for (int i = 0; i < NUM_SHARDS; ++i) {
+            shards.push_back(std::make_unique<Shard>(hasher, equal));
+        }
+    }
+
+    int size() const {
+        return num_entries.load(std::memory_order_relaxed);
+    }
+
+    // See IntHashSet::insert(). Can be called by several threads at once.
+    std::pair<KeyType, bool> insert(KeyType key) {
+        HashType hash = hasher(key);
+        Shard &shard = get_shard(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::pair<KeyType, bool> result = shard.set.insert_with_hash(key, hash);
+        if (result.second) {
+            ++num_entries;
+        }
+        return result;
+    }
+
+    /*
+      Return a key with the given hash for which matches(key) is true. If
+      there is no such key, call create_key() to create a new key, insert it
+      and return it. The new key must have the given hash. As for insert(), the
+      second item in the result indicates whether a new key was inserted.
+
+      Both callbacks are called while holding the lock of the shard, so
+      create_key() is called at most once for equal objects, even if several
+      threads look for them at the same time.
+    */
+    template<typename Predicate, typename CreateKey>
+    std::pair<KeyType, bool> find_or_insert(
+        HashType hash, const Predicate &matches, const CreateKey &create_key) {
+        Shard &shard = get_shard(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        KeyType key = shard.set.find(hash, matches);
+        if (key >= 0) {
+            return std::make_pair(key, false);
+        }
+        key = create_key();
+        shard.set.insert_with_hash(key, hash);
+        ++num_entries;
+        return std::make_pair(key, true);
+    }
+
+    // Must not be called while other threads modify the set.
+    void print_statistics(utils::LogProxy &log) const {
+        long long num_buckets = 0;
+        int num_resizes = 0;
+        for (const std::unique_ptr<Shard> &shard : shards) {
+            num_buckets += shard->set.get_num_buckets();
+            num_resizes += shard->set.get_num_resizes();
+        }
+        log << "Concurrent int hash set shards: " << NUM_SHARDS << std::endl;
+        log << "Concurrent int hash set load factor: " << size() << "/"
+            << num_buckets << " = "
+            << static_cast<double>(size()) / num_buckets << std::endl;
+        log << "Concurrent int hash set resizes: " << num_resizes << std::endl;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+#define ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+  ConcurrentSegmentedArrayVector is a thread-safe, append-only variant of
+  SegmentedArrayVector (see segmented_vector.h): many threads can append
+  arrays and read previously appended arrays at the same time.
+
+  push_back() reserves an index with an atomic increment and copies the array
+  into its slot without taking a lock. Only allocating a new segment (once per
+  SEGMENT_BYTES) takes a mutex. Segment pointers are stored in a directory that
+  is replaced by a larger copy when it becomes full. Old directories are kept
+  until the vector is destroyed because other threads may still read them.
+
+  Since there is no pop_back(), callers that want to avoid storing duplicates
+  have to check for them before appending (see ConcurrentStateRegistry).
+
+  Note that push_back() does not synchronize the array data with other
+  threads by itself. A thread may only access an array appended by another
+  thread if it learned about the index in a way that synchronizes with the
+  appending thread (e.g., through a mutex or an atomic with release/acquire
+  semantics), which is naturally the case when indices are published through
+  a hash set protected by a mutex.
+*/
+
+/*
+  For documentation on classes relevant to storing and working with registered
+  states see the file state_registry.h.
+*/
+
+namespace segmented_vector {
+template<class Element>
+class ConcurrentSegmentedArrayVector {
+    static const size_t SEGMENT_BYTES = 8192;
+    static const size_t INITIAL_DIRECTORY_SIZE = 16;
+
+    struct Directory {
+        const size_t capacity;
+        std::unique_ptr<std::atomic<Element *>[]> segments;
+
+        explicit Directory(size_t capacity)
+            : capacity(capacity),
+              segments(new std::atomic<Element *>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) {
+                segments[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const size_t elements_per_array;
+    const size_t arrays_per_segment;
+    const size_t elements_per_segment;
+
+    std::atomic<size_t> the_size;
+    std::atomic<Directory *> directory;
+
+    // Protects allocation of segments and directories.
+    std::mutex allocation_mutex;
+    std::vector<std::unique_ptr<Directory>> directories;
+
+    size_t get_segment(size_t index) const {
+        return index / arrays_per_segment;
+    }
+
+    size_t get_offset(size_t index) const {
+        return (index % arrays_per_segment) * elements_per_array;
+    }
+
+    Element *allocate_segment(size_t segment) {
+        std::lock_guard<std::mutex> lock(allocation_mutex);
+        Directory *current = directory.load(std::memory_order_relaxed);
+        if (segment >= current->capacity) {
+            size_t new_capacity = std::max(2 * current->capacity, segment + 1);
+            std::unique_ptr<Directory> new_directory =
+                std::make_unique<Directory>(new_capacity);
+            for (size_t i = 0; i < current->capacity; ++i) {
+                new_directory->segments[i].store(
+                    current->segments[i].load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+            }
+            current = new_directory.get();
+            directories.push_back(std::move(new_directory));
+            directory.store(current, std::memory_order_release);
+        }
+        Element *data = current->segments[segment].load(std::memory_order_relaxed);
+        if (!data) {
+            data = new Element[elements_per_segment];
+            current->segments[segment].store(data, std::memory_order_release);
+        }
+        return data;
+    }
+
+    Element *get_segment_data(size_t segment) const {
+        const Directory *current = directory.load(std::memory_order_acquire);
+        assert(segment < current->capacity);
+        Element *data = current->segments[segment].load(std::memory_order_acquire);
+        assert(data);
+        return data;
+    }
+
+    ConcurrentSegmentedArrayVector(const ConcurrentSegmentedArrayVector &) =
+        delete;
+    ConcurrentSegmentedArrayVector &operator=(
+        const ConcurrentSegmentedArrayVector &) = delete;
+public:
+    explicit ConcurrentSegmentedArrayVector(size_t elements_per_array_)
+        : elements_per_array(
+              (assert(elements_per_array_ > 0), elements_per_array_)),
+          arrays_per_segment(std::max(
+              SEGMENT_BYTES / (elements_per_array * sizeof(Element)),
+              size_t(1))),
+          elements_per_segment(elements_per_array * arrays_per_segment),
+          the_size(0) {
+        directories.push_back(
+            std::make_unique<Directory>(INITIAL_DIRECTORY_SIZE));
+        directory.store(directories.back().get(), std::memory_order_relaxed);
+    }
+
+    ~ConcurrentSegmentedArrayVector() {
+        const Directory *current = directory.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < current->capacity; ++i) {
+            delete[] current->segments[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /*
+      Append a copy of the given array and return its index. Can be called by
+      several threads at the same time.
+    */
+    size_t push_back(const Element *entry) {
+        size_t index = the_size.fetch_add(1, std::memory_order_relaxed);
+        size_t segment = get_segment(index);
+        const Directory *current = directory.load(std::memory_order_acquire);
+        Element *data = nullptr;
+        if (segment < current->capacity) {
+            data = current->segments[segment].load(std::memory_order_acquire);
+        }
+        if (!data) {
+            data = allocate_segment(segment);
+        }
+        std::copy(
+            entry, entry + elements_per_array, data + get_offset(index));
+        return index;
+    }
+
+    const Element *operator[](size_t index) const {
+        assert(index < size());
+        return get_segment_data(get_segment(index)) + get_offset(index);
+    }
+
+    /*
+      Return the number of reserved indices. This includes arrays that are
+      still being copied by other threads.
+    */
+    size_t size() const {
+        return the_size.load(std::memory_order_relaxed);
+    }
+};
+}
+
+#endif
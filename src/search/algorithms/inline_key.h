@@ -0,0 +1,84 @@
+#ifndef ALGORITHMS_INLINE_KEY_H
+#define ALGORITHMS_INLINE_KEY_H
+
+#include "../utils/hash.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/*
+  Tuple of at most MAX_SIZE ints that is stored inline.
+
+  Open lists with several evaluators use it to store the evaluator values of
+  an entry, which avoids allocating a vector<int> for every inserted entry.
+  It supports the subset of the vector interface that the open lists need.
+  Keys are compared lexicographically and hashed like vectors, so replacing
+  vector<int> by InlineKey does not change the behavior of an open list.
+*/
+namespace inline_key {
+class InlineKey {
+public:
+    static const int MAX_SIZE = 4;
+
+private:
+    std::array<int, MAX_SIZE> values;
+    int num_values;
+
+public:
+    InlineKey() : num_values(0) {
+    }
+
+    void push_back(int value) {
+        assert(num_values < MAX_SIZE);
+        values[num_values++] = value;
+    }
+
+    size_t size() const {
+        return num_values;
+    }
+
+    int operator[](size_t index) const {
+        assert(static_cast<int>(index) < num_values);
+        return values[index];
+    }
+
+    const int *begin() const {
+        return values.data();
+    }
+
+    const int *end() const {
+        return values.data() + num_values;
+    }
+
+    bool operator==(const InlineKey &other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator!=(const InlineKey &other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const InlineKey &other) const {
+        return std::lexicographical_compare(
+            begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator>(const InlineKey &other) const {
+        return other < *this;
+    }
+};
+}
+
+namespace utils {
+inline void feed(HashState &hash_state, const inline_key::InlineKey &key) {
+    feed(hash_state, static_cast<uint64_t>(key.size()));
+    for (int value : key) {
+        feed(hash_state, value);
+    }
+}
+}
+
+#endif
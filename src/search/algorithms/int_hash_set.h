@@ -291,6 +291,41 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Like insert(key), but uses the given hash instead of computing it. The
+      hash must be equal to the hash that the hasher computes for the key.
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        return insert(key, hash);
+    }
+
+    /*
+      Return a key with the given hash for which matches(key) is true, or -1
+      if there is no such key. In contrast to insert(), this can be used to
+      look for an object that is not represented by a key (yet).
+    */
+    template<typename Predicate>
+    KeyType find(HashType hash, const Predicate &matches) const {
+        int ideal_index = get_bucket(hash);
+        for (int i = 0; i < MAX_DISTANCE; ++i) {
+            int index = get_bucket(ideal_index + i);
+            const Bucket &bucket = buckets[index];
+            if (bucket.full() && bucket.hash == hash && matches(bucket.key)) {
+                return bucket.key;
+            }
+        }
+        return Bucket::empty_bucket_key;
+    }
+
+    int get_num_buckets() const {
+        return capacity();
+    }
+
+    int get_num_resizes() const {
+        return num_resizes;
+    }
+
     void dump(utils::LogProxy &log) const {
         int num_buckets = capacity();
         log << "[";
@@ -1,6 +1,14 @@
 #include "int_packer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INT_PACKER_USE_AVX2
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -40,15 +48,27 @@ class IntPacker::VariableInfo {
     int shift;
     Bin read_mask;
     Bin clear_mask;
+    // Only used for mixed-radix bins.
+    Bin multiplier;
 public:
     VariableInfo(int range_, int bin_index_, int shift_)
-        : range(range_), bin_index(bin_index_), shift(shift_) {
+        : range(range_), bin_index(bin_index_), shift(shift_), multiplier(0) {
         int bit_size = get_bit_size_for_range(range);
         read_mask = get_bit_mask(shift, shift + bit_size);
         clear_mask = ~read_mask;
     }
 
-    VariableInfo() : bin_index(-1), shift(0), read_mask(0), clear_mask(0) {
+    VariableInfo(int range_, int bin_index_, Bin multiplier_)
+        : range(range_),
+          bin_index(bin_index_),
+          shift(0),
+          read_mask(0),
+          clear_mask(0),
+          multiplier(multiplier_) {
+    }
+
+    VariableInfo()
+        : bin_index(-1), shift(0), read_mask(0), clear_mask(0), multiplier(0) {
         // Default constructor needed for resize() in pack_bins.
     }
 
@@ -64,21 +84,158 @@ public:
         Bin &bin = buffer[bin_index];
         bin = (bin & clear_mask) | (value << shift);
     }
+
+    int get_bin_index() const {
+        return bin_index;
+    }
+
+    int get_shift() const {
+        return shift;
+    }
+
+    Bin get_unshifted_mask() const {
+        return read_mask >> shift;
+    }
+
+    Bin get_multiplier() const {
+        return multiplier;
+    }
+
+    int get_range() const {
+        return range;
+    }
+
+    int get_mixed_radix(const Bin *buffer) const {
+        return (buffer[bin_index] / multiplier) % range;
+    }
+
+    void set_mixed_radix(Bin *buffer, int value) const {
+        assert(value >= 0 && value < range);
+        Bin &bin = buffer[bin_index];
+        Bin old_value = (bin / multiplier) % range;
+        bin = bin - old_value * multiplier + value * multiplier;
+    }
 };
 
-IntPacker::IntPacker(const vector<int> &ranges) : num_bins(0) {
-    pack_bins(ranges);
+#ifdef INT_PACKER_USE_AVX2
+/*
+  Unpack eight variables at a time: gather the bin of each variable, shift it
+  and mask it. The remaining variables are unpacked one by one.
+*/
+__attribute__((target("avx2"))) static void unpack_all_avx2(
+    const IntPacker::Bin *buffer, const int *bin_indices,
+    const IntPacker::Bin *shifts, const IntPacker::Bin *masks, int num_vars,
+    int *values) {
+    const int *bins = reinterpret_cast<const int *>(buffer);
+    int var = 0;
+    for (; var + 8 <= num_vars; var += 8) {
+        __m256i indices = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(bin_indices + var));
+        __m256i shift = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(shifts + var));
+        __m256i mask =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(masks + var));
+        __m256i gathered = _mm256_i32gather_epi32(bins, indices, 4);
+        __m256i result =
+            _mm256_and_si256(_mm256_srlv_epi32(gathered, shift), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(values + var), result);
+    }
+    for (; var < num_vars; ++var) {
+        values[var] = (buffer[bin_indices[var]] >> shifts[var]) & masks[var];
+    }
+}
+#endif
+
+IntPacker::IntPacker(const vector<int> &ranges, bool mixed_radix)
+    : num_bins(0), mixed_radix(mixed_radix), use_avx2(false) {
+    if (mixed_radix) {
+        pack_bins_mixed_radix(ranges);
+    } else {
+        pack_bins(ranges);
+    }
+    init_bulk_access();
+}
+
+void IntPacker::init_bulk_access() {
+    int num_vars = var_infos.size();
+    bin_indices.resize(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        bin_indices[var] = var_infos[var].get_bin_index();
+    }
+    if (mixed_radix) {
+        multipliers.resize(num_vars);
+        var_ranges.resize(num_vars);
+        for (int var = 0; var < num_vars; ++var) {
+            multipliers[var] = var_infos[var].get_multiplier();
+            var_ranges[var] = var_infos[var].get_range();
+        }
+    } else {
+        shifts.resize(num_vars);
+        masks.resize(num_vars);
+        for (int var = 0; var < num_vars; ++var) {
+            shifts[var] = var_infos[var].get_shift();
+            masks[var] = var_infos[var].get_unshifted_mask();
+        }
+#ifdef INT_PACKER_USE_AVX2
+        use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+    }
 }
 
 IntPacker::~IntPacker() {
 }
 
 int IntPacker::get(const Bin *buffer, int var) const {
+    if (mixed_radix) {
+        return var_infos[var].get_mixed_radix(buffer);
+    }
     return var_infos[var].get(buffer);
 }
 
 void IntPacker::set(Bin *buffer, int var, int value) const {
-    var_infos[var].set(buffer, value);
+    if (mixed_radix) {
+        var_infos[var].set_mixed_radix(buffer, value);
+    } else {
+        var_infos[var].set(buffer, value);
+    }
+}
+
+void IntPacker::unpack_all(const Bin *buffer, int *values) const {
+    int num_vars = bin_indices.size();
+    if (mixed_radix) {
+        for (int var = 0; var < num_vars; ++var) {
+            values[var] =
+                (buffer[bin_indices[var]] / multipliers[var]) % var_ranges[var];
+        }
+        return;
+    }
+#ifdef INT_PACKER_USE_AVX2
+    if (use_avx2) {
+        unpack_all_avx2(
+            buffer, bin_indices.data(), shifts.data(), masks.data(), num_vars,
+            values);
+        return;
+    }
+#endif
+    for (int var = 0; var < num_vars; ++var) {
+        values[var] = (buffer[bin_indices[var]] >> shifts[var]) & masks[var];
+    }
+}
+
+void IntPacker::pack_all(const int *values, Bin *buffer) const {
+    fill_n(buffer, num_bins, 0);
+    int num_vars = bin_indices.size();
+    if (mixed_radix) {
+        for (int var = 0; var < num_vars; ++var) {
+            assert(values[var] >= 0 && values[var] < var_infos[var].get_range());
+            buffer[bin_indices[var]] += values[var] * multipliers[var];
+        }
+    } else {
+        for (int var = 0; var < num_vars; ++var) {
+            assert(values[var] >= 0 && values[var] < var_infos[var].get_range());
+            buffer[bin_indices[var]] |= Bin(values[var]) << shifts[var];
+        }
+    }
 }
 
 void IntPacker::pack_bins(const vector<int> &ranges) {
@@ -138,4 +295,45 @@ int IntPacker::pack_one_bin(
         ++num_vars_in_bin;
     }
 }
+
+void IntPacker::pack_bins_mixed_radix(const vector<int> &ranges) {
+    assert(var_infos.empty());
+
+    int num_vars = ranges.size();
+    var_infos.resize(num_vars);
+
+    /*
+      First-fit decreasing: consider the variables by decreasing range and add
+      each variable to the first bin in which the product of the ranges still
+      fits. Ties are broken in favor of low variable indices.
+    */
+    vector<int> vars(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        vars[var] = var;
+    }
+    stable_sort(vars.begin(), vars.end(), [&ranges](int var1, int var2) {
+        return ranges[var1] > ranges[var2];
+    });
+
+    const uint64_t max_product =
+        static_cast<uint64_t>(numeric_limits<Bin>::max()) + 1;
+    // Product of the ranges of all variables in each bin.
+    vector<uint64_t> bin_products;
+    for (int var : vars) {
+        uint64_t range = ranges[var];
+        int bin_index = 0;
+        while (bin_index < num_bins &&
+               (bin_products[bin_index] == max_product ||
+                bin_products[bin_index] * range > max_product)) {
+            ++bin_index;
+        }
+        if (bin_index == num_bins) {
+            bin_products.push_back(1);
+            ++num_bins;
+        }
+        Bin multiplier = static_cast<Bin>(bin_products[bin_index]);
+        var_infos[var] = VariableInfo(ranges[var], bin_index, multiplier);
+        bin_products[bin_index] *= range;
+    }
+}
 }
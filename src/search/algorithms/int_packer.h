@@ -1,6 +1,7 @@
 #ifndef ALGORITHMS_INT_PACKER_H
 #define ALGORITHMS_INT_PACKER_H
 
+#include <cassert>
 #include <vector>
 
 /*
@@ -16,6 +17,16 @@
   Uses a greedy bin-packing strategy to pack the variables, which
   should be close to optimal in most cases. (See code comments for
   details.)
+
+  Alternatively, the variables in each bin can be encoded as a single
+  mixed-radix number, i.e., a bin holding variables v_1, ..., v_k with
+  ranges r_1, ..., r_k stores sum_i v_i * (r_1 * ... * r_{i-1}). This
+  only requires that the product of the ranges of the variables in a
+  bin fits into a bin, so it avoids the bits wasted by rounding each
+  range up to a power of 2. For example, 20 variables with range 3
+  fit into a single 4-byte bin instead of two. The price is that
+  reading and writing a variable needs a division instead of shifting
+  and masking.
 */
 namespace int_packer {
 class IntPacker {
@@ -23,29 +34,88 @@ class IntPacker {
 
     std::vector<VariableInfo> var_infos;
     int num_bins;
+    bool mixed_radix;
 
     int pack_one_bin(
         const std::vector<int> &ranges,
         std::vector<std::vector<int>> &bits_to_vars);
     void pack_bins(const std::vector<int> &ranges);
+    void pack_bins_mixed_radix(const std::vector<int> &ranges);
 public:
     typedef unsigned int Bin;
 
+private:
+    /*
+      For unpack_all() and pack_all(), we store the layout of all variables in
+      flat arrays indexed by variable: the bin of each variable and either its
+      shift and (unshifted) mask or, for mixed-radix bins, its multiplier and
+      range.
+    */
+    std::vector<int> bin_indices;
+    std::vector<Bin> shifts;
+    std::vector<Bin> masks;
+    std::vector<Bin> multipliers;
+    std::vector<Bin> var_ranges;
+    bool use_avx2;
+
+    void init_bulk_access();
+
+public:
     /*
       The constructor takes the range for each variable. The domain of
       variable i is {0, ..., ranges[i] - 1}. Because we are using signed
       ints for the ranges (and genenerally for the values of variables),
-      a variable can take up at most 31 bits if int is 32-bit.
+      a variable can take up at most 31 bits if int is 32-bit. If
+      mixed_radix is true, we use mixed-radix bins (see above).
     */
-    explicit IntPacker(const std::vector<int> &ranges);
+    explicit IntPacker(
+        const std::vector<int> &ranges, bool mixed_radix = false);
     ~IntPacker();
 
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Write the values of all variables to values, which must have room for
+      one int per variable. This is much faster than calling get() for every
+      variable. On x86 CPUs supporting AVX2, we unpack 8 variables at a time.
+    */
+    void unpack_all(const Bin *buffer, int *values) const;
+
+    /*
+      Pack the given values of all variables into buffer. All bins of the
+      buffer are overwritten, so it does not need to be initialized.
+    */
+    void pack_all(const int *values, Bin *buffer) const;
+
+    /*
+      Without mixed-radix bins, setting var to value only changes the bits
+      get_write_mask(var) of bin get_bin_index(var), which are set to
+      get_shifted_value(var, value). This allows combining the changes of
+      several variables into one operation per bin.
+    */
+    int get_bin_index(int var) const {
+        return bin_indices[var];
+    }
+
+    Bin get_write_mask(int var) const {
+        assert(!mixed_radix);
+        return masks[var] << shifts[var];
+    }
+
+    Bin get_shifted_value(int var, int value) const {
+        assert(!mixed_radix);
+        assert(value >= 0 && static_cast<Bin>(value) <= masks[var]);
+        return static_cast<Bin>(value) << shifts[var];
+    }
+
     int get_num_bins() const {
         return num_bins;
     }
+
+    bool uses_mixed_radix() const {
+        return mixed_radix;
+    }
 };
 }
 
@@ -0,0 +1,89 @@
+#ifndef ALGORITHMS_MPSC_QUEUE_H
+#define ALGORITHMS_MPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+/*
+  MPSCQueue is an unbounded lock-free queue for many producer threads and a
+  single consumer thread.
+
+  Producers push elements onto an intrusive linked stack with a single
+  compare-and-swap. The consumer never removes individual elements but takes
+  the whole stack at once with pop_all(), which swaps the head with nullptr and
+  then restores FIFO order of the taken elements. Since only the consumer ever
+  detaches nodes and it never dereferences the head before detaching it, the
+  queue does not suffer from the ABA problem.
+
+  The queue is meant for passing batches of messages between threads (e.g.,
+  in hash-distributed search), so pushing a single element is expected to be
+  much rarer than operating on the element itself.
+*/
+namespace mpsc_queue {
+template<typename T>
+class MPSCQueue {
+    struct Node {
+        T value;
+        Node *next;
+
+        explicit Node(T &&value) : value(std::move(value)), next(nullptr) {
+        }
+    };
+
+    std::atomic<Node *> head;
+
+public:
+    MPSCQueue() : head(nullptr) {
+    }
+
+    ~MPSCQueue() {
+        Node *node = head.load(std::memory_order_acquire);
+        while (node) {
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    // Can be called by any thread.
+    void push(T &&value) {
+        Node *node = new Node(std::move(value));
+        Node *old_head = head.load(std::memory_order_relaxed);
+        do {
+            node->next = old_head;
+        } while (!head.compare_exchange_weak(
+            old_head, node, std::memory_order_release,
+            std::memory_order_relaxed));
+    }
+
+    /*
+      Move all elements into result (in the order in which they were pushed)
+      and return the number of moved elements. Must only be called by the
+      consumer thread.
+    */
+    int pop_all(std::vector<T> &result) {
+        Node *node = head.exchange(nullptr, std::memory_order_acquire);
+        size_t old_size = result.size();
+        while (node) {
+            result.push_back(std::move(node->value));
+            Node *next = node->next;
+            delete node;
+            node = next;
+        }
+        std::reverse(result.begin() + old_size, result.end());
+        return result.size() - old_size;
+    }
+
+    // Only a snapshot: other threads can push elements at any time.
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+};
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef ALGORITHMS_SEGMENTED_VECTOR_H
 #define ALGORITHMS_SEGMENTED_VECTOR_H
 
+#include "../utils/mapped_memory.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -35,6 +37,10 @@
   storing many fixed-size arrays. It's essentially a variant of SegmentedVector
   where the size of the stored data is only known at runtime, not at compile
   time. Note that we do not support 0-length arrays (checked with an assertion).
+
+  By default, both classes allocate their segments with utils::MappedAllocator,
+  which keeps them in memory-mapped files if this was enabled on the command
+  line (see utils/mapped_memory.h) and on the heap otherwise.
 */
 
 /*
@@ -49,7 +55,7 @@
 */
 
 namespace segmented_vector {
-template<class Entry, class Allocator = std::allocator<Entry>>
+template<class Entry, class Allocator = utils::MappedAllocator<Entry>>
 class SegmentedVector {
     using EntryAllocator =
         typename std::allocator_traits<Allocator>::template rebind_alloc<Entry>;
@@ -151,7 +157,7 @@ public:
     }
 };
 
-template<class Element, class Allocator = std::allocator<Element>>
+template<class Element, class Allocator = utils::MappedAllocator<Element>>
 class SegmentedArrayVector {
     using ElementAllocator = typename std::allocator_traits<
         Allocator>::template rebind_alloc<Element>;
@@ -57,6 +57,10 @@ int AdditiveCartesianHeuristic::compute_heuristic(const State &ancestor_state) {
     return sum_h;
 }
 
+bool AdditiveCartesianHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class AdditiveCartesianHeuristicFeature
     : public plugins::TypedFeature<Evaluator, AdditiveCartesianHeuristic> {
 public:
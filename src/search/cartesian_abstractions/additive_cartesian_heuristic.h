@@ -27,6 +27,7 @@ public:
         bool use_general_costs, int random_seed,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -27,6 +27,14 @@ option USE_LP to false."
             "not supported when an LP solver is used. See issue982 for details.")
     endif()
 
+    option(
+        USE_PROFILER
+        "Measure the time spent in the components of the planner, such as \
+successor generation, state registration, pruning, open lists and each \
+evaluator, and print it at exit. The measurements slow down the search \
+slightly, so the profiler should not be used for experiments."
+        FALSE)
+
     option(
         DISABLE_LIBRARIES_BY_DEFAULT
         "If set to YES only libraries that are specifically enabled will be compiled"
@@ -1,18 +1,25 @@
 #include "command_line.h"
 
+#include "evaluation_context.h"
 #include "git_revision.h"
 #include "plan_manager.h"
 #include "search_algorithm.h"
+#include "state_registry.h"
 
 #include "parser/lexical_analyzer.h"
 #include "parser/syntax_analyzer.h"
 #include "plugins/any.h"
 #include "plugins/doc_printer.h"
 #include "plugins/plugin.h"
+#include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/mapped_memory.h"
+#include "utils/memory.h"
 #include "utils/strings.h"
+#include "utils/telemetry.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <vector>
 
@@ -34,6 +41,16 @@ static int parse_int_arg(const string &name, const string &value) {
     }
 }
 
+static double parse_double_arg(const string &name, const string &value) {
+    try {
+        return stod(value);
+    } catch (invalid_argument &) {
+        input_error("argument for " + name + " must be a number");
+    } catch (out_of_range &) {
+        input_error("argument for " + name + " is out of range");
+    }
+}
+
 static vector<string> replace_old_style_predefinitions(
     const vector<string> &args) {
     vector<string> new_args;
@@ -89,6 +106,24 @@ static shared_ptr<SearchAlgorithm> parse_cmd_line_aux(
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
+    int state_memory_budget = -1;
+    string state_memory_directory;
+    int memory_budget = -1;
+    int num_evaluation_threads = 1;
+    string telemetry_filename;
+    double telemetry_interval = 1.0;
+
+    /*
+      Constructing the search algorithm creates the state packer and the state
+      registry, so we need to know how to pack and register states before
+      parsing the search algorithm.
+    */
+    if (find(args.begin(), args.end(), "--compress-states") != args.end()) {
+        task_properties::g_compress_states = true;
+    }
+    if (find(args.begin(), args.end(), "--hash-compaction") != args.end()) {
+        g_hash_compaction = true;
+    }
 
     using SearchPtr = shared_ptr<SearchAlgorithm>;
     SearchPtr search_algorithm = nullptr;
@@ -160,11 +195,72 @@ static shared_ptr<SearchAlgorithm> parse_cmd_line_aux(
             if (num_previously_generated_plans < 0)
                 input_error(
                     "argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--compress-states" || arg == "--hash-compaction") {
+            // Handled before parsing the search algorithm.
+        } else if (arg == "--state-memory-budget") {
+            if (is_last)
+                input_error("missing argument after --state-memory-budget");
+            ++i;
+            state_memory_budget = parse_int_arg(arg, args[i]);
+            if (state_memory_budget < 0)
+                input_error(
+                    "argument for --state-memory-budget must be non-negative");
+        } else if (arg == "--state-memory-directory") {
+            if (is_last)
+                input_error("missing argument after --state-memory-directory");
+            ++i;
+            state_memory_directory = args[i];
+        } else if (arg == "--memory-budget") {
+            if (is_last)
+                input_error("missing argument after --memory-budget");
+            ++i;
+            memory_budget = parse_int_arg(arg, args[i]);
+            if (memory_budget <= 0)
+                input_error("argument for --memory-budget must be positive");
+        } else if (arg == "--evaluation-threads") {
+            if (is_last)
+                input_error("missing argument after --evaluation-threads");
+            ++i;
+            num_evaluation_threads = parse_int_arg(arg, args[i]);
+            if (num_evaluation_threads < 1)
+                input_error(
+                    "argument for --evaluation-threads must be positive");
+        } else if (arg == "--telemetry") {
+            if (is_last)
+                input_error("missing argument after --telemetry");
+            ++i;
+            telemetry_filename = args[i];
+        } else if (arg == "--telemetry-interval") {
+            if (is_last)
+                input_error("missing argument after --telemetry-interval");
+            ++i;
+            telemetry_interval = parse_double_arg(arg, args[i]);
+            if (!(telemetry_interval > 0))
+                input_error(
+                    "argument for --telemetry-interval must be positive");
         } else {
             input_error("unknown option " + arg);
         }
     }
 
+    if (state_memory_budget >= 0) {
+        if (state_memory_directory.empty()) {
+            const char *tmpdir = getenv("TMPDIR");
+            state_memory_directory = tmpdir ? tmpdir : "/tmp";
+        }
+        utils::enable_mapped_memory(
+            state_memory_budget, state_memory_directory);
+    } else if (!state_memory_directory.empty()) {
+        input_error("--state-memory-directory requires --state-memory-budget");
+    }
+    if (memory_budget > 0) {
+        utils::set_memory_budget(memory_budget);
+    }
+    set_num_evaluation_threads(num_evaluation_threads);
+    if (!telemetry_filename.empty()) {
+        utils::enable_telemetry(telemetry_filename, telemetry_interval);
+    }
+
     if (search_algorithm) {
         PlanManager &plan_manager = search_algorithm->get_plan_manager();
         plan_manager.set_plan_filename(plan_filename);
@@ -218,5 +314,46 @@ string get_usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--compress-states\n"
+           "    Pack states into mixed-radix bins instead of bit fields. This\n"
+           "    reduces the memory per state for variables whose domain size is\n"
+           "    not a power of 2, but makes accessing state values slower.\n"
+           "--hash-compaction\n"
+           "    Detect duplicate states by 64-bit fingerprints and let the search\n"
+           "    drop the data of states it no longer needs (e.g., closed states\n"
+           "    in eager search without reopening). Saves memory, but states with\n"
+           "    equal fingerprints are treated as duplicates, which is very\n"
+           "    unlikely but can lead to incompleteness or invalid plans.\n"
+           "--state-memory-budget MB\n"
+           "    Store per-state data (e.g., registered states and search nodes)\n"
+           "    in memory-mapped files and keep at most about MB megabytes of it\n"
+           "    in RAM. The mapped files count towards the address space, so the\n"
+           "    memory limit of the planner has to be set high enough.\n"
+           "--state-memory-directory DIRECTORY\n"
+           "    Directory for the files used by --state-memory-budget\n"
+           "    (default: $TMPDIR or /tmp). Should be on a local disk.\n"
+           "--memory-budget MB\n"
+           "    Degrade gracefully when the resident memory of the planner\n"
+           "    approaches MB megabytes: drop heuristic caches at 80%, compact\n"
+           "    open lists at 90% and stop the search at 100% of the budget, which\n"
+           "    lets memory_fallback() continue with a low-memory search algorithm.\n"
+           "    Should be somewhat below the memory limit of the planner.\n"
+           "--evaluation-threads N\n"
+           "    Evaluate the independent evaluators of a state concurrently on N\n"
+           "    threads, i.e., the components of sum and max evaluators and the\n"
+           "    evaluators of alternation open lists. Only heuristics that are\n"
+           "    declared thread-safe are evaluated concurrently. Unlike sequential\n"
+           "    evaluation, this does not skip the remaining components once one\n"
+           "    of them reports a dead end. (default: 1)\n"
+           "--telemetry FILENAME\n"
+           "    Write search progress to FILENAME (e.g., a named pipe) as one JSON\n"
+           "    object per line: expansion and evaluation rates, open list size,\n"
+           "    f-layer, state registry size, bytes per state, time per evaluator\n"
+           "    and memory usage. The lines are written by a background thread.\n"
+           "    Searches that run in worker threads (hdastar, eager_greedy and\n"
+           "    lazy_greedy with threads > 1) only write the final line, and\n"
+           "    their evaluator times omit the evaluations of the workers.\n"
+           "--telemetry-interval SECONDS\n"
+           "    Time between two telemetry lines. (default: 1)\n\n"
            "See https://www.fast-downward.org for details.";
 }
@@ -0,0 +1,99 @@
+#include "concurrent_state_registry.h"
+
+#include "task_utils/task_properties.h"
+#include "utils/logging.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ConcurrentStateRegistry::ConcurrentStateRegistry(
+    const TaskProxy &task_proxy, int num_extra_bins)
+    : task_proxy(task_proxy),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      axiom_evaluator(g_axiom_evaluators[task_proxy]),
+      has_axioms(task_properties::has_axioms(task_proxy)),
+      num_variables(task_proxy.get_variables().size()),
+      num_bins(state_packer.get_num_bins()),
+      num_extra_bins(num_extra_bins),
+      state_data_pool(num_bins + num_extra_bins),
+      registered_states(
+          StateIDSemanticHash(state_data_pool, num_bins),
+          StateIDSemanticEqual(state_data_pool, num_bins)) {
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::insert_state(
+    const PackedStateBin *buffer) {
+    int_hash_set::HashType hash =
+        StateIDSemanticHash::get_hash(buffer, num_bins);
+    pair<int, bool> result = registered_states.find_or_insert(
+        hash,
+        [&](int id) {
+            const PackedStateBin *data = state_data_pool[id];
+            return equal(data, data + num_bins, buffer);
+        },
+        [&]() {
+            return static_cast<int>(state_data_pool.push_back(buffer));
+        });
+    return make_pair(StateID(result.first), result.second);
+}
+
+StateID ConcurrentStateRegistry::get_initial_state_id(
+    const PackedStateBin *extra_data) {
+    vector<PackedStateBin> buffer(num_bins + num_extra_bins);
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    state_packer.pack_all(
+        initial_state.get_unpacked_values().data(), buffer.data());
+    if (extra_data) {
+        copy(extra_data, extra_data + num_extra_bins, buffer.begin() + num_bins);
+    }
+    return insert_state(buffer.data()).first;
+}
+
+pair<StateID, bool> ConcurrentStateRegistry::insert_successor_state(
+    const State &predecessor, const OperatorProxy &op,
+    const PackedStateBin *extra_data) {
+    assert(!op.is_axiom());
+    predecessor.unpack();
+    vector<int> new_values = predecessor.get_unpacked_values();
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, predecessor)) {
+            FactPair effect_pair = effect.get_fact().get_pair();
+            new_values[effect_pair.var] = effect_pair.value;
+        }
+    }
+    if (has_axioms) {
+        lock_guard<mutex> lock(axiom_mutex);
+        axiom_evaluator.evaluate(new_values);
+    }
+    vector<PackedStateBin> buffer(num_bins + num_extra_bins);
+    state_packer.pack_all(new_values.data(), buffer.data());
+    if (extra_data) {
+        copy(extra_data, extra_data + num_extra_bins, buffer.begin() + num_bins);
+    }
+    return insert_state(buffer.data());
+}
+
+State ConcurrentStateRegistry::lookup_state(StateID id) const {
+    const PackedStateBin *buffer = lookup_buffer(id);
+    vector<int> values(num_variables);
+    state_packer.unpack_all(buffer, values.data());
+    return task_proxy.create_state(move(values));
+}
+
+int ConcurrentStateRegistry::get_state_size_in_bytes() const {
+    return num_bins * sizeof(PackedStateBin);
+}
+
+void ConcurrentStateRegistry::print_statistics(utils::LogProxy &log) const {
+    log << "Number of registered states: " << size() << endl;
+    log << "Bytes per registered state: " << get_state_size_in_bytes()
+        << " (state data)";
+    if (num_extra_bins > 0) {
+        log << " + " << num_extra_bins * sizeof(PackedStateBin)
+            << " (extra data)";
+    }
+    log << endl;
+    registered_states.print_statistics(log);
+}
@@ -0,0 +1,179 @@
+#ifndef CONCURRENT_STATE_REGISTRY_H
+#define CONCURRENT_STATE_REGISTRY_H
+
+#include "state_id.h"
+#include "state_registry.h"
+#include "task_proxy.h"
+
+#include "algorithms/concurrent_int_hash_set.h"
+#include "algorithms/concurrent_segmented_vector.h"
+#include "utils/hash.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*
+  Thread-safe variant of StateRegistry: any number of threads can register
+  states and look up registered states at the same time.
+
+  The packed state data is stored in a ConcurrentSegmentedArrayVector and the
+  IDs are stored in a ConcurrentIntHashSet. In contrast to StateRegistry, we
+  check for duplicates before storing the data of a new state because the
+  data pool does not support removing states.
+
+  States returned by lookup_state() are unregistered states holding the
+  unpacked values, since the PerStateInformation classes cannot be used
+  from several threads. Callers have to keep track of the IDs themselves.
+
+  For tasks with axioms, computing successor states is serialized by a lock
+  because the axiom evaluator is shared by all users of the task.
+
+  Optionally, every registered state carries a fixed number of extra bins
+  that are stored after its packed data (e.g., the parent of a search node).
+  They are copied along with the state data when the state is registered and
+  never change afterwards, so every thread that learned the ID of a state
+  can read them without further synchronization. The extra bins are ignored
+  for detecting duplicates.
+*/
+class ConcurrentStateRegistry {
+    struct StateIDSemanticHash {
+        const segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>
+            &state_data_pool;
+        int state_size;
+        StateIDSemanticHash(
+            const segmented_vector::ConcurrentSegmentedArrayVector<
+                PackedStateBin> &state_data_pool,
+            int state_size)
+            : state_data_pool(state_data_pool), state_size(state_size) {
+        }
+
+        int_hash_set::HashType operator()(int id) const {
+            return get_hash(state_data_pool[id], state_size);
+        }
+
+        static int_hash_set::HashType get_hash(
+            const PackedStateBin *data, int state_size) {
+            utils::HashState hash_state;
+            for (int i = 0; i < state_size; ++i) {
+                hash_state.feed(data[i]);
+            }
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct StateIDSemanticEqual {
+        const segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>
+            &state_data_pool;
+        int state_size;
+        StateIDSemanticEqual(
+            const segmented_vector::ConcurrentSegmentedArrayVector<
+                PackedStateBin> &state_data_pool,
+            int state_size)
+            : state_data_pool(state_data_pool), state_size(state_size) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = state_data_pool[lhs];
+            const PackedStateBin *rhs_data = state_data_pool[rhs];
+            return std::equal(lhs_data, lhs_data + state_size, rhs_data);
+        }
+    };
+
+    using StateIDSet = int_hash_set::ConcurrentIntHashSet<
+        StateIDSemanticHash, StateIDSemanticEqual>;
+
+    TaskProxy task_proxy;
+    const int_packer::IntPacker &state_packer;
+    AxiomEvaluator &axiom_evaluator;
+    const bool has_axioms;
+    const int num_variables;
+    const int num_bins;
+    const int num_extra_bins;
+
+    segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>
+        state_data_pool;
+    StateIDSet registered_states;
+    std::mutex axiom_mutex;
+
+public:
+    explicit ConcurrentStateRegistry(
+        const TaskProxy &task_proxy, int num_extra_bins = 0);
+
+    const TaskProxy &get_task_proxy() const {
+        return task_proxy;
+    }
+
+    const int_packer::IntPacker &get_state_packer() const {
+        return state_packer;
+    }
+
+    /*
+      Register the state with the given packed data if this was not done
+      before and return its ID. The second item of the result is true iff the
+      state was not registered before. The buffer is copied. It has to hold
+      the packed state data followed by the extra bins.
+    */
+    std::pair<StateID, bool> insert_state(const PackedStateBin *buffer);
+
+    /*
+      Register the initial state (if necessary) and return its ID. If given,
+      extra_data holds the extra bins of the state. Otherwise, they are 0.
+    */
+    StateID get_initial_state_id(const PackedStateBin *extra_data = nullptr);
+
+    /*
+      Register the state that results from applying op to predecessor (if
+      necessary). The result is as for insert_state(). The predecessor can be
+      registered in any registry for the same task or be unregistered. The
+      extra bins are set as for get_initial_state_id().
+    */
+    std::pair<StateID, bool> insert_successor_state(
+        const State &predecessor, const OperatorProxy &op,
+        const PackedStateBin *extra_data = nullptr);
+
+    /*
+      Return an unregistered state with the unpacked values of the state with
+      the given ID. The ID must have been returned by this registry.
+    */
+    State lookup_state(StateID id) const;
+
+    const PackedStateBin *lookup_buffer(StateID id) const {
+        return state_data_pool[id.value];
+    }
+
+    const PackedStateBin *lookup_extra_data(StateID id) const {
+        return state_data_pool[id.value] + num_bins;
+    }
+
+    int get_num_extra_bins() const {
+        return num_extra_bins;
+    }
+
+    /*
+      Convert state IDs to extra bins and back, e.g., to store the parent of
+      a state as extra data.
+    */
+    static PackedStateBin state_id_to_bin(StateID id) {
+        return static_cast<PackedStateBin>(id.value);
+    }
+
+    static StateID bin_to_state_id(PackedStateBin bin) {
+        return StateID(static_cast<int>(bin));
+    }
+
+    /*
+      Return the number of states registered so far. While other threads
+      register states, this is only a snapshot.
+    */
+    size_t size() const {
+        return registered_states.size();
+    }
+
+    int get_state_size_in_bytes() const;
+
+    // Must not be called while other threads register states.
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+#endif
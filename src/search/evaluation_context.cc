@@ -4,10 +4,53 @@
 #include "evaluator.h"
 #include "search_statistics.h"
 
+#include "utils/profiler.h"
+#include "utils/telemetry.h"
+#include "utils/thread_pool.h"
+
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <functional>
+#include <memory>
 
 using namespace std;
 
+static unique_ptr<utils::ThreadPool> evaluation_thread_pool;
+
+static double get_seconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start)
+        .count();
+}
+
+/*
+  Call compute, attributing its time to the evaluator in the profiler and
+  measuring it for the evaluator if telemetry is enabled and we run on the
+  telemetry thread.
+*/
+template<typename Computation>
+static void compute_with_telemetry(
+    Evaluator *evaluator, const Computation &compute) {
+    PROFILE_SCOPE(evaluator->get_profiler_component());
+    if (utils::is_telemetry_enabled() && utils::is_telemetry_thread()) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        compute();
+        utils::add_telemetry_time(
+            evaluator->get_telemetry_timer(), get_seconds_since(start));
+    } else {
+        compute();
+    }
+}
+
+void set_num_evaluation_threads(int num_threads) {
+    assert(num_threads >= 1);
+    if (num_threads == 1) {
+        evaluation_thread_pool = nullptr;
+    } else {
+        evaluation_thread_pool = make_unique<utils::ThreadPool>(num_threads);
+    }
+}
+
 EvaluationContext::EvaluationContext(
     const EvaluatorCache &cache, const State &state, int g_value,
     bool is_preferred, SearchStatistics *statistics, bool calculate_preferred)
@@ -42,18 +85,111 @@ EvaluationContext::EvaluationContext(
           calculate_preferred) {
 }
 
+void EvaluationContext::count_evaluation(
+    Evaluator *evaluator, const EvaluationResult &result) {
+    if (statistics && evaluator->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+}
+
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
-        if (statistics && evaluator->is_used_for_counting_evaluations() &&
-            result.get_count_evaluation()) {
-            statistics->inc_evaluations();
-        }
+        compute_with_telemetry(evaluator, [&]() {
+            result = evaluator->compute_result(*this);
+        });
+        count_evaluation(evaluator, result);
     }
     return result;
 }
 
+void EvaluationContext::evaluate_batch(
+    Evaluator *evaluator, span<EvaluationContext *const> eval_contexts) {
+    vector<EvaluationContext *> uncached_contexts;
+    uncached_contexts.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts) {
+        if (eval_context->cache[evaluator].is_uninitialized()) {
+            uncached_contexts.push_back(eval_context);
+        }
+    }
+    if (uncached_contexts.empty()) {
+        return;
+    }
+    vector<EvaluationResult> results;
+    compute_with_telemetry(evaluator, [&]() {
+        evaluator->compute_results(uncached_contexts, results);
+    });
+    assert(results.size() == uncached_contexts.size());
+    for (size_t i = 0; i < uncached_contexts.size(); ++i) {
+        EvaluationContext &eval_context = *uncached_contexts[i];
+        EvaluationResult &result = eval_context.cache[evaluator];
+        assert(result.is_uninitialized());
+        result = move(results[i]);
+        eval_context.count_evaluation(evaluator, result);
+    }
+}
+
+void EvaluationContext::evaluate_concurrently(
+    const vector<Evaluator *> &evaluators) {
+    if (!evaluation_thread_pool) {
+        return;
+    }
+    vector<Evaluator *> uncached_evaluators;
+    for (Evaluator *evaluator : evaluators) {
+        if (evaluator->is_thread_safe() &&
+            cache[evaluator].is_uninitialized() &&
+            find(uncached_evaluators.begin(), uncached_evaluators.end(),
+                 evaluator) == uncached_evaluators.end()) {
+            uncached_evaluators.push_back(evaluator);
+        }
+    }
+    if (uncached_evaluators.size() <= 1) {
+        return;
+    }
+    // Unpacking modifies the state, so we must not do it concurrently.
+    state.unpack();
+    int num_evaluators = uncached_evaluators.size();
+    vector<EvaluationResult> results(num_evaluators);
+    /*
+      Telemetry timers only measure time on the telemetry thread, so we add
+      the times measured by the workers after they have finished.
+    */
+    bool measure_times =
+        utils::is_telemetry_enabled() && utils::is_telemetry_thread();
+    vector<double> seconds(num_evaluators, 0);
+    vector<function<void()>> tasks;
+    tasks.reserve(num_evaluators);
+    for (int i = 0; i < num_evaluators; ++i) {
+        tasks.emplace_back(
+            [this, &uncached_evaluators, &results, &seconds, measure_times,
+             i]() {
+                chrono::steady_clock::time_point start;
+                if (measure_times) {
+                    start = chrono::steady_clock::now();
+                }
+                Evaluator *evaluator = uncached_evaluators[i];
+                PROFILE_SCOPE(evaluator->get_profiler_component());
+                results[i] = evaluator->compute_result(*this);
+                if (measure_times) {
+                    seconds[i] = get_seconds_since(start);
+                }
+            });
+    }
+    evaluation_thread_pool->run(tasks);
+    for (int i = 0; i < num_evaluators; ++i) {
+        Evaluator *evaluator = uncached_evaluators[i];
+        if (measure_times) {
+            utils::add_telemetry_time(
+                evaluator->get_telemetry_timer(), seconds[i]);
+        }
+        EvaluationResult &result = cache[evaluator];
+        assert(result.is_uninitialized());
+        result = move(results[i]);
+        count_evaluation(evaluator, result);
+    }
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
@@ -6,7 +6,9 @@
 #include "operator_id.h"
 #include "task_proxy.h"
 
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 class Evaluator;
 class SearchStatistics;
@@ -50,6 +52,8 @@ class EvaluationContext {
 
     static const int INVALID = -1;
 
+    void count_evaluation(Evaluator *eval, const EvaluationResult &result);
+
     EvaluationContext(
         const EvaluatorCache &cache, const State &state, int g_value,
         bool is_preferred, SearchStatistics *statistics,
@@ -88,6 +92,23 @@ public:
         bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+
+    /*
+      Compute the results of eval for all given contexts that do not have
+      a cached result for it yet, using a single call of
+      Evaluator::compute_results, and cache them in the contexts.
+      Afterwards, get_result(eval) is a cache lookup for all contexts.
+    */
+    static void evaluate_batch(
+        Evaluator *eval, std::span<EvaluationContext *const> eval_contexts);
+    /*
+      If parallel evaluation is enabled (see set_num_evaluation_threads),
+      compute the results of all given thread-safe evaluators (see
+      Evaluator::is_thread_safe) that do not have a cached result yet
+      concurrently and cache them. All other evaluators are computed
+      lazily by get_result() as usual.
+    */
+    void evaluate_concurrently(const std::vector<Evaluator *> &evals);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
     int get_g_value() const;
@@ -111,4 +132,11 @@ public:
     bool get_calculate_preferred() const;
 };
 
+/*
+  Let EvaluationContext::evaluate_concurrently() use a thread pool with the
+  given number of threads. With a single thread (the default), all
+  evaluators are computed sequentially.
+*/
+extern void set_num_evaluation_threads(int num_threads);
+
 #endif
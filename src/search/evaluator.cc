@@ -2,12 +2,47 @@
 
 #include "plugins/plugin.h"
 #include "utils/logging.h"
+#include "utils/profiler.h"
 #include "utils/system.h"
+#include "utils/telemetry.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <mutex>
 
 using namespace std;
 
+/*
+  We hand out the smallest free slot, so the slots stay dense even if
+  evaluators are created and destroyed repeatedly (e.g., in iterated search).
+  Evaluators are usually created on the main thread, but the lock keeps the
+  allocation safe in any case.
+*/
+static mutex slot_mutex;
+static vector<bool> slot_is_used;
+// Size of slot_is_used, which can be read without locking.
+static atomic<int> num_slots(0);
+
+static int allocate_slot() {
+    lock_guard<mutex> lock(slot_mutex);
+    auto it = find(slot_is_used.begin(), slot_is_used.end(), false);
+    int slot = it - slot_is_used.begin();
+    if (it == slot_is_used.end()) {
+        slot_is_used.push_back(true);
+        num_slots = slot_is_used.size();
+    } else {
+        *it = true;
+    }
+    return slot;
+}
+
+static void release_slot(int slot) {
+    lock_guard<mutex> lock(slot_mutex);
+    assert(slot_is_used[slot]);
+    slot_is_used[slot] = false;
+}
+
 Evaluator::Evaluator(
     bool use_for_reporting_minima, bool use_for_boosting,
     bool use_for_counting_evaluations, const string &description,
@@ -16,13 +51,43 @@ Evaluator::Evaluator(
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations),
+      slot(allocate_slot()),
+      telemetry_timer(utils::get_telemetry_timer(description)),
+      profiler_component(utils::register_profiler_component(description)),
       log(utils::get_log_for_verbosity(verbosity)) {
 }
 
+Evaluator::~Evaluator() {
+    release_slot(slot);
+}
+
+int Evaluator::get_num_slots() {
+    return num_slots.load(memory_order_relaxed);
+}
+
+void Evaluator::compute_results(
+    span<EvaluationContext *const> eval_contexts,
+    vector<EvaluationResult> &results) {
+    results.clear();
+    results.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts) {
+        results.push_back(compute_result(*eval_context));
+    }
+}
+
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+bool Evaluator::is_thread_safe() const {
+    return false;
+}
+
+bool Evaluator::compute_successor_values(
+    const State &, const vector<OperatorID> &, vector<int> &) {
+    return false;
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result) const {
     if (log.is_at_least_normal()) {
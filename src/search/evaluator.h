@@ -6,6 +6,8 @@
 #include "utils/logging.h"
 
 #include <set>
+#include <span>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -19,6 +21,13 @@ class Evaluator {
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+    /*
+      Existing evaluators have distinct slots in the range
+      [0, get_num_slots()). Slots of destroyed evaluators are reused.
+    */
+    const int slot;
+    const int telemetry_timer;
+    const int profiler_component;
 protected:
     mutable utils::LogProxy log;
 public:
@@ -26,7 +35,10 @@ public:
         bool use_for_reporting_minima, bool use_for_boosting,
         bool use_for_counting_evaluations, const std::string &description,
         utils::Verbosity verbosity);
-    virtual ~Evaluator() = default;
+    virtual ~Evaluator();
+
+    Evaluator(const Evaluator &) = delete;
+    Evaluator &operator=(const Evaluator &) = delete;
 
     /*
       dead_ends_are_reliable should return true if the evaluator is
@@ -80,15 +92,97 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_results is the batch counterpart of compute_result: it
+      computes the results for several evaluation contexts at once (e.g.,
+      for all new successors of an expanded state) and stores them in
+      results in the same order. Evaluators can override it to amortize
+      setup costs over the states or to vectorize the computation.
+
+      The default implementation calls compute_result for each context.
+      Like compute_result, this method should only be called by
+      EvaluationContext (see EvaluationContext::evaluate_batch).
+    */
+    virtual void compute_results(
+        std::span<EvaluationContext *const> eval_contexts,
+        std::vector<EvaluationResult> &results);
+
+    /*
+      is_thread_safe should return true if compute_result may run
+      concurrently with the compute_result calls of other evaluators for
+      the same evaluation context (see
+      EvaluationContext::evaluate_concurrently). This requires that
+      compute_result only reads the state and the flags of the
+      evaluation context, i.e., it does not query other evaluators
+      through the context, and that it does not modify data shared with
+      other evaluators. Evaluators are never evaluated concurrently with
+      themselves.
+
+      The default implementation returns false.
+    */
+    virtual bool is_thread_safe() const;
+
+    /*
+      compute_successor_values should compute the estimates for the
+      successors of the given state that are reached by the given operators
+      (of the root task) without generating the successor states, store them
+      in values in the same order (EvaluationResult::INFTY for dead ends) and
+      return true. The operators must be applicable in the state. Evaluators
+      whose estimates only change by the effects of an operator (e.g., PDBs)
+      can compute them much faster than by evaluating the successors.
+      Enhanced partial expansion A* uses this to generate only the successors
+      it stores.
+
+      The default implementation returns false, which means that the
+      evaluator does not support this.
+    */
+    virtual bool compute_successor_values(
+        const State &state, const std::vector<OperatorID> &operators,
+        std::vector<int> &values);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
+    /*
+      The slot of an evaluator is a small index that EvaluatorCache uses to
+      store the results of the evaluator in an array.
+    */
+    int get_slot() const {
+        return slot;
+    }
+    static int get_num_slots();
+
+    /*
+      The telemetry timer of an evaluator accumulates the time for computing
+      its results while telemetry is enabled (see utils/telemetry.h). The
+      time includes the time for computing the results of its
+      subevaluators. Evaluators with the same description share a timer.
+    */
+    int get_telemetry_timer() const {
+        return telemetry_timer;
+    }
+
+    /*
+      Component of the evaluator in the profiler (see utils/profiler.h).
+      Evaluators with the same description share a component.
+    */
+    int get_profiler_component() const {
+        return profiler_component;
+    }
+
     const std::string &get_description() const;
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
 
     virtual bool does_cache_estimates() const;
+    /*
+      Called by search algorithms that rely on the cached estimates, e.g.,
+      for the lazy re-evaluation of states. Evaluators must then keep their
+      cache even under memory pressure.
+    */
+    virtual void keep_cached_estimates() {
+    }
     virtual bool is_estimate_cached(const State &state) const;
     /*
       Calling get_cached_estimate is only allowed if an estimate for
@@ -2,28 +2,45 @@
 #define EVALUATOR_CACHE_H
 
 #include "evaluation_result.h"
+#include "evaluator.h"
 
-#include <unordered_map>
-
-class Evaluator;
-
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
+#include <cassert>
+#include <vector>
 
 /*
   Store evaluation results for evaluators.
+
+  Results are stored in an array indexed by the slots of the evaluators
+  (see Evaluator::get_slot). The array covers all slots that exist when the
+  first result is stored, so a cache usually needs a single allocation and
+  lookups do not need to hash the evaluator.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+    struct Entry {
+        Evaluator *eval = nullptr;
+        EvaluationResult result;
+    };
+
+    std::vector<Entry> entries;
 
 public:
-    EvaluationResult &operator[](Evaluator *eval);
+    EvaluationResult &operator[](Evaluator *eval) {
+        int slot = eval->get_slot();
+        if (slot >= static_cast<int>(entries.size())) {
+            entries.resize(Evaluator::get_num_slots());
+            assert(slot < static_cast<int>(entries.size()));
+        }
+        Entry &entry = entries[slot];
+        entry.eval = eval;
+        return entry.result;
+    }
 
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
-            const Evaluator *eval = element.first;
-            const EvaluationResult &result = element.second;
-            callback(eval, result);
+        for (const Entry &entry : entries) {
+            if (entry.eval) {
+                callback(entry.eval, entry.result);
+            }
         }
     }
 };
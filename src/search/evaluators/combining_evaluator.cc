@@ -16,9 +16,11 @@ CombiningEvaluator::CombiningEvaluator(
       subevaluators(evals) {
     utils::verify_list_not_empty(evals, "evals");
     all_dead_ends_are_reliable = true;
-    for (const shared_ptr<Evaluator> &subevaluator : subevaluators)
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators) {
+        subevaluator_ptrs.push_back(subevaluator.get());
         if (!subevaluator->dead_ends_are_reliable())
             all_dead_ends_are_reliable = false;
+    }
 }
 
 bool CombiningEvaluator::dead_ends_are_reliable() const {
@@ -32,6 +34,13 @@ EvaluationResult CombiningEvaluator::compute_result(
     vector<int> values;
     values.reserve(subevaluators.size());
 
+    /*
+      With parallel evaluation, this computes all thread-safe subevaluators
+      at once. In contrast to the sequential loop below, we then also
+      compute the values of subevaluators after an infinite one.
+    */
+    eval_context.evaluate_concurrently(subevaluator_ptrs);
+
     // Collect component values. Return infinity if any is infinite.
     for (const shared_ptr<Evaluator> &subevaluator : subevaluators) {
         int value =
@@ -49,6 +58,32 @@ EvaluationResult CombiningEvaluator::compute_result(
     return result;
 }
 
+void CombiningEvaluator::compute_results(
+    span<EvaluationContext *const> eval_contexts,
+    vector<EvaluationResult> &results) {
+    /*
+      Evaluate each subevaluator in a batch. Like compute_result, we skip the
+      remaining subevaluators for states that are already known to have an
+      infinite value. Then compute_result only combines cached values. With
+      parallel evaluation, the thread-safe subevaluators are computed
+      concurrently for each state first, so the batches only contain the
+      remaining subevaluators.
+    */
+    for (EvaluationContext *eval_context : eval_contexts) {
+        eval_context->evaluate_concurrently(subevaluator_ptrs);
+    }
+    vector<EvaluationContext *> finite_contexts(
+        eval_contexts.begin(), eval_contexts.end());
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators) {
+        EvaluationContext::evaluate_batch(subevaluator.get(), finite_contexts);
+        erase_if(finite_contexts, [&](EvaluationContext *eval_context) {
+            return eval_context->is_evaluator_value_infinite(
+                subevaluator.get());
+        });
+    }
+    Evaluator::compute_results(eval_contexts, results);
+}
+
 void CombiningEvaluator::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (auto &subevaluator : subevaluators)
@@ -15,6 +15,8 @@ namespace combining_evaluator {
 */
 class CombiningEvaluator : public Evaluator {
     std::vector<std::shared_ptr<Evaluator>> subevaluators;
+    // Raw pointers to the subevaluators for evaluating them concurrently.
+    std::vector<Evaluator *> subevaluator_ptrs;
     bool all_dead_ends_are_reliable;
 protected:
     virtual int combine_values(const std::vector<int> &values) = 0;
@@ -39,6 +41,9 @@ public:
     virtual bool dead_ends_are_reliable() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        std::span<EvaluationContext *const> eval_contexts,
+        std::vector<EvaluationResult> &results) override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
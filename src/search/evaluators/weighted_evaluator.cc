@@ -36,6 +36,13 @@ EvaluationResult WeightedEvaluator::compute_result(
     return result;
 }
 
+void WeightedEvaluator::compute_results(
+    span<EvaluationContext *const> eval_contexts,
+    vector<EvaluationResult> &results) {
+    EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts);
+    Evaluator::compute_results(eval_contexts, results);
+}
+
 void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
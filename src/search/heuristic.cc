@@ -7,6 +7,7 @@
 #include "task_utils/task_properties.h"
 #include "tasks/cost_adapted_task.h"
 #include "tasks/root_task.h"
+#include "utils/memory.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -22,6 +23,14 @@ Heuristic::Heuristic(
       cache_evaluator_values(cache_estimates),
       task(transform),
       task_proxy(*task) {
+    if (cache_evaluator_values) {
+        drop_cache_hook = make_unique<utils::MemoryPressureHook>(
+            utils::MemoryPressureStage::DROP_CACHES,
+            "drop heuristic cache of " + get_description(), [this]() {
+                cache_evaluator_values = false;
+                heuristic_cache.clear();
+            });
+    }
 }
 
 Heuristic::~Heuristic() {
@@ -67,13 +76,13 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_evaluator_values &&
+    if (!calculate_preferred && uses_cache_for(state) &&
         heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
         heuristic = heuristic_cache[state].h;
         result.set_count_evaluation(false);
     } else {
         heuristic = compute_heuristic(state);
-        if (cache_evaluator_values) {
+        if (uses_cache_for(state)) {
             heuristic_cache[state] = HEntry(heuristic, false);
         }
         result.set_count_evaluation(true);
@@ -110,10 +119,73 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristics(
+    span<const State> ancestor_states, vector<int> &values) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        values.push_back(compute_heuristic(ancestor_state));
+    }
+}
+
+void Heuristic::compute_results(
+    span<EvaluationContext *const> eval_contexts,
+    vector<EvaluationResult> &results) {
+    for (EvaluationContext *eval_context : eval_contexts) {
+        if (eval_context->get_calculate_preferred()) {
+            // Preferred operators are computed state by state.
+            Evaluator::compute_results(eval_contexts, results);
+            return;
+        }
+    }
+
+    results.assign(eval_contexts.size(), EvaluationResult());
+    vector<State> uncached_states;
+    vector<int> uncached_indices;
+    for (size_t i = 0; i < eval_contexts.size(); ++i) {
+        const State &state = eval_contexts[i]->get_state();
+        if (uses_cache_for(state) && heuristic_cache[state].h != NO_VALUE &&
+            !heuristic_cache[state].dirty) {
+            results[i].set_evaluator_value(heuristic_cache[state].h);
+            results[i].set_count_evaluation(false);
+        } else {
+            uncached_states.push_back(state);
+            uncached_indices.push_back(i);
+        }
+    }
+
+    vector<int> values;
+    compute_heuristics(uncached_states, values);
+    assert(values.size() == uncached_states.size());
+    for (size_t j = 0; j < uncached_states.size(); ++j) {
+        int heuristic = values[j];
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (uses_cache_for(uncached_states[j])) {
+            heuristic_cache[uncached_states[j]] = HEntry(heuristic, false);
+        }
+        EvaluationResult &result = results[uncached_indices[j]];
+        result.set_evaluator_value(
+            heuristic == DEAD_END ? EvaluationResult::INFTY : heuristic);
+        result.set_count_evaluation(true);
+    }
+
+    // Heuristics may mark preferred operators even if nobody asks for them.
+    preferred_operators.clear();
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
 
+void Heuristic::keep_cached_estimates() {
+    if (drop_cache_hook) {
+        log << "Keeping the heuristic cache of " << get_description()
+            << " under memory pressure because it is used for lazy "
+            << "re-evaluation." << endl;
+        drop_cache_hook = nullptr;
+    }
+}
+
 bool Heuristic::is_estimate_cached(const State &state) const {
     return heuristic_cache[state].h != NO_VALUE;
 }
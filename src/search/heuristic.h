@@ -18,6 +18,10 @@ class Feature;
 class Options;
 }
 
+namespace utils {
+class MemoryPressureHook;
+}
+
 class Heuristic : public Evaluator {
     struct HEntry {
         /* dirty is conceptually a bool, but Visual C++ does not support
@@ -43,6 +47,12 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+    /*
+      Stops caching and frees the cache when memory runs low, unless the
+      cache is needed (see keep_cached_estimates()).
+    */
+    std::unique_ptr<utils::MemoryPressureHook> drop_cache_hook;
+
 protected:
     /*
       Cache for saving h values
@@ -64,8 +74,23 @@ protected:
         NO_VALUE = -2
     };
 
+    /*
+      Heuristics that override is_thread_safe() to return true declare that
+      compute_heuristic only modifies data owned by the heuristic object.
+      compute_result itself is safe in this case.
+    */
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Batch counterpart of compute_heuristic, which is used when evaluating
+      several states at once without computing preferred operators. It
+      stores the heuristic value of ancestor_states[i] in values[i].
+      Heuristics can override it to share work between the states. The
+      default implementation calls compute_heuristic for each state.
+    */
+    virtual void compute_heuristics(
+        std::span<const State> ancestor_states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -75,6 +100,14 @@ protected:
 
     State convert_ancestor_state(const State &ancestor_state) const;
 
+    /*
+      Only registered states have per-state information, so we never cache
+      the estimates of unregistered states (e.g., in idastar()).
+    */
+    bool uses_cache_for(const State &state) const {
+        return cache_evaluator_values && state.get_registry();
+    }
+
 public:
     Heuristic(
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
@@ -87,8 +120,12 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        std::span<EvaluationContext *const> eval_contexts,
+        std::vector<EvaluationResult> &results) override;
 
     virtual bool does_cache_estimates() const override;
+    virtual void keep_cached_estimates() override;
     virtual bool is_estimate_cached(const State &state) const override;
     virtual int get_cached_estimate(const State &state) const override;
 };
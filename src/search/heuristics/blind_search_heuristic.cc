@@ -29,6 +29,10 @@ int BlindSearchHeuristic::compute_heuristic(const State &ancestor_state) {
         return min_operator_cost;
 }
 
+bool BlindSearchHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class BlindSearchHeuristicFeature
     : public plugins::TypedFeature<Evaluator, BlindSearchHeuristic> {
 public:
@@ -449,6 +449,10 @@ bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
     return false;
 }
 
+bool ContextEnhancedAdditiveHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class ContextEnhancedAdditiveHeuristicFeature
     : public plugins::TypedFeature<
           Evaluator, ContextEnhancedAdditiveHeuristic> {
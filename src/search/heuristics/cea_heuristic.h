@@ -59,6 +59,7 @@ public:
         const std::string &description, utils::Verbosity verbosity);
     ~ContextEnhancedAdditiveHeuristic();
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -50,6 +50,10 @@ bool CGHeuristic::dead_ends_are_reliable() const {
     return false;
 }
 
+bool CGHeuristic::is_thread_safe() const {
+    return true;
+}
+
 int CGHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     setup_domain_transition_graphs();
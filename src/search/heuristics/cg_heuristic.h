@@ -48,6 +48,7 @@ public:
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -29,6 +29,10 @@ int GoalCountHeuristic::compute_heuristic(const State &ancestor_state) {
     return unsatisfied_goal_count;
 }
 
+bool GoalCountHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class GoalCountHeuristicFeature
     : public plugins::TypedFeature<Evaluator, GoalCountHeuristic> {
 public:
@@ -11,6 +11,7 @@ public:
     GoalCountHeuristic(
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -31,6 +31,10 @@ bool HMHeuristic::dead_ends_are_reliable() const {
     return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
 }
 
+bool HMHeuristic::is_thread_safe() const {
+    return true;
+}
+
 int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     if (task_properties::is_goal_state(task_proxy, state)) {
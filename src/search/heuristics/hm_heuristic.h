@@ -68,6 +68,7 @@ public:
         utils::Verbosity verbosity);
 
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool is_thread_safe() const override;
 };
 }
 
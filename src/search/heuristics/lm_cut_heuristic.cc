@@ -35,6 +35,10 @@ int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     return total_cost;
 }
 
+bool LandmarkCutHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class LandmarkCutHeuristicFeature
     : public plugins::TypedFeature<Evaluator, LandmarkCutHeuristic> {
 public:
@@ -20,6 +20,7 @@ public:
     LandmarkCutHeuristic(
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -114,6 +114,10 @@ bool RelaxationHeuristic::dead_ends_are_reliable() const {
     return !task_properties::has_axioms(task_proxy);
 }
 
+bool RelaxationHeuristic::is_thread_safe() const {
+    return true;
+}
+
 PropID RelaxationHeuristic::get_prop_id(int var, int value) const {
     return proposition_offsets[var] + value;
 }
@@ -117,6 +117,7 @@ public:
         const std::string &description, utils::Verbosity verbosity);
 
     virtual bool dead_ends_are_reliable() const override;
+    virtual bool is_thread_safe() const override;
 };
 
 extern void add_relaxation_heuristic_options_to_feature(
@@ -137,6 +137,10 @@ int MergeAndShrinkHeuristic::compute_heuristic(const State &ancestor_state) {
     return heuristic;
 }
 
+bool MergeAndShrinkHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class MergeAndShrinkHeuristicFeature
     : public plugins::TypedFeature<Evaluator, MergeAndShrinkHeuristic> {
 public:
@@ -34,6 +34,7 @@ public:
         double main_loop_max_time,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -4,7 +4,10 @@
 #include "evaluation_context.h"
 #include "operator_id.h"
 
+#include "utils/profiler.h"
+
 #include <set>
+#include <vector>
 
 class StateID;
 
@@ -54,6 +57,9 @@ public:
     // Return true if the open list is empty.
     virtual bool empty() const = 0;
 
+    // Return the number of entries in the open list.
+    virtual int get_num_entries() const = 0;
+
     /*
       Remove all elements from the open list.
 
@@ -80,6 +86,14 @@ public:
     */
     virtual void boost_preferred();
 
+    /*
+      Release memory that the open list does not need for its current
+      entries, such as the unused capacity of its buckets. This is called
+      when the planner runs low on memory (see utils/memory.h). The default
+      implementation does nothing.
+    */
+    virtual void compact();
+
     /*
       Add all path-dependent evaluators that this open lists uses (directly or
       indirectly) into the result set.
@@ -89,6 +103,19 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Append the evaluators that insert() evaluates for entries that are
+      not dead ends to evals, in the order in which they are evaluated.
+      Search algorithms use this to evaluate new states in a batch (see
+      Evaluator::compute_results) before inserting them. Open lists that
+      only contain preferred entries add nothing because they do not
+      evaluate all states.
+
+      The default implementation adds nothing, i.e., the open list
+      evaluates the states one at a time.
+    */
+    virtual void get_evaluators(std::vector<Evaluator *> &evals) const;
+
     /*
       Accessor method for only_preferred.
 
@@ -139,9 +166,18 @@ template<class Entry>
 void OpenList<Entry>::boost_preferred() {
 }
 
+template<class Entry>
+void OpenList<Entry>::compact() {
+}
+
+template<class Entry>
+void OpenList<Entry>::get_evaluators(std::vector<Evaluator *> &) const {
+}
+
 template<class Entry>
 void OpenList<Entry>::insert(
     EvaluationContext &eval_context, const Entry &entry) {
+    PROFILE_SCOPE(utils::ProfilerComponent::OPEN_LIST);
     if (only_preferred && !eval_context.is_preferred())
         return;
     if (!is_dead_end(eval_context))
@@ -6,6 +6,7 @@
 #include "../utils/component_errors.h"
 #include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <vector>
@@ -18,6 +19,8 @@ template<class Entry>
 class AlternationOpenList : public OpenList<Entry> {
     vector<unique_ptr<OpenList<Entry>>> open_lists;
     vector<int> priorities;
+    // The evaluators of all sublists, which we compute concurrently.
+    vector<Evaluator *> evaluators;
 
     const int boost_amount;
 protected:
@@ -30,10 +33,13 @@ public:
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
+    virtual void compact() override;
     virtual void boost_preferred() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
@@ -49,6 +55,8 @@ AlternationOpenList<Entry>::AlternationOpenList(
         open_lists.push_back(factory->create_open_list<Entry>());
 
     priorities.resize(open_lists.size(), 0);
+    for (const auto &sublist : open_lists)
+        sublist->get_evaluators(evaluators);
 }
 
 template<class Entry>
@@ -82,12 +90,30 @@ bool AlternationOpenList<Entry>::empty() const {
     return true;
 }
 
+template<class Entry>
+int AlternationOpenList<Entry>::get_num_entries() const {
+    /*
+      Entries are inserted into all sublists that accept them, but only
+      removed from one of them, so this is only an estimate.
+    */
+    int num_entries = 0;
+    for (const auto &sublist : open_lists)
+        num_entries = max(num_entries, sublist->get_num_entries());
+    return num_entries;
+}
+
 template<class Entry>
 void AlternationOpenList<Entry>::clear() {
     for (const auto &sublist : open_lists)
         sublist->clear();
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::compact() {
+    for (const auto &sublist : open_lists)
+        sublist->compact();
+}
+
 template<class Entry>
 void AlternationOpenList<Entry>::boost_preferred() {
     for (size_t i = 0; i < open_lists.size(); ++i)
@@ -102,6 +128,15 @@ void AlternationOpenList<Entry>::get_path_dependent_evaluators(
         sublist->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    if (this->only_contains_preferred_entries())
+        return;
+    for (const auto &sublist : open_lists)
+        sublist->get_evaluators(evals);
+}
+
 template<class Entry>
 bool AlternationOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -118,6 +153,12 @@ bool AlternationOpenList<Entry>::is_dead_end(
 template<class Entry>
 bool AlternationOpenList<Entry>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
+    /*
+      The sublists evaluate their evaluators one after the other. With
+      parallel evaluation, we compute all of them at once instead. This
+      method is also called first by is_dead_end and thus by insert.
+    */
+    eval_context.evaluate_concurrently(evaluators);
     for (const auto &sublist : open_lists)
         if (sublist->is_reliable_dead_end(eval_context))
             return true;
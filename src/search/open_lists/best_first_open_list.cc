@@ -3,20 +3,19 @@
 #include "../evaluator.h"
 #include "../open_list.h"
 
+#include "../algorithms/bucket_array.h"
 #include "../plugins/plugin.h"
 
 #include <cassert>
-#include <deque>
-#include <map>
 
 using namespace std;
 
 namespace standard_scalar_open_list {
 template<class Entry>
 class BestFirstOpenList : public OpenList<Entry> {
-    typedef deque<Entry> Bucket;
+    using Bucket = bucket_array::FifoBucket<Entry>;
 
-    map<int, Bucket> buckets;
+    bucket_array::BucketArray<Bucket> buckets;
     int size;
 
     shared_ptr<Evaluator> evaluator;
@@ -30,9 +29,12 @@ public:
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
+    virtual void compact() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
@@ -48,21 +50,17 @@ template<class Entry>
 void BestFirstOpenList<Entry>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
     int key = eval_context.get_evaluator_value(evaluator.get());
-    buckets[key].push_back(entry);
+    buckets.get_bucket_for_insertion(key).push(entry);
     ++size;
 }
 
 template<class Entry>
 Entry BestFirstOpenList<Entry>::remove_min() {
     assert(size > 0);
-    auto it = buckets.begin();
-    assert(it != buckets.end());
-    Bucket &bucket = it->second;
+    Bucket &bucket = buckets.get_min_bucket();
     assert(!bucket.empty());
-    Entry result = bucket.front();
-    bucket.pop_front();
-    if (bucket.empty())
-        buckets.erase(it);
+    Entry result = bucket.pop();
+    buckets.pop_min_bucket_if_empty();
     --size;
     return result;
 }
@@ -72,18 +70,35 @@ bool BestFirstOpenList<Entry>::empty() const {
     return size == 0;
 }
 
+template<class Entry>
+int BestFirstOpenList<Entry>::get_num_entries() const {
+    return size;
+}
+
 template<class Entry>
 void BestFirstOpenList<Entry>::clear() {
     buckets.clear();
     size = 0;
 }
 
+template<class Entry>
+void BestFirstOpenList<Entry>::compact() {
+    buckets.compact();
+}
+
 template<class Entry>
 void BestFirstOpenList<Entry>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void BestFirstOpenList<Entry>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    if (!this->only_contains_preferred_entries())
+        evals.push_back(evaluator.get());
+}
+
 template<class Entry>
 bool BestFirstOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -122,11 +137,17 @@ public:
 
         document_note(
             "Implementation notes",
-            "Elements with the same evaluator value are stored in double-ended "
-            "queues, called \"buckets\". The open list stores a map from evaluator "
-            "values to buckets. Pushing and popping from a bucket runs in constant "
-            "time. Therefore, inserting and removing an entry from the open list "
-            "takes time O(log(n)), where n is the number of buckets.");
+            "Elements with the same evaluator value are stored in FIFO queues, "
+            "called \"buckets\". The open list stores an array of buckets "
+            "indexed by evaluator value and remembers the smallest value with a "
+            "non-empty bucket. Pushing and popping from a bucket runs in "
+            "constant time. Therefore, inserting an entry takes constant time "
+            "and removing an entry takes amortized constant time if the "
+            "removed values rarely decrease. The array covers at most 2^16 "
+            "consecutive values (usually starting at 0). Buckets for values "
+            "outside of this range are stored in a map instead, for which "
+            "operations take time O(log(n)), where n is the number of such "
+            "buckets.");
     }
 
     virtual shared_ptr<BestFirstOpenListFactory> create_component(
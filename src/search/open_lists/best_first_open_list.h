@@ -6,7 +6,7 @@
 /*
   Open list indexed by a single int, using FIFO tie-breaking.
 
-  Implemented as a map from int to deques.
+  Implemented as an array of FIFO buckets indexed by int (see BucketArray).
 */
 
 namespace standard_scalar_open_list {
@@ -54,8 +54,11 @@ public:
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
+    virtual void compact() override;
 };
 
 template<class HeapNode>
@@ -125,11 +128,23 @@ void EpsilonGreedyOpenList<Entry>::get_path_dependent_evaluators(
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void EpsilonGreedyOpenList<Entry>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    if (!this->only_contains_preferred_entries())
+        evals.push_back(evaluator.get());
+}
+
 template<class Entry>
 bool EpsilonGreedyOpenList<Entry>::empty() const {
     return size == 0;
 }
 
+template<class Entry>
+int EpsilonGreedyOpenList<Entry>::get_num_entries() const {
+    return size;
+}
+
 template<class Entry>
 void EpsilonGreedyOpenList<Entry>::clear() {
     heap.clear();
@@ -137,6 +152,11 @@ void EpsilonGreedyOpenList<Entry>::clear() {
     next_id = 0;
 }
 
+template<class Entry>
+void EpsilonGreedyOpenList<Entry>::compact() {
+    heap.shrink_to_fit();
+}
+
 EpsilonGreedyOpenListFactory::EpsilonGreedyOpenListFactory(
     const shared_ptr<Evaluator> &eval, double epsilon, int random_seed,
     bool pref_only)
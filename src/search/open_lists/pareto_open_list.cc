@@ -3,6 +3,7 @@
 #include "../evaluator.h"
 #include "../open_list.h"
 
+#include "../algorithms/inline_key.h"
 #include "../plugins/plugin.h"
 #include "../utils/hash.h"
 #include "../utils/rng.h"
@@ -18,12 +19,13 @@
 using namespace std;
 
 namespace pareto_open_list {
-template<class Entry>
+template<class Entry, class Key>
 class ParetoOpenList : public OpenList<Entry> {
     shared_ptr<utils::RandomNumberGenerator> rng;
 
     using Bucket = deque<Entry>;
-    using KeyType = vector<int>;
+    // InlineKey for up to InlineKey::MAX_SIZE evaluators, vector<int> otherwise.
+    using KeyType = Key;
     using BucketMap = utils::HashMap<KeyType, Bucket>;
     using KeySet = set<KeyType>;
 
@@ -48,16 +50,18 @@ public:
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
 };
 
-template<class Entry>
-ParetoOpenList<Entry>::ParetoOpenList(
+template<class Entry, class Key>
+ParetoOpenList<Entry, Key>::ParetoOpenList(
     const vector<shared_ptr<Evaluator>> &evals, bool state_uniform_selection,
     int random_seed, bool pref_only)
     : OpenList<Entry>(pref_only),
@@ -66,8 +70,8 @@ ParetoOpenList<Entry>::ParetoOpenList(
       evaluators(evals) {
 }
 
-template<class Entry>
-bool ParetoOpenList<Entry>::dominates(
+template<class Entry, class Key>
+bool ParetoOpenList<Entry, Key>::dominates(
     const KeyType &v1, const KeyType &v2) const {
     assert(v1.size() == v2.size());
     bool are_different = false;
@@ -80,8 +84,8 @@ bool ParetoOpenList<Entry>::dominates(
     return are_different;
 }
 
-template<class Entry>
-bool ParetoOpenList<Entry>::is_nondominated(
+template<class Entry, class Key>
+bool ParetoOpenList<Entry, Key>::is_nondominated(
     const KeyType &vec, KeySet &domination_candidates) const {
     for (const KeyType &candidate : domination_candidates)
         if (dominates(candidate, vec))
@@ -89,14 +93,14 @@ bool ParetoOpenList<Entry>::is_nondominated(
     return true;
 }
 
-template<class Entry>
-void ParetoOpenList<Entry>::remove_key(const KeyType &key) {
+template<class Entry, class Key>
+void ParetoOpenList<Entry, Key>::remove_key(const KeyType &key) {
     /*
       We must copy the key because it is likely to live inside the
       data structures from which we remove it here and hence becomes
       invalid at that point.
     */
-    vector<int> copied_key(key);
+    KeyType copied_key(key);
     nondominated.erase(copied_key);
     buckets.erase(copied_key);
     KeySet candidates;
@@ -119,11 +123,10 @@ void ParetoOpenList<Entry>::remove_key(const KeyType &key) {
             nondominated.insert(candidate);
 }
 
-template<class Entry>
-void ParetoOpenList<Entry>::do_insertion(
+template<class Entry, class Key>
+void ParetoOpenList<Entry, Key>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
+    KeyType key;
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(
             eval_context.get_evaluator_value_or_infinity(evaluator.get()));
@@ -156,8 +159,8 @@ void ParetoOpenList<Entry>::do_insertion(
     }
 }
 
-template<class Entry>
-Entry ParetoOpenList<Entry>::remove_min() {
+template<class Entry, class Key>
+Entry ParetoOpenList<Entry, Key>::remove_min() {
     typename KeySet::iterator selected = nondominated.begin();
     int seen = 0;
     for (typename KeySet::iterator it = nondominated.begin();
@@ -179,26 +182,43 @@ Entry ParetoOpenList<Entry>::remove_min() {
     return result;
 }
 
-template<class Entry>
-bool ParetoOpenList<Entry>::empty() const {
+template<class Entry, class Key>
+bool ParetoOpenList<Entry, Key>::empty() const {
     return nondominated.empty();
 }
 
-template<class Entry>
-void ParetoOpenList<Entry>::clear() {
+template<class Entry, class Key>
+int ParetoOpenList<Entry, Key>::get_num_entries() const {
+    int num_entries = 0;
+    for (const auto &key_and_bucket : buckets)
+        num_entries += key_and_bucket.second.size();
+    return num_entries;
+}
+
+template<class Entry, class Key>
+void ParetoOpenList<Entry, Key>::clear() {
     buckets.clear();
     nondominated.clear();
 }
 
-template<class Entry>
-void ParetoOpenList<Entry>::get_path_dependent_evaluators(
+template<class Entry, class Key>
+void ParetoOpenList<Entry, Key>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         evaluator->get_path_dependent_evaluators(evals);
 }
 
-template<class Entry>
-bool ParetoOpenList<Entry>::is_dead_end(EvaluationContext &eval_context) const {
+template<class Entry, class Key>
+void ParetoOpenList<Entry, Key>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    if (this->only_contains_preferred_entries())
+        return;
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evals.push_back(evaluator.get());
+}
+
+template<class Entry, class Key>
+bool ParetoOpenList<Entry, Key>::is_dead_end(EvaluationContext &eval_context) const {
     // TODO: Document this behaviour.
     // If one safe heuristic detects a dead end, return true.
     if (is_reliable_dead_end(eval_context))
@@ -210,8 +230,8 @@ bool ParetoOpenList<Entry>::is_dead_end(EvaluationContext &eval_context) const {
     return true;
 }
 
-template<class Entry>
-bool ParetoOpenList<Entry>::is_reliable_dead_end(
+template<class Entry, class Key>
+bool ParetoOpenList<Entry, Key>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
@@ -220,6 +240,18 @@ bool ParetoOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+static unique_ptr<OpenList<Entry>> create_pareto_open_list(
+    const vector<shared_ptr<Evaluator>> &evals, bool state_uniform_selection,
+    int random_seed, bool pref_only) {
+    if (static_cast<int>(evals.size()) <= inline_key::InlineKey::MAX_SIZE) {
+        return make_unique<ParetoOpenList<Entry, inline_key::InlineKey>>(
+            evals, state_uniform_selection, random_seed, pref_only);
+    }
+    return make_unique<ParetoOpenList<Entry, vector<int>>>(
+        evals, state_uniform_selection, random_seed, pref_only);
+}
+
 ParetoOpenListFactory::ParetoOpenListFactory(
     const vector<shared_ptr<Evaluator>> &evals, bool state_uniform_selection,
     int random_seed, bool pref_only)
@@ -230,12 +262,12 @@ ParetoOpenListFactory::ParetoOpenListFactory(
 }
 
 unique_ptr<StateOpenList> ParetoOpenListFactory::create_state_open_list() {
-    return make_unique<ParetoOpenList<StateOpenListEntry>>(
+    return create_pareto_open_list<StateOpenListEntry>(
         evals, state_uniform_selection, random_seed, pref_only);
 }
 
 unique_ptr<EdgeOpenList> ParetoOpenListFactory::create_edge_open_list() {
-    return make_unique<ParetoOpenList<EdgeOpenListEntry>>(
+    return create_pareto_open_list<EdgeOpenListEntry>(
         evals, state_uniform_selection, random_seed, pref_only);
 }
 
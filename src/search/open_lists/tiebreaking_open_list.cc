@@ -3,22 +3,33 @@
 #include "../evaluator.h"
 #include "../open_list.h"
 
+#include "../algorithms/bucket_array.h"
+#include "../algorithms/inline_key.h"
 #include "../plugins/plugin.h"
 
 #include <cassert>
-#include <deque>
-#include <map>
-#include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace tiebreaking_open_list {
-template<class Entry>
+template<class Entry, class Key>
 class TieBreakingOpenList : public OpenList<Entry> {
-    using Bucket = deque<Entry>;
+    using Bucket = bucket_array::FifoBucket<Entry>;
+    using TwoLevelBuckets =
+        bucket_array::BucketArray<bucket_array::BucketArray<Bucket>>;
 
-    map<const vector<int>, Bucket> buckets;
+    /*
+      Key is InlineKey for up to InlineKey::MAX_SIZE evaluators and
+      vector<int> otherwise.
+    */
+    bucket_array::BucketHeap<Key, Bucket> buckets;
+    /*
+      With two evaluators (e.g., f and h in A*), we store the entries in
+      nested bucket arrays instead, which avoids hashing the keys and is
+      even faster.
+    */
+    TwoLevelBuckets two_level_buckets;
     int size;
 
     vector<shared_ptr<Evaluator>> evaluators;
@@ -42,16 +53,19 @@ public:
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
+    virtual void compact() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
 };
 
-template<class Entry>
-TieBreakingOpenList<Entry>::TieBreakingOpenList(
+template<class Entry, class Key>
+TieBreakingOpenList<Entry, Key>::TieBreakingOpenList(
     const vector<shared_ptr<Evaluator>> &evals, bool unsafe_pruning,
     bool pref_only)
     : OpenList<Entry>(pref_only),
@@ -60,59 +74,94 @@ TieBreakingOpenList<Entry>::TieBreakingOpenList(
       allow_unsafe_pruning(unsafe_pruning) {
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::do_insertion(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
+    if (dimension() == 2) {
+        int key1 = eval_context.get_evaluator_value_or_infinity(
+            evaluators[0].get());
+        int key2 = eval_context.get_evaluator_value_or_infinity(
+            evaluators[1].get());
+        two_level_buckets.get_bucket_for_insertion(key1)
+            .get_bucket_for_insertion(key2).push(entry);
+        ++size;
+        return;
+    }
+    Key key;
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(
             eval_context.get_evaluator_value_or_infinity(evaluator.get()));
 
-    buckets[key].push_back(entry);
+    buckets.get_bucket_for_insertion(key).push(entry);
     ++size;
 }
 
-template<class Entry>
-Entry TieBreakingOpenList<Entry>::remove_min() {
+template<class Entry, class Key>
+Entry TieBreakingOpenList<Entry, Key>::remove_min() {
     assert(size > 0);
-    typename map<const vector<int>, Bucket>::iterator it;
-    it = buckets.begin();
-    assert(it != buckets.end());
-    assert(!it->second.empty());
+    if (dimension() == 2) {
+        --size;
+        auto &inner_buckets = two_level_buckets.get_min_bucket();
+        Bucket &bucket = inner_buckets.get_min_bucket();
+        Entry result = bucket.pop();
+        inner_buckets.pop_min_bucket_if_empty();
+        two_level_buckets.pop_min_bucket_if_empty();
+        return result;
+    }
     --size;
-    Entry result = it->second.front();
-    it->second.pop_front();
-    if (it->second.empty())
-        buckets.erase(it);
+    Bucket &bucket = buckets.get_min_bucket();
+    assert(!bucket.empty());
+    Entry result = bucket.pop();
+    buckets.pop_min_bucket_if_empty();
     return result;
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::empty() const {
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::empty() const {
     return size == 0;
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::clear() {
+template<class Entry, class Key>
+int TieBreakingOpenList<Entry, Key>::get_num_entries() const {
+    return size;
+}
+
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::clear() {
     buckets.clear();
+    two_level_buckets.clear();
     size = 0;
 }
 
-template<class Entry>
-int TieBreakingOpenList<Entry>::dimension() const {
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::compact() {
+    buckets.compact();
+    two_level_buckets.compact();
+}
+
+template<class Entry, class Key>
+int TieBreakingOpenList<Entry, Key>::dimension() const {
     return evaluators.size();
 }
 
-template<class Entry>
-void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         evaluator->get_path_dependent_evaluators(evals);
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::is_dead_end(
+template<class Entry, class Key>
+void TieBreakingOpenList<Entry, Key>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    if (this->only_contains_preferred_entries())
+        return;
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evals.push_back(evaluator.get());
+}
+
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::is_dead_end(
     EvaluationContext &eval_context) const {
     // TODO: Properly document this behaviour.
     // If one safe heuristic detects a dead end, return true.
@@ -130,8 +179,8 @@ bool TieBreakingOpenList<Entry>::is_dead_end(
     return true;
 }
 
-template<class Entry>
-bool TieBreakingOpenList<Entry>::is_reliable_dead_end(
+template<class Entry, class Key>
+bool TieBreakingOpenList<Entry, Key>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
@@ -140,6 +189,18 @@ bool TieBreakingOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+static unique_ptr<OpenList<Entry>> create_tiebreaking_open_list(
+    const vector<shared_ptr<Evaluator>> &evals, bool unsafe_pruning,
+    bool pref_only) {
+    if (static_cast<int>(evals.size()) <= inline_key::InlineKey::MAX_SIZE) {
+        return make_unique<TieBreakingOpenList<Entry, inline_key::InlineKey>>(
+            evals, unsafe_pruning, pref_only);
+    }
+    return make_unique<TieBreakingOpenList<Entry, vector<int>>>(
+        evals, unsafe_pruning, pref_only);
+}
+
 TieBreakingOpenListFactory::TieBreakingOpenListFactory(
     const vector<shared_ptr<Evaluator>> &evals, bool unsafe_pruning,
     bool pref_only)
@@ -148,12 +209,12 @@ TieBreakingOpenListFactory::TieBreakingOpenListFactory(
 }
 
 unique_ptr<StateOpenList> TieBreakingOpenListFactory::create_state_open_list() {
-    return make_unique<TieBreakingOpenList<StateOpenListEntry>>(
+    return create_tiebreaking_open_list<StateOpenListEntry>(
         evals, unsafe_pruning, pref_only);
 }
 
 unique_ptr<EdgeOpenList> TieBreakingOpenListFactory::create_edge_open_list() {
-    return make_unique<TieBreakingOpenList<EdgeOpenListEntry>>(
+    return create_tiebreaking_open_list<EdgeOpenListEntry>(
         evals, unsafe_pruning, pref_only);
 }
 
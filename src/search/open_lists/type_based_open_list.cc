@@ -3,6 +3,7 @@
 #include "../evaluator.h"
 #include "../open_list.h"
 
+#include "../algorithms/inline_key.h"
 #include "../plugins/plugin.h"
 #include "../utils/collections.h"
 #include "../utils/hash.h"
@@ -17,12 +18,12 @@
 using namespace std;
 
 namespace type_based_open_list {
-template<class Entry>
+template<class Entry, class Key>
 class TypeBasedOpenList : public OpenList<Entry> {
     vector<shared_ptr<Evaluator>> evaluators;
     shared_ptr<utils::RandomNumberGenerator> rng;
 
-    using Key = vector<int>;
+    // Key is InlineKey for up to InlineKey::MAX_SIZE evaluators.
     using Bucket = vector<Entry>;
     vector<pair<Key, Bucket>> keys_and_buckets;
     utils::HashMap<Key, int> key_to_bucket_index;
@@ -37,19 +38,20 @@ public:
 
     virtual Entry remove_min() override;
     virtual bool empty() const override;
+    virtual int get_num_entries() const override;
     virtual void clear() override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(vector<Evaluator *> &evals) const override;
 };
 
-template<class Entry>
-void TypeBasedOpenList<Entry>::do_insertion(
+template<class Entry, class Key>
+void TypeBasedOpenList<Entry, Key>::do_insertion(
     EvaluationContext &eval_context, const Entry &entry) {
-    vector<int> key;
-    key.reserve(evaluators.size());
+    Key key;
     for (const shared_ptr<Evaluator> &evaluator : evaluators) {
         key.push_back(
             eval_context.get_evaluator_value_or_infinity(evaluator.get()));
@@ -66,14 +68,14 @@ void TypeBasedOpenList<Entry>::do_insertion(
     }
 }
 
-template<class Entry>
-TypeBasedOpenList<Entry>::TypeBasedOpenList(
+template<class Entry, class Key>
+TypeBasedOpenList<Entry, Key>::TypeBasedOpenList(
     const vector<shared_ptr<Evaluator>> &evaluators, int random_seed)
     : evaluators(evaluators), rng(utils::get_rng(random_seed)) {
 }
 
-template<class Entry>
-Entry TypeBasedOpenList<Entry>::remove_min() {
+template<class Entry, class Key>
+Entry TypeBasedOpenList<Entry, Key>::remove_min() {
     size_t bucket_id = rng->random(keys_and_buckets.size());
     auto &key_and_bucket = keys_and_buckets[bucket_id];
     const Key &min_key = key_and_bucket.first;
@@ -90,19 +92,27 @@ Entry TypeBasedOpenList<Entry>::remove_min() {
     return result;
 }
 
-template<class Entry>
-bool TypeBasedOpenList<Entry>::empty() const {
+template<class Entry, class Key>
+bool TypeBasedOpenList<Entry, Key>::empty() const {
     return keys_and_buckets.empty();
 }
 
-template<class Entry>
-void TypeBasedOpenList<Entry>::clear() {
+template<class Entry, class Key>
+int TypeBasedOpenList<Entry, Key>::get_num_entries() const {
+    int num_entries = 0;
+    for (const auto &key_and_bucket : keys_and_buckets)
+        num_entries += key_and_bucket.second.size();
+    return num_entries;
+}
+
+template<class Entry, class Key>
+void TypeBasedOpenList<Entry, Key>::clear() {
     keys_and_buckets.clear();
     key_to_bucket_index.clear();
 }
 
-template<class Entry>
-bool TypeBasedOpenList<Entry>::is_dead_end(
+template<class Entry, class Key>
+bool TypeBasedOpenList<Entry, Key>::is_dead_end(
     EvaluationContext &eval_context) const {
     // If one evaluator is sure we have a dead end, return true.
     if (is_reliable_dead_end(eval_context))
@@ -115,8 +125,8 @@ bool TypeBasedOpenList<Entry>::is_dead_end(
     return true;
 }
 
-template<class Entry>
-bool TypeBasedOpenList<Entry>::is_reliable_dead_end(
+template<class Entry, class Key>
+bool TypeBasedOpenList<Entry, Key>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
     for (const shared_ptr<Evaluator> &evaluator : evaluators) {
         if (evaluator->dead_ends_are_reliable() &&
@@ -126,14 +136,34 @@ bool TypeBasedOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
-template<class Entry>
-void TypeBasedOpenList<Entry>::get_path_dependent_evaluators(
+template<class Entry, class Key>
+void TypeBasedOpenList<Entry, Key>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (const shared_ptr<Evaluator> &evaluator : evaluators) {
         evaluator->get_path_dependent_evaluators(evals);
     }
 }
 
+template<class Entry, class Key>
+void TypeBasedOpenList<Entry, Key>::get_evaluators(
+    vector<Evaluator *> &evals) const {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        evals.push_back(evaluator.get());
+    }
+}
+
+template<class Entry>
+static unique_ptr<OpenList<Entry>> create_type_based_open_list(
+    const vector<shared_ptr<Evaluator>> &evaluators, int random_seed) {
+    if (static_cast<int>(evaluators.size()) <=
+        inline_key::InlineKey::MAX_SIZE) {
+        return make_unique<TypeBasedOpenList<Entry, inline_key::InlineKey>>(
+            evaluators, random_seed);
+    }
+    return make_unique<TypeBasedOpenList<Entry, vector<int>>>(
+        evaluators, random_seed);
+}
+
 TypeBasedOpenListFactory::TypeBasedOpenListFactory(
     const vector<shared_ptr<Evaluator>> &evaluators, int random_seed)
     : evaluators(evaluators), random_seed(random_seed) {
@@ -141,12 +171,12 @@ TypeBasedOpenListFactory::TypeBasedOpenListFactory(
 }
 
 unique_ptr<StateOpenList> TypeBasedOpenListFactory::create_state_open_list() {
-    return make_unique<TypeBasedOpenList<StateOpenListEntry>>(
+    return create_type_based_open_list<StateOpenListEntry>(
         evaluators, random_seed);
 }
 
 unique_ptr<EdgeOpenList> TypeBasedOpenListFactory::create_edge_open_list() {
-    return make_unique<TypeBasedOpenList<EdgeOpenListEntry>>(
+    return create_type_based_open_list<EdgeOpenListEntry>(
         evaluators, random_seed);
 }
 
@@ -45,8 +45,19 @@ plugins::Any LazyValue::construct_any() const {
 
 vector<LazyValue> LazyValue::construct_lazy_list() {
     utils::TraceBlock block(context, "Delayed construction of a list");
+    /*
+      Lists whose type differs from the expected type (e.g., empty lists used
+      as default values) are wrapped in a ConvertNode. In this case, we
+      convert the individual elements instead.
+    */
+    const DecoratedASTNode *list_value = node.get();
+    const ConvertNode *convert_node =
+        dynamic_cast<const ConvertNode *>(list_value);
+    if (convert_node) {
+        list_value = &convert_node->get_value();
+    }
     const DecoratedListNode *list_node =
-        dynamic_cast<const DecoratedListNode *>(node.get());
+        dynamic_cast<const DecoratedListNode *>(list_value);
     if (!list_node) {
         context.error(
             "Delayed construction of a list failed because the parsed element "
@@ -60,7 +71,15 @@ vector<LazyValue> LazyValue::construct_lazy_list() {
         utils::TraceBlock(
             context,
             "Create LazyValue for " + to_string(elem) + ". list element");
-        elements.emplace_back(LazyValue(*element, context));
+        if (convert_node && convert_node->get_from_type().has_nested_type()) {
+            ConvertNode element_convert_node(
+                element->clone(),
+                convert_node->get_from_type().get_nested_type(),
+                convert_node->get_to_type().get_nested_type());
+            elements.emplace_back(LazyValue(element_convert_node, context));
+        } else {
+            elements.emplace_back(LazyValue(*element, context));
+        }
         elem++;
     }
     return elements;
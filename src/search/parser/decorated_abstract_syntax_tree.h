@@ -239,6 +239,18 @@ public:
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
 
+    const DecoratedASTNode &get_value() const {
+        return *value;
+    }
+
+    const plugins::Type &get_from_type() const {
+        return from_type;
+    }
+
+    const plugins::Type &get_to_type() const {
+        return to_type;
+    }
+
     // TODO: once we get rid of lazy construction, this should no longer be
     // necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -76,6 +76,10 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     }
 }
 
+bool CanonicalPDBsHeuristic::is_thread_safe() const {
+    return true;
+}
+
 void add_canonical_pdbs_options_to_feature(plugins::Feature &feature) {
     feature.add_option<double>(
         "max_time_dominance_pruning",
@@ -24,6 +24,7 @@ public:
         double max_time_dominance_pruning,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 
 void add_canonical_pdbs_options_to_feature(plugins::Feature &feature);
@@ -4,6 +4,7 @@
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -59,6 +60,29 @@ int PatternDatabase::get_value(const vector<int> &state) const {
     return distances[projection.rank(state)];
 }
 
+void PatternDatabase::get_successor_values(
+    const State &state, const OperatorsProxy &operators,
+    const vector<OperatorID> &op_ids, vector<int> &values) const {
+    const Pattern &pattern = projection.get_pattern();
+    int state_index = projection.rank(state.get_unpacked_values());
+    values.clear();
+    values.reserve(op_ids.size());
+    for (OperatorID op_id : op_ids) {
+        int index = state_index;
+        for (EffectProxy effect : operators[op_id].get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            auto it = lower_bound(pattern.begin(), pattern.end(), fact.var);
+            if (it != pattern.end() && *it == fact.var &&
+                does_fire(effect, state)) {
+                int pattern_index = it - pattern.begin();
+                index += projection.get_multiplier(pattern_index) *
+                         (fact.value - state[fact.var].get_value());
+            }
+        }
+        values.push_back(distances[index]);
+    }
+}
+
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
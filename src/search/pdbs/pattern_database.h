@@ -49,6 +49,16 @@ class PatternDatabase {
 public:
     PatternDatabase(Projection &&projection, std::vector<int> &&distances);
     int get_value(const std::vector<int> &state) const;
+    /*
+      Compute the values of the successors of the given state that are
+      reached by the given (applicable) operators without computing the
+      successors: only the effects on pattern variables change the rank of
+      the state.
+    */
+    void get_successor_values(
+        const State &state, const OperatorsProxy &operators,
+        const std::vector<OperatorID> &op_ids,
+        std::vector<int> &values) const;
 
     const Pattern &get_pattern() const {
         return projection.get_pattern();
@@ -34,6 +34,28 @@ int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+bool PDBHeuristic::is_thread_safe() const {
+    return true;
+}
+
+/*
+  The task of the heuristic can only transform operator costs, so its
+  operators have the same IDs as the operators of the root task.
+*/
+bool PDBHeuristic::compute_successor_values(
+    const State &ancestor_state, const vector<OperatorID> &operators,
+    vector<int> &values) {
+    State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
+    pdb->get_successor_values(
+        state, task_proxy.get_operators(), operators, values);
+    for (int &value : values) {
+        if (value == numeric_limits<int>::max())
+            value = EvaluationResult::INFTY;
+    }
+    return true;
+}
+
 static basic_string<char> paper_references() {
     return utils::format_conference_reference(
                {"Stefan Edelkamp"}, "Planning with Pattern Databases",
@@ -28,6 +28,10 @@ public:
         const std::shared_ptr<PatternGenerator> &pattern_generator,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
+    virtual bool compute_successor_values(
+        const State &ancestor_state, const std::vector<OperatorID> &operators,
+        std::vector<int> &values) override;
 };
 }
 
@@ -34,6 +34,10 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+bool ZeroOnePDBsHeuristic::is_thread_safe() const {
+    return true;
+}
+
 class ZeroOnePDBsHeuristicFeature
     : public plugins::TypedFeature<Evaluator, ZeroOnePDBsHeuristic> {
 public:
@@ -18,6 +18,7 @@ public:
         const std::shared_ptr<PatternCollectionGenerator> &patterns,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &name, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -155,6 +155,19 @@ public:
         return (*entries)[state_id];
     }
 
+    /*
+      Free the information stored for all states. Afterwards, all states
+      have the default value again.
+    */
+    void clear() {
+        for (auto &[registry, entries] : entries_by_registry) {
+            delete entries;
+            entries = new segmented_vector::SegmentedVector<Entry>();
+        }
+        cached_registry = nullptr;
+        cached_entries = nullptr;
+    }
+
     virtual void notify_service_destroyed(
         const StateRegistry *registry) override {
         delete entries_by_registry[registry];
@@ -5,6 +5,8 @@
 #include "task_utils/task_properties.h"
 #include "tasks/root_task.h"
 #include "utils/logging.h"
+#include "utils/mapped_memory.h"
+#include "utils/profiler.h"
 #include "utils/system.h"
 #include "utils/timer.h"
 
@@ -50,16 +52,21 @@ int main(int argc, const char **argv) {
 
         search_algorithm->save_plan_if_necessary();
         search_algorithm->print_statistics();
+        utils::print_mapped_memory_statistics(utils::g_log);
         utils::g_log << "Search time: " << search_timer << endl;
         utils::g_log << "Total time: " << utils::g_timer << endl;
 
-        ExitCode exitcode = search_algorithm->found_solution()
-                                ? ExitCode::SUCCESS
-                                : ExitCode::SEARCH_UNSOLVED_INCOMPLETE;
+        ExitCode exitcode = ExitCode::SEARCH_UNSOLVED_INCOMPLETE;
+        if (search_algorithm->found_solution()) {
+            exitcode = ExitCode::SUCCESS;
+        } else if (search_algorithm->get_status() == OUT_OF_MEMORY) {
+            exitcode = ExitCode::SEARCH_OUT_OF_MEMORY;
+        }
         exit_with(exitcode);
     } catch (const utils::ExitException &e) {
         /* To ensure that all destructors are called before the program exits,
            we raise an exception in utils::exit_with() and let main() return. */
+        utils::print_profile(utils::g_log);
         return static_cast<int>(e.get_exitcode());
     }
 }
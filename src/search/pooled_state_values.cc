@@ -0,0 +1,98 @@
+#include "pooled_state_values.h"
+
+using namespace std;
+
+/*
+  Released buffers of a thread. We keep at most MAX_SIZE buffers, which
+  bounds the memory held by the free list after a phase in which many states
+  were alive at the same time (e.g., a batch of successors).
+*/
+class PooledStateValues::FreeList {
+    static const int MAX_SIZE = 1024;
+    Buffer *head = nullptr;
+    int size = 0;
+public:
+    /*
+      States can outlive the free list of their thread, e.g., if they are
+      destroyed by destructors of static objects after the thread-local
+      objects of the main thread. Released buffers are then deleted directly.
+    */
+    static thread_local bool destroyed;
+
+    FreeList() = default;
+    FreeList(const FreeList &) = delete;
+    FreeList &operator=(const FreeList &) = delete;
+
+    static FreeList &get_thread_free_list() {
+        static thread_local FreeList free_list;
+        return free_list;
+    }
+
+    ~FreeList() {
+        destroyed = true;
+        while (head) {
+            Buffer *next = head->next_free;
+            delete head;
+            head = next;
+        }
+    }
+
+    Buffer *pop() {
+        Buffer *buffer = head;
+        if (buffer) {
+            head = buffer->next_free;
+            --size;
+        }
+        return buffer;
+    }
+
+    bool push(Buffer *buffer) {
+        if (size == MAX_SIZE) {
+            return false;
+        }
+        buffer->next_free = head;
+        head = buffer;
+        ++size;
+        return true;
+    }
+};
+
+thread_local bool PooledStateValues::FreeList::destroyed = false;
+
+PooledStateValues::Buffer *PooledStateValues::acquire_buffer() {
+    Buffer *buffer = nullptr;
+    if (!FreeList::destroyed) {
+        buffer = FreeList::get_thread_free_list().pop();
+    }
+    if (!buffer) {
+        buffer = new Buffer();
+    }
+    buffer->ref_count.store(1, memory_order_relaxed);
+    buffer->next_free = nullptr;
+    return buffer;
+}
+
+void PooledStateValues::release_buffer(Buffer *buffer) {
+    if (FreeList::destroyed ||
+        !FreeList::get_thread_free_list().push(buffer)) {
+        delete buffer;
+    }
+}
+
+PooledStateValues PooledStateValues::create(size_t num_values) {
+    Buffer *buffer = acquire_buffer();
+    // Resizing within the capacity of the vector does not allocate memory.
+    buffer->values.resize(num_values);
+    return PooledStateValues(buffer);
+}
+
+PooledStateValues PooledStateValues::create(vector<int> &&values) {
+    Buffer *buffer = acquire_buffer();
+    if (buffer->values.capacity() >= values.size()) {
+        buffer->values.assign(values.begin(), values.end());
+    } else {
+        // Adopt the memory of the given vector instead of allocating.
+        buffer->values.swap(values);
+    }
+    return PooledStateValues(buffer);
+}
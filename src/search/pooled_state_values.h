@@ -0,0 +1,116 @@
+#ifndef POOLED_STATE_VALUES_H
+#define POOLED_STATE_VALUES_H
+
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+/*
+  Reference-counted handle to the unpacked values of a state (see State).
+
+  States are unpacked and copied very frequently. With a shared_ptr to a
+  vector, every unpacked state allocated a control block and the vector's
+  data. Instead, the values are stored in buffers that are recycled: when
+  the last handle to a buffer is destroyed, the buffer (including the
+  capacity of its vector) moves to a free list of the current thread, and
+  the next state created by this thread reuses it. Except for a short
+  warm-up phase, creating, copying and destroying handles therefore does
+  not touch the global allocator.
+
+  Since states can be copied in one thread and destroyed in another (e.g.,
+  when evaluating a state concurrently), the reference count is atomic, like
+  the one of shared_ptr. A buffer that is released by another thread than
+  the one that acquired it simply moves to the free list of the releasing
+  thread.
+*/
+class PooledStateValues {
+    struct Buffer {
+        std::vector<int> values;
+        std::atomic<int> ref_count;
+        Buffer *next_free;
+    };
+    class FreeList;
+
+    Buffer *buffer;
+
+    explicit PooledStateValues(Buffer *buffer) : buffer(buffer) {
+    }
+
+    static Buffer *acquire_buffer();
+    static void release_buffer(Buffer *buffer);
+
+    void add_reference() const {
+        if (buffer) {
+            buffer->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void remove_reference() {
+        if (buffer &&
+            buffer->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            release_buffer(buffer);
+        }
+    }
+public:
+    PooledStateValues() : buffer(nullptr) {
+    }
+
+    PooledStateValues(const PooledStateValues &other) : buffer(other.buffer) {
+        add_reference();
+    }
+
+    PooledStateValues(PooledStateValues &&other) noexcept
+        : buffer(other.buffer) {
+        other.buffer = nullptr;
+    }
+
+    ~PooledStateValues() {
+        remove_reference();
+    }
+
+    PooledStateValues &operator=(const PooledStateValues &other) {
+        other.add_reference();
+        remove_reference();
+        buffer = other.buffer;
+        return *this;
+    }
+
+    PooledStateValues &operator=(PooledStateValues &&other) noexcept {
+        if (this != &other) {
+            remove_reference();
+            buffer = other.buffer;
+            other.buffer = nullptr;
+        }
+        return *this;
+    }
+
+    // Create a handle to a buffer with num_values unspecified values.
+    static PooledStateValues create(std::size_t num_values);
+    // Create a handle to a buffer holding the given values.
+    static PooledStateValues create(std::vector<int> &&values);
+
+    explicit operator bool() const {
+        return buffer != nullptr;
+    }
+
+    const std::vector<int> &operator*() const {
+        assert(buffer);
+        return buffer->values;
+    }
+
+    const std::vector<int> *operator->() const {
+        assert(buffer);
+        return &buffer->values;
+    }
+
+    /*
+      Access the values for initializing them. This is only allowed as long
+      as no other handle refers to the same buffer.
+    */
+    std::vector<int> &get_values_for_initialization() {
+        assert(buffer && buffer->ref_count.load() == 1);
+        return buffer->values;
+    }
+};
+
+#endif
@@ -14,6 +14,11 @@ PotentialFunction::PotentialFunction(
     : fact_potentials(fact_potentials) {
 }
 
+static int round_potential(double heuristic_value) {
+    const double epsilon = 0.01;
+    return static_cast<int>(ceil(heuristic_value - epsilon));
+}
+
 int PotentialFunction::get_value(const State &state) const {
     double heuristic_value = 0.0;
     for (FactProxy fact : state) {
@@ -23,7 +28,67 @@ int PotentialFunction::get_value(const State &state) const {
         assert(utils::in_bounds(value, fact_potentials[var_id]));
         heuristic_value += fact_potentials[var_id][value];
     }
-    const double epsilon = 0.01;
-    return static_cast<int>(ceil(heuristic_value - epsilon));
+    return round_potential(heuristic_value);
+}
+
+void PotentialFunction::get_values(
+    span<const State> states, vector<int> &values) const {
+    vector<const int *> state_values;
+    state_values.reserve(states.size());
+    for (const State &state : states) {
+        state_values.push_back(state.get_unpacked_values().data());
+    }
+    /*
+      Sum up the potentials variable by variable, so that the potentials of
+      a variable are loaded once for all states. We add the potentials of
+      each state in the same order as get_value() to get the same result.
+    */
+    vector<double> heuristic_values(states.size(), 0.0);
+    int num_variables = fact_potentials.size();
+    for (int var_id = 0; var_id < num_variables; ++var_id) {
+        const vector<double> &potentials = fact_potentials[var_id];
+        for (size_t i = 0; i < states.size(); ++i) {
+            int value = state_values[i][var_id];
+            assert(utils::in_bounds(value, potentials));
+            heuristic_values[i] += potentials[value];
+        }
+    }
+    values.clear();
+    values.reserve(states.size());
+    for (double heuristic_value : heuristic_values) {
+        values.push_back(round_potential(heuristic_value));
+    }
+}
+
+void PotentialFunction::get_successor_values(
+    const State &state, const OperatorsProxy &operators,
+    const vector<OperatorID> &op_ids, vector<int> &values) const {
+    const vector<int> &state_values = state.get_unpacked_values();
+    /*
+      Adding the potential differences of the effects to the value of the
+      state would be faster, but could round differently than get_value().
+      We therefore sum up the potentials of each successor in the same order
+      as get_value(), which is still much cheaper than generating it.
+    */
+    vector<int> succ_values;
+    values.clear();
+    values.reserve(op_ids.size());
+    for (OperatorID op_id : op_ids) {
+        succ_values = state_values;
+        for (EffectProxy effect : operators[op_id].get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair fact = effect.get_fact().get_pair();
+                succ_values[fact.var] = fact.value;
+            }
+        }
+        double heuristic_value = 0.0;
+        int num_variables = fact_potentials.size();
+        for (int var_id = 0; var_id < num_variables; ++var_id) {
+            assert(utils::in_bounds(
+                succ_values[var_id], fact_potentials[var_id]));
+            heuristic_value += fact_potentials[var_id][succ_values[var_id]];
+        }
+        values.push_back(round_potential(heuristic_value));
+    }
 }
 }
@@ -1,8 +1,11 @@
 #ifndef POTENTIALS_POTENTIAL_FUNCTION_H
 #define POTENTIALS_POTENTIAL_FUNCTION_H
 
+#include <span>
 #include <vector>
 
+class OperatorID;
+class OperatorsProxy;
 class State;
 
 namespace potentials {
@@ -21,6 +24,18 @@ public:
     ~PotentialFunction() = default;
 
     int get_value(const State &state) const;
+    // Compute get_value for several unpacked states at once.
+    void get_values(
+        std::span<const State> states, std::vector<int> &values) const;
+    /*
+      Compute get_value for the successors of the given unpacked state that
+      are reached by the given (applicable) operators without computing the
+      successors.
+    */
+    void get_successor_values(
+        const State &state, const OperatorsProxy &operators,
+        const std::vector<OperatorID> &op_ids,
+        std::vector<int> &values) const;
 };
 }
 
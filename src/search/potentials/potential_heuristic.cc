@@ -19,4 +19,37 @@ int PotentialHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     return max(0, function->get_value(state));
 }
+
+bool PotentialHeuristic::is_thread_safe() const {
+    return true;
+}
+
+void PotentialHeuristic::compute_heuristics(
+    span<const State> ancestor_states, vector<int> &values) {
+    vector<State> states;
+    states.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        State state = convert_ancestor_state(ancestor_state);
+        state.unpack();
+        states.push_back(move(state));
+    }
+    function->get_values(states, values);
+    for (int &value : values) {
+        value = max(0, value);
+    }
+}
+
+// Task transformations keep the operator IDs of the root task.
+bool PotentialHeuristic::compute_successor_values(
+    const State &ancestor_state, const vector<OperatorID> &operators,
+    vector<int> &values) {
+    State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
+    function->get_successor_values(
+        state, task_proxy.get_operators(), operators, values);
+    for (int &value : values) {
+        value = max(0, value);
+    }
+    return true;
+}
 }
@@ -16,12 +16,19 @@ class PotentialHeuristic : public Heuristic {
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        std::span<const State> ancestor_states,
+        std::vector<int> &values) override;
 
 public:
     explicit PotentialHeuristic(
         std::unique_ptr<PotentialFunction> function,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
+    virtual bool compute_successor_values(
+        const State &ancestor_state, const std::vector<OperatorID> &operators,
+        std::vector<int> &values) override;
 };
 }
 
@@ -23,4 +23,8 @@ int PotentialMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     }
     return value;
 }
+
+bool PotentialMaxHeuristic::is_thread_safe() const {
+    return true;
+}
 }
@@ -23,6 +23,7 @@ public:
         std::vector<std::unique_ptr<PotentialFunction>> &&functions,
         const std::shared_ptr<AbstractTask> &transform, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+    virtual bool is_thread_safe() const override;
 };
 }
 
@@ -3,6 +3,7 @@
 #include "plugins/plugin.h"
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/profiler.h"
 
 #include <cassert>
 
@@ -24,6 +25,7 @@ void PruningMethod::initialize(const shared_ptr<AbstractTask> &task_) {
 void PruningMethod::prune_operators(
     const State &state, vector<OperatorID> &op_ids) {
     assert(!task_properties::is_goal_state(TaskProxy(*task), state));
+    PROFILE_SCOPE(utils::ProfilerComponent::PRUNING);
     /*
       We only measure time with verbose verbosity level because time
       measurements induce a significant overhead, up to 30% for configurations
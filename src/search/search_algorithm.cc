@@ -9,8 +9,10 @@
 #include "task_utils/task_properties.h"
 #include "tasks/root_task.h"
 #include "utils/countdown_timer.h"
+#include "utils/memory.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
+#include "utils/telemetry.h"
 #include "utils/timer.h"
 
 #include <cassert>
@@ -38,18 +40,44 @@ static successor_generator::SuccessorGenerator &get_successor_generator(
     return successor_generator;
 }
 
+// State registry of the innermost SharedStateRegistryScope.
+static shared_ptr<StateRegistry> g_scoped_state_registry;
+
+static shared_ptr<StateRegistry> get_state_registry(
+    const TaskProxy &task_proxy) {
+    if (g_scoped_state_registry) {
+        return g_scoped_state_registry;
+    }
+    return make_shared<StateRegistry>(task_proxy);
+}
+
+SharedStateRegistryScope::SharedStateRegistryScope(
+    const shared_ptr<StateRegistry> &registry)
+    : previous_registry(g_scoped_state_registry) {
+    g_scoped_state_registry = registry;
+}
+
+SharedStateRegistryScope::~SharedStateRegistryScope() {
+    g_scoped_state_registry = previous_registry;
+}
+
 SearchAlgorithm::SearchAlgorithm(
     OperatorCost cost_type, int bound, double max_time,
     const string &description, utils::Verbosity verbosity)
     : description(description),
       status(IN_PROGRESS),
       solution_found(false),
+      stop_requested(false),
+      last_telemetry_time(0),
+      last_telemetry_expanded(0),
+      last_telemetry_evaluated(0),
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_for_verbosity(verbosity)),
-      state_registry(task_proxy),
+      shared_state_registry(get_state_registry(task_proxy)),
+      state_registry(*shared_state_registry),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, cost_type, log),
       statistics(log),
       bound(bound),
       cost_type(cost_type),
@@ -69,13 +97,19 @@ SearchAlgorithm::SearchAlgorithm(
     : description(opts.get_unparsed_config()),
       status(IN_PROGRESS),
       solution_found(false),
+      stop_requested(false),
+      last_telemetry_time(0),
+      last_telemetry_expanded(0),
+      last_telemetry_evaluated(0),
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_for_verbosity(
           opts.get<utils::Verbosity>("verbosity"))),
-      state_registry(task_proxy),
+      shared_state_registry(get_state_registry(task_proxy)),
+      state_registry(*shared_state_registry),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(
+          state_registry, opts.get<OperatorCost>("cost_type"), log),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
@@ -110,20 +144,99 @@ void SearchAlgorithm::set_plan(const Plan &p) {
 }
 
 void SearchAlgorithm::search() {
+    utils::MemoryPressureHook stop_hook(
+        utils::MemoryPressureStage::STOP_SEARCH, "stop search " + description,
+        [this]() { stop_requested = true; });
     initialize();
     utils::CountdownTimer timer(max_time);
     while (status == IN_PROGRESS) {
         status = step();
+        if (utils::is_telemetry_enabled() && utils::is_telemetry_due()) {
+            report_telemetry("progress");
+        }
         if (timer.is_expired()) {
             log << "Time limit reached. Abort search." << endl;
             status = TIMEOUT;
             break;
         }
+        utils::poll_memory_budget();
+        if (stop_requested && status == IN_PROGRESS) {
+            log << "Memory budget exhausted. Abort search." << endl;
+            status = OUT_OF_MEMORY;
+            break;
+        }
+    }
+    if (utils::is_telemetry_enabled()) {
+        report_telemetry("finished");
     }
     // TODO: Revise when and which search times are logged.
     log << "Actual search time: " << timer.get_elapsed_time() << endl;
 }
 
+int SearchAlgorithm::get_open_list_size() const {
+    return -1;
+}
+
+static const char *get_status_name(SearchStatus status) {
+    switch (status) {
+    case IN_PROGRESS:
+        return "in_progress";
+    case TIMEOUT:
+        return "timeout";
+    case FAILED:
+        return "failed";
+    case SOLVED:
+        return "solved";
+    case OUT_OF_MEMORY:
+        return "out_of_memory";
+    }
+    ABORT("Unknown search status.");
+}
+
+void SearchAlgorithm::report_telemetry(const string &event) {
+    double time = utils::g_timer();
+    int expanded = statistics.get_expanded();
+    int evaluated = statistics.get_evaluated_states();
+    double elapsed = time - last_telemetry_time;
+
+    utils::TelemetryRecord record;
+    record.add("event", event);
+    record.add("time", time);
+    record.add("search", description);
+    record.add("status", string(get_status_name(status)));
+    record.add("expanded", expanded);
+    record.add("evaluated", evaluated);
+    record.add("generated", statistics.get_generated());
+    record.add(
+        "expansions_per_second",
+        (expanded - last_telemetry_expanded) / elapsed);
+    record.add(
+        "evaluations_per_second",
+        (evaluated - last_telemetry_evaluated) / elapsed);
+    int open_list_size = get_open_list_size();
+    if (open_list_size >= 0) {
+        record.add("open_list_size", open_list_size);
+    } else {
+        record.add_null("open_list_size");
+    }
+    int f_layer = statistics.get_lastjump_f_value();
+    if (f_layer >= 0) {
+        record.add("f_layer", f_layer);
+    } else {
+        record.add_null("f_layer");
+    }
+    record.add("registry_size", static_cast<long long>(state_registry.size()));
+    record.add("bytes_per_state", state_registry.get_state_size_in_bytes());
+    record.add("evaluator_time", utils::get_telemetry_times());
+    record.add("memory_kb", utils::get_current_memory_in_kb());
+    record.add("peak_memory_kb", utils::get_peak_memory_in_kb());
+    utils::write_telemetry_record(move(record));
+
+    last_telemetry_time = time;
+    last_telemetry_expanded = expanded;
+    last_telemetry_evaluated = evaluated;
+}
+
 bool SearchAlgorithm::check_goal_and_set_plan(const State &state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         log << "Solution found!" << endl;
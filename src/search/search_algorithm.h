@@ -31,6 +31,7 @@ class SuccessorGenerator;
 enum SearchStatus {
     IN_PROGRESS,
     TIMEOUT,
+    OUT_OF_MEMORY,
     FAILED,
     SOLVED
 };
@@ -39,6 +40,11 @@ class SearchAlgorithm {
     std::string description;
     SearchStatus status;
     bool solution_found;
+    bool stop_requested;
+    // Counters at the time of the last telemetry record.
+    double last_telemetry_time;
+    int last_telemetry_expanded;
+    int last_telemetry_evaluated;
     Plan plan;
 protected:
     // Hold a reference to the task implementation and pass it to objects that
@@ -49,7 +55,13 @@ protected:
 
     mutable utils::LogProxy log;
     PlanManager plan_manager;
-    StateRegistry state_registry;
+    /*
+      The state registry is usually owned by the search algorithm, but it
+      can be shared with other search algorithms (see
+      SharedStateRegistryScope).
+    */
+    const std::shared_ptr<StateRegistry> shared_state_registry;
+    StateRegistry &state_registry;
     const successor_generator::SuccessorGenerator &successor_generator;
     SearchSpace search_space;
     SearchProgress search_progress;
@@ -63,6 +75,13 @@ protected:
     }
     virtual SearchStatus step() = 0;
 
+    /*
+      Return the number of entries in the open list for telemetry (see
+      utils/telemetry.h), or -1 if the search algorithm has no open list.
+    */
+    virtual int get_open_list_size() const;
+    void report_telemetry(const std::string &event);
+
     void set_plan(const Plan &plan);
     bool check_goal_and_set_plan(const State &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
@@ -80,6 +99,11 @@ public:
     bool found_solution() const;
     SearchStatus get_status() const;
     const Plan &get_plan() const;
+    /*
+      Run the search. If the memory budget is exhausted while the search is
+      running (see utils/memory.h), it stops after the current step with
+      status OUT_OF_MEMORY.
+    */
     void search();
     const SearchStatistics &get_statistics() const {
         return statistics;
@@ -98,6 +122,25 @@ public:
     }
 };
 
+/*
+  Search algorithms that are constructed while a SharedStateRegistryScope
+  exists use the given state registry instead of creating their own. States
+  registered by one of them keep their IDs for the others, so per-state
+  information of evaluators, e.g., cached heuristic values, remains valid.
+  Scopes can be nested.
+*/
+class SharedStateRegistryScope {
+    std::shared_ptr<StateRegistry> previous_registry;
+public:
+    explicit SharedStateRegistryScope(
+        const std::shared_ptr<StateRegistry> &registry);
+    ~SharedStateRegistryScope();
+
+    SharedStateRegistryScope(const SharedStateRegistryScope &) = delete;
+    SharedStateRegistryScope &operator=(
+        const SharedStateRegistryScope &) = delete;
+};
+
 /*
   Print evaluator values of all evaluators evaluated in the evaluation context.
 */
@@ -0,0 +1,555 @@
+#include "breadth_first_heuristic_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../per_state_information.h"
+
+#include "../algorithms/int_packer.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace breadth_first_heuristic_search {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Breadth-first search from a start state that prunes states whose f-value
+  exceeds a cost bound and only stores the layers needed for duplicate
+  detection and the relay layer. The search either looks for a goal state
+  (if no target is given) or for the target state reached with a real cost
+  of at most max_target_real_g.
+
+  Like the other search algorithms, we prune states whose real cost (i.e.,
+  the cost without applying cost_type) reaches the bound of the search. All
+  states of a layer have the same g-value, but their real costs can differ,
+  so each state stores the lowest real cost with which it has been reached
+  in its layer.
+*/
+class LayeredSearch {
+    struct Layer {
+        const int depth;
+        unique_ptr<StateRegistry> registry;
+        // States of this layer that are expanded, i.e., that are not pruned.
+        vector<StateID> frontier;
+        PerStateInformation<int> real_gs;
+        /*
+          For layers at or after the relay layer, the ID of the relay state
+          (in the registry of the relay layer) for each state of this layer.
+        */
+        PerStateInformation<StateID> relays;
+
+        Layer(int depth, const TaskProxy &task_proxy)
+            : depth(depth),
+              registry(make_unique<StateRegistry>(task_proxy)),
+              real_gs(-1),
+              relays(StateID::no_state) {
+        }
+    };
+
+    BreadthFirstHeuristicSearch &search;
+    const PackedState *target;
+    const int g_offset;
+    const int cost_bound;
+    const int max_target_real_g;
+    const int relay_depth;
+
+    // The last layer is the current layer, the others are previous layers.
+    deque<unique_ptr<Layer>> layers;
+    // The relay layer once it is no longer used for duplicate detection.
+    unique_ptr<Layer> relay_layer;
+    int next_cost_bound;
+
+    PackedState found_target;
+    int found_target_depth;
+    int found_target_real_g;
+    PackedState found_relay;
+    int found_relay_depth;
+    int found_relay_real_g;
+
+    bool is_duplicate(const PackedState &buffer) const;
+    bool is_target(const State &state, const PackedState &buffer) const;
+    const Layer &get_relay_layer() const;
+    void set_solution(
+        const PackedState &buffer, int depth, int real_g,
+        const Layer &parent_layer, const State &parent);
+    void update_peak_num_stored_states() const;
+
+public:
+    LayeredSearch(
+        BreadthFirstHeuristicSearch &search, const PackedState &start,
+        const PackedState *target, int g_offset, int real_g_offset,
+        int cost_bound, int max_target_real_g, int relay_depth);
+
+    /*
+      Expand all states of the current layer. Returns SOLVED if a target
+      state was generated and FAILED if the current layer has no states to
+      expand.
+    */
+    SearchStatus expand_layer();
+
+    int get_next_cost_bound() const {
+        return next_cost_bound;
+    }
+
+    const PackedState &get_target() const {
+        return found_target;
+    }
+
+    int get_target_depth() const {
+        return found_target_depth;
+    }
+
+    int get_target_real_g() const {
+        return found_target_real_g;
+    }
+
+    /*
+      The ancestor of the target state in the relay layer, or the target
+      state itself if it is found before the relay layer.
+    */
+    const PackedState &get_relay() const {
+        return found_relay;
+    }
+
+    int get_relay_depth() const {
+        return found_relay_depth;
+    }
+
+    int get_relay_real_g() const {
+        return found_relay_real_g;
+    }
+};
+
+LayeredSearch::LayeredSearch(
+    BreadthFirstHeuristicSearch &search, const PackedState &start,
+    const PackedState *target, int g_offset, int real_g_offset,
+    int cost_bound, int max_target_real_g, int relay_depth)
+    : search(search),
+      target(target),
+      g_offset(g_offset),
+      cost_bound(cost_bound),
+      max_target_real_g(max_target_real_g),
+      relay_depth(relay_depth),
+      next_cost_bound(INF),
+      found_target_depth(-1),
+      found_target_real_g(-1),
+      found_relay_depth(-1),
+      found_relay_real_g(-1) {
+    layers.push_back(make_unique<Layer>(0, search.task_proxy));
+    Layer &start_layer = *layers.back();
+    State start_state = start_layer.registry->register_state(start.data());
+    start_layer.frontier.push_back(start_state.get_id());
+    start_layer.real_gs[start_state] = real_g_offset;
+    if (relay_depth == 0) {
+        start_layer.relays[start_state] = start_state.get_id();
+    }
+}
+
+bool LayeredSearch::is_duplicate(const PackedState &buffer) const {
+    /*
+      The last layer is the one being generated. Duplicates within it are
+      handled by expand_layer(), which keeps the cheapest real cost.
+    */
+    for (size_t i = 0; i + 1 < layers.size(); ++i) {
+        if (layers[i]->registry->find_state(buffer.data()) !=
+            StateID::no_state) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LayeredSearch::is_target(
+    const State &state, const PackedState &buffer) const {
+    if (target) {
+        return buffer == *target;
+    }
+    return task_properties::is_goal_state(search.task_proxy, state);
+}
+
+const LayeredSearch::Layer &LayeredSearch::get_relay_layer() const {
+    if (relay_layer) {
+        return *relay_layer;
+    }
+    for (const unique_ptr<Layer> &layer : layers) {
+        if (layer->depth == relay_depth) {
+            return *layer;
+        }
+    }
+    ABORT("Relay layer not found.");
+}
+
+void LayeredSearch::set_solution(
+    const PackedState &buffer, int depth, int real_g,
+    const Layer &parent_layer, const State &parent) {
+    found_target = buffer;
+    found_target_depth = depth;
+    found_target_real_g = real_g;
+    if (depth <= relay_depth) {
+        found_relay = buffer;
+        found_relay_depth = depth;
+        found_relay_real_g = real_g;
+    } else {
+        StateID relay_id = parent_layer.relays[parent];
+        assert(relay_id != StateID::no_state);
+        const Layer &relay_layer = get_relay_layer();
+        State relay = relay_layer.registry->lookup_state(relay_id);
+        const PackedStateBin *relay_buffer = relay.get_buffer();
+        found_relay.assign(relay_buffer, relay_buffer + buffer.size());
+        found_relay_depth = relay_depth;
+        found_relay_real_g = relay_layer.real_gs[relay];
+    }
+}
+
+void LayeredSearch::update_peak_num_stored_states() const {
+    int num_stored_states = 0;
+    for (const unique_ptr<Layer> &layer : layers) {
+        num_stored_states += layer->registry->size();
+    }
+    if (relay_layer) {
+        num_stored_states += relay_layer->registry->size();
+    }
+    search.peak_num_stored_states =
+        max(search.peak_num_stored_states, num_stored_states);
+}
+
+SearchStatus LayeredSearch::expand_layer() {
+    Layer &layer = *layers.back();
+    if (layer.frontier.empty()) {
+        return FAILED;
+    }
+    int depth = layer.depth + 1;
+    int g = g_offset + depth;
+    layers.push_back(make_unique<Layer>(depth, search.task_proxy));
+    Layer &next_layer = *layers.back();
+    const int_packer::IntPacker &state_packer =
+        next_layer.registry->get_state_packer();
+    Evaluator *eval = search.evaluator.get();
+    SearchStatistics &statistics = search.statistics;
+
+    PackedState buffer(state_packer.get_num_bins());
+    vector<OperatorID> applicable_ops;
+    for (StateID id : layer.frontier) {
+        State state = layer.registry->lookup_state(id);
+        state.unpack();
+        int real_g = layer.real_gs[state];
+        statistics.inc_expanded();
+        applicable_ops.clear();
+        search.successor_generator.generate_applicable_ops(
+            state, applicable_ops);
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = search.task_proxy.get_operators()[op_id];
+            int succ_real_g = real_g + op.get_cost();
+            if (succ_real_g >= search.bound) {
+                continue;
+            }
+            State succ = state.get_unregistered_successor(op);
+            statistics.inc_generated();
+            state_packer.pack_all(
+                succ.get_unpacked_values().data(), buffer.data());
+            if (is_duplicate(buffer)) {
+                continue;
+            }
+            int num_states = next_layer.registry->size();
+            State registered_succ =
+                next_layer.registry->register_state(buffer.data());
+            bool is_new =
+                static_cast<int>(next_layer.registry->size()) > num_states;
+            int &stored_real_g = next_layer.real_gs[registered_succ];
+            if (!is_new && succ_real_g >= stored_real_g) {
+                // Duplicate within the next layer that is not cheaper.
+                continue;
+            }
+            stored_real_g = succ_real_g;
+            if (depth == relay_depth) {
+                next_layer.relays[registered_succ] = registered_succ.get_id();
+            } else if (depth > relay_depth) {
+                next_layer.relays[registered_succ] = layer.relays[state];
+            }
+            if (is_target(succ, buffer) && succ_real_g <= max_target_real_g) {
+                set_solution(buffer, depth, succ_real_g, layer, state);
+                return SOLVED;
+            }
+            if (!is_new) {
+                // The state has already been evaluated.
+                continue;
+            }
+
+            EvaluationContext eval_context(
+                registered_succ, g, false, &statistics);
+            statistics.inc_evaluated_states();
+            if (eval_context.is_evaluator_value_infinite(eval)) {
+                statistics.inc_dead_ends();
+                continue;
+            }
+            int f = g + eval_context.get_evaluator_value(eval);
+            if (f > cost_bound) {
+                next_cost_bound = min(next_cost_bound, f);
+                continue;
+            }
+            next_layer.frontier.push_back(registered_succ.get_id());
+        }
+    }
+    update_peak_num_stored_states();
+
+    layer.frontier = vector<StateID>();
+
+    /*
+      The next layer becomes the current layer. We keep it and the previous
+      layers for duplicate detection.
+    */
+    while (static_cast<int>(layers.size()) > search.previous_layers + 1) {
+        if (layers.front()->depth == relay_depth) {
+            relay_layer = move(layers.front());
+        }
+        layers.pop_front();
+    }
+    return IN_PROGRESS;
+}
+
+BreadthFirstHeuristicSearch::BreadthFirstHeuristicSearch(
+    const shared_ptr<Evaluator> &eval, int previous_layers,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      evaluator(eval),
+      previous_layers(previous_layers),
+      f_bound(0),
+      num_iterations(0),
+      num_reconstruction_searches(0),
+      peak_num_stored_states(0) {
+}
+
+BreadthFirstHeuristicSearch::~BreadthFirstHeuristicSearch() = default;
+
+void BreadthFirstHeuristicSearch::initialize() {
+    log << "Conducting breadth-first iterative-deepening A* search, "
+        << "(real) bound = " << bound << endl;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_cost(op) != 1) {
+            cerr << "bfhs only supports tasks with unit costs. Use "
+                 << "cost_type=one to ignore action costs." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+    }
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "bfhs does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const State &state = state_registry.get_initial_state();
+    const PackedStateBin *buffer = state.get_buffer();
+    initial_state.assign(
+        buffer, buffer + state_registry.get_state_packer().get_num_bins());
+    EvaluationContext eval_context(state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        log << "Initial state is a dead end." << endl;
+        f_bound = INF;
+    } else {
+        f_bound = eval_context.get_evaluator_value(evaluator.get());
+    }
+}
+
+State BreadthFirstHeuristicSearch::create_unregistered_state(
+    const PackedState &buffer) const {
+    vector<int> values(task_proxy.get_variables().size());
+    state_registry.get_state_packer().unpack_all(buffer.data(), values.data());
+    return task_proxy.create_state(move(values));
+}
+
+/*
+  Append an optimal path of the given length from start to target to plan
+  whose real cost is at most max_real_g - real_g. We know that such a path
+  exists and that the path continues to a goal state with total cost
+  cost_bound.
+*/
+void BreadthFirstHeuristicSearch::find_path(
+    const PackedState &start, const PackedState &target, int g, int real_g,
+    int length, int max_real_g, int cost_bound, Plan &plan) {
+    if (length == 0) {
+        assert(start == target);
+        return;
+    }
+    if (length == 1) {
+        State state = create_unregistered_state(start);
+        vector<OperatorID> applicable_ops;
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        PackedState buffer(start.size());
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if (real_g + op.get_cost() > max_real_g) {
+                continue;
+            }
+            State succ = state.get_unregistered_successor(op);
+            state_registry.get_state_packer().pack_all(
+                succ.get_unpacked_values().data(), buffer.data());
+            if (buffer == target) {
+                plan.push_back(op_id);
+                return;
+            }
+        }
+    } else {
+        ++num_reconstruction_searches;
+        PackedState relay;
+        int relay_depth;
+        int relay_real_g = -1;
+        {
+            LayeredSearch segment_search(
+                *this, start, &target, g, real_g, cost_bound, max_real_g,
+                length / 2);
+            SearchStatus status;
+            do {
+                status = segment_search.expand_layer();
+            } while (status == IN_PROGRESS);
+            if (status == SOLVED &&
+                segment_search.get_target_depth() == length) {
+                relay = segment_search.get_relay();
+                relay_depth = segment_search.get_relay_depth();
+                relay_real_g = segment_search.get_relay_real_g();
+            } else {
+                relay_depth = -1;
+            }
+        }
+        if (relay_depth != -1) {
+            find_path(
+                start, relay, g, real_g, relay_depth, relay_real_g,
+                cost_bound, plan);
+            find_path(
+                relay, target, g + relay_depth, relay_real_g,
+                length - relay_depth, max_real_g, cost_bound, plan);
+            return;
+        }
+    }
+    cerr << "Plan reconstruction failed." << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+SearchStatus BreadthFirstHeuristicSearch::step() {
+    if (!layered_search) {
+        if (num_iterations == 0 &&
+            check_goal_and_set_plan(state_registry.get_initial_state())) {
+            return SOLVED;
+        }
+        if (f_bound == INF) {
+            log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        ++num_iterations;
+        statistics.report_f_value_progress(f_bound);
+        /*
+          Since all actions have unit cost, the depth of a goal state is at
+          most the f bound.
+        */
+        layered_search = make_unique<LayeredSearch>(
+            *this, initial_state, nullptr, 0, 0, f_bound, INF, f_bound / 2);
+    }
+
+    SearchStatus status = layered_search->expand_layer();
+    if (status == SOLVED) {
+        PackedState goal = layered_search->get_target();
+        int plan_length = layered_search->get_target_depth();
+        int plan_cost = layered_search->get_target_real_g();
+        PackedState relay = layered_search->get_relay();
+        int relay_depth = layered_search->get_relay_depth();
+        int relay_real_g = layered_search->get_relay_real_g();
+        layered_search.reset();
+        log << "Solution found at depth " << plan_length
+            << ", reconstructing plan." << endl;
+        Plan plan;
+        find_path(
+            initial_state, relay, 0, 0, relay_depth, relay_real_g,
+            plan_length, plan);
+        find_path(
+            relay, goal, relay_depth, relay_real_g, plan_length - relay_depth,
+            plan_cost, plan_length, plan);
+        set_plan(plan);
+        return SOLVED;
+    } else if (status == FAILED) {
+        f_bound = layered_search->get_next_cost_bound();
+        layered_search.reset();
+    }
+    return IN_PROGRESS;
+}
+
+void BreadthFirstHeuristicSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "f bound iterations: " << num_iterations << endl;
+    log << "Plan reconstruction searches: " << num_reconstruction_searches
+        << endl;
+    log << "Peak number of stored states: " << peak_num_stored_states << endl;
+}
+
+class BreadthFirstHeuristicSearchFeature
+    : public plugins::TypedFeature<
+          SearchAlgorithm, BreadthFirstHeuristicSearch> {
+public:
+    BreadthFirstHeuristicSearchFeature() : TypedFeature("bfhs") {
+        document_title("Breadth-first heuristic search");
+        document_synopsis(
+            "Breadth-first iterative-deepening A* (Zhou and Hansen, AIJ "
+            "2006). Iterated breadth-first searches that prune states whose "
+            "f-value exceeds a bound, starting with the h-value of the "
+            "initial state and increasing it to the smallest pruned f-value "
+            "after each iteration. Only the last few layers of the search "
+            "and one layer in the middle are stored. Plans are reconstructed "
+            "by divide-and-conquer search from the relay states in the "
+            "middle layer. This uses much less memory than A* if the layers "
+            "are small compared to the whole search space, at the cost of "
+            "re-expanding states in each iteration and during plan "
+            "reconstruction.");
+
+        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<int>(
+            "previous_layers",
+            "number of layers before the current layer that are used for "
+            "duplicate detection. One layer suffices to avoid re-expansions "
+            "in tasks whose operators can all be undone. In other tasks, "
+            "states can be expanded again in later layers, which does not "
+            "affect optimality.",
+            "1", plugins::Bounds("0", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "bfhs");
+
+        document_language_support("action costs", "not supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "supported");
+
+        document_property("admissible", "yes if the evaluator is admissible");
+        document_property("consistent", "no");
+        document_property("safe", "yes if the evaluator is safe");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Action costs",
+            "All actions must have cost 1 after applying cost_type. Use "
+            "cost_type=one to find shortest plans for tasks with action "
+            "costs.");
+    }
+
+    virtual shared_ptr<BreadthFirstHeuristicSearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<
+            BreadthFirstHeuristicSearch>(
+            opts.get<shared_ptr<Evaluator>>("eval"),
+            opts.get<int>("previous_layers"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<BreadthFirstHeuristicSearchFeature> _plugin;
+}
@@ -0,0 +1,70 @@
+#ifndef SEARCH_ALGORITHMS_BREADTH_FIRST_HEURISTIC_SEARCH_H
+#define SEARCH_ALGORITHMS_BREADTH_FIRST_HEURISTIC_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace breadth_first_heuristic_search {
+class LayeredSearch;
+
+using PackedState = std::vector<PackedStateBin>;
+
+/*
+  Breadth-first iterative-deepening A* (Zhou and Hansen, AIJ 2006) for tasks
+  with unit costs.
+
+  Each iteration is a breadth-first heuristic search: a breadth-first search
+  that prunes all states whose f-value exceeds the bound of the iteration.
+  The first iteration uses the h-value of the initial state as bound and each
+  further iteration uses the smallest f-value pruned in the previous one.
+  Instead of a closed list, we only store the last few layers of the search
+  for duplicate detection. Every layer has its own state registry, which is
+  destroyed (together with all per-state information of its states, e.g.,
+  cached heuristic values) once the layer is not needed anymore.
+
+  Since we do not store parent pointers, states store the ID of their
+  ancestor in the middle layer of the search (the relay layer), which is the
+  only other layer we keep. When a goal state is found, we know a state in
+  the middle of an optimal plan and recursively reconstruct the plan by
+  searching from the initial state to the relay state and from the relay
+  state to the goal state (divide-and-conquer solution reconstruction).
+*/
+class BreadthFirstHeuristicSearch : public SearchAlgorithm {
+    friend class LayeredSearch;
+
+    const std::shared_ptr<Evaluator> evaluator;
+    const int previous_layers;
+
+    int f_bound;
+    PackedState initial_state;
+    std::unique_ptr<LayeredSearch> layered_search;
+
+    int num_iterations;
+    int num_reconstruction_searches;
+    int peak_num_stored_states;
+
+    State create_unregistered_state(const PackedState &buffer) const;
+    void find_path(
+        const PackedState &start, const PackedState &target, int g,
+        int real_g, int length, int max_real_g, int cost_bound, Plan &plan);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    BreadthFirstHeuristicSearch(
+        const std::shared_ptr<Evaluator> &eval, int previous_layers,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~BreadthFirstHeuristicSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
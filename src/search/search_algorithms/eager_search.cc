@@ -8,13 +8,16 @@
 #include "../algorithms/ordered_set.h"
 #include "../plugins/options.h"
 #include "../task_utils/successor_generator.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
+#include "../utils/profiler.h"
 
 #include <cassert>
 #include <cstdlib>
 #include <memory>
 #include <optional>
 #include <set>
+#include <utility>
 
 using namespace std;
 
@@ -30,6 +33,10 @@ EagerSearch::EagerSearch(
     : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
       reopen_closed_nodes(reopen_closed),
       open_list(open->create_state_open_list()),
+      compact_open_list_hook(
+          utils::MemoryPressureStage::COMPACT_DATA_STRUCTURES,
+          "compact open list of " + description,
+          [this]() { open_list->compact(); }),
       f_evaluator(f_eval), // default nullptr
       preferred_operator_evaluators(preferred),
       lazy_evaluator(lazy_evaluator), // default nullptr
@@ -38,6 +45,13 @@ EagerSearch::EagerSearch(
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (lazy_evaluator) {
+        /*
+          Without cached estimates, is_estimate_cached() is always false
+          and we would silently stop re-evaluating states.
+        */
+        lazy_evaluator->keep_cached_estimates();
+    }
 }
 
 void EagerSearch::initialize() {
@@ -77,6 +91,17 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    if (path_dependent_evaluators.empty()) {
+        vector<Evaluator *> open_list_evaluators;
+        open_list->get_evaluators(open_list_evaluators);
+        utils::HashSet<Evaluator *> seen;
+        for (Evaluator *evaluator : open_list_evaluators) {
+            if (seen.insert(evaluator).second) {
+                batch_evaluators.push_back(evaluator);
+            }
+        }
+    }
+
     State initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -107,6 +132,10 @@ void EagerSearch::initialize() {
     pruning_method->initialize(task);
 }
 
+int EagerSearch::get_open_list_size() const {
+    return open_list->get_num_entries();
+}
+
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
@@ -126,7 +155,11 @@ SearchStatus EagerSearch::step() {
 
 optional<SearchNode> EagerSearch::get_next_node_to_expand() {
     while (!open_list->empty()) {
-        StateID id = open_list->remove_min();
+        StateID id = StateID::no_state;
+        {
+            PROFILE_SCOPE(utils::ProfilerComponent::OPEN_LIST);
+            id = open_list->remove_min();
+        }
         State s = state_registry.lookup_state(id);
         SearchNode node = search_space.get_node(s);
 
@@ -203,9 +236,60 @@ SearchStatus EagerSearch::expand(const SearchNode &node) {
         return SOLVED;
 
     generate_successors(node);
+
+    /*
+      Without reopening, closed states are never expanded again, so with hash
+      compaction we do not need their data anymore.
+    */
+    if (!reopen_closed_nodes && state_registry.uses_hash_compaction()) {
+        state_registry.release_state_data(state.get_id());
+    }
     return IN_PROGRESS;
 }
 
+/*
+  Create evaluation contexts for the successors that are new (only for the
+  first occurrence of each state) and evaluate the batch evaluators for all
+  of them at once. Like the open list, we stop evaluating a state as soon as
+  an evaluator reports it as a dead end. eval_context_indices[i] is the index
+  of the context for successors[i] or -1 if there is none.
+*/
+void EagerSearch::evaluate_new_successors(
+    const SearchNode &node, const vector<pair<OperatorID, State>> &successors,
+    const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+    vector<EvaluationContext> &eval_contexts,
+    vector<int> &eval_context_indices) {
+    eval_context_indices.assign(successors.size(), -1);
+    utils::HashSet<StateID> new_state_ids;
+    for (size_t i = 0; i < successors.size(); ++i) {
+        const auto &[op_id, succ_state] = successors[i];
+        if (!search_space.get_node(succ_state).is_new() ||
+            !new_state_ids.insert(succ_state.get_id()).second) {
+            continue;
+        }
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+        eval_context_indices[i] = eval_contexts.size();
+        eval_contexts.emplace_back(
+            succ_state, succ_g, preferred_operators.contains(op_id),
+            &statistics);
+    }
+
+    vector<EvaluationContext *> finite_contexts;
+    finite_contexts.reserve(eval_contexts.size());
+    for (EvaluationContext &eval_context : eval_contexts) {
+        // Without parallel evaluation, this does nothing.
+        eval_context.evaluate_concurrently(batch_evaluators);
+        finite_contexts.push_back(&eval_context);
+    }
+    for (Evaluator *evaluator : batch_evaluators) {
+        EvaluationContext::evaluate_batch(evaluator, finite_contexts);
+        erase_if(finite_contexts, [&](EvaluationContext *eval_context) {
+            return eval_context->is_evaluator_value_infinite(evaluator);
+        });
+    }
+}
+
 void EagerSearch::generate_successors(const SearchNode &node) {
     const State &state = node.get_state();
 
@@ -222,13 +306,35 @@ void EagerSearch::generate_successors(const SearchNode &node) {
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     collect_preferred_operators_for_node(node, preferred_operators);
 
+    /*
+      We generate all successors before processing them, so their data must
+      stay valid until the end of this function even if they are duplicates
+      of states whose data was released.
+    */
+    state_registry.hold_freed_slots();
+    vector<pair<OperatorID, State>> successors;
+    successors.reserve(applicable_operators.size());
     for (OperatorID op_id : applicable_operators) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node.get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        State succ_state = state_registry.get_successor_state(state, op);
+        successors.emplace_back(
+            op_id, state_registry.get_successor_state(state, op));
         statistics.inc_generated();
+    }
+
+    vector<EvaluationContext> new_eval_contexts;
+    vector<int> eval_context_indices;
+    if (!batch_evaluators.empty()) {
+        evaluate_new_successors(
+            node, successors, preferred_operators, new_eval_contexts,
+            eval_context_indices);
+    }
+
+    for (size_t i = 0; i < successors.size(); ++i) {
+        const auto &[op_id, succ_state] = successors[i];
+        OperatorProxy op = task_proxy.get_operators()[op_id];
 
         SearchNode succ_node = search_space.get_node(succ_state);
 
@@ -252,8 +358,13 @@ void EagerSearch::generate_successors(const SearchNode &node) {
             */
             int succ_g = node.get_g() + get_adjusted_cost(op);
 
-            EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
+            bool is_batch_evaluated =
+                !eval_context_indices.empty() && eval_context_indices[i] != -1;
+            EvaluationContext succ_eval_context =
+                is_batch_evaluated
+                    ? move(new_eval_contexts[eval_context_indices[i]])
+                    : EvaluationContext(
+                          succ_state, succ_g, is_preferred, &statistics);
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
@@ -306,6 +417,7 @@ void EagerSearch::generate_successors(const SearchNode &node) {
             */
         }
     }
+    state_registry.reuse_held_slots();
 }
 
 void EagerSearch::reward_progress() {
@@ -4,6 +4,8 @@
 #include "../open_list.h"
 #include "../search_algorithm.h"
 
+#include "../utils/memory.h"
+
 #include <memory>
 #include <optional>
 #include <vector>
@@ -21,11 +23,19 @@ class EagerSearch : public SearchAlgorithm {
     const bool reopen_closed_nodes;
 
     std::unique_ptr<StateOpenList> open_list;
+    utils::MemoryPressureHook compact_open_list_hook;
     std::shared_ptr<Evaluator> f_evaluator;
 
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
     std::shared_ptr<Evaluator> lazy_evaluator;
+    /*
+      Evaluators of the open list that we evaluate for all new successors of
+      an expanded state at once (see Evaluator::compute_results). Empty if
+      there are path-dependent evaluators, which must be notified of each
+      transition before the successor is evaluated.
+    */
+    std::vector<Evaluator *> batch_evaluators;
 
     std::shared_ptr<PruningMethod> pruning_method;
 
@@ -38,11 +48,18 @@ class EagerSearch : public SearchAlgorithm {
         const SearchNode &node,
         ordered_set::OrderedSet<OperatorID> &preferred_operators);
     SearchStatus expand(const SearchNode &node);
+    void evaluate_new_successors(
+        const SearchNode &node,
+        const std::vector<std::pair<OperatorID, State>> &successors,
+        const ordered_set::OrderedSet<OperatorID> &preferred_operators,
+        std::vector<EvaluationContext> &eval_contexts,
+        std::vector<int> &eval_context_indices);
     void generate_successors(const SearchNode &node);
 
 protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
+    virtual int get_open_list_size() const override;
 
 public:
     explicit EagerSearch(
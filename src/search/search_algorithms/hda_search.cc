@@ -0,0 +1,618 @@
+#include "hda_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../per_state_information.h"
+
+#include "../algorithms/mpsc_queue.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
+#include <limits>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_search {
+/*
+  Everything a worker needs to know about a successor state that is owned by
+  another worker. The packed state data is stored separately in the batch.
+*/
+struct SuccessorMessage {
+    int g;
+    int real_g;
+    int parent_owner;
+    StateID parent_id;
+    OperatorID creating_operator_id;
+};
+
+struct MessageBatch {
+    vector<PackedStateBin> state_data;
+    vector<SuccessorMessage> successors;
+
+    bool empty() const {
+        return successors.empty();
+    }
+};
+
+/*
+  Like the search node information of SearchSpace, but a parent is
+  identified by its owner and the state ID in the owner's registry.
+*/
+struct HDANodeInfo {
+    enum NodeStatus {
+        NEW = 0,
+        OPEN = 1,
+        CLOSED = 2,
+        DEAD_END = 3
+    };
+
+    unsigned int status : 2;
+    int g : 30;
+    int real_g;
+    /*
+      The heuristic value computed when the node was inserted for the first
+      time. Path-dependent evaluators are not supported, so it never changes
+      and we do not evaluate the node again when expanding it.
+    */
+    int h;
+    int parent_owner;
+    StateID parent_state_id;
+    OperatorID creating_operator_id;
+
+    HDANodeInfo()
+        : status(NEW),
+          g(-1),
+          real_g(-1),
+          h(-1),
+          parent_owner(-1),
+          parent_state_id(StateID::no_state),
+          creating_operator_id(-1) {
+    }
+};
+
+class HDAWorker {
+    HDASearch &search;
+    const int id;
+    const int num_bins;
+    const shared_ptr<Evaluator> heuristic;
+    unique_ptr<StateOpenList> open_list;
+    StateRegistry state_registry;
+    const int_packer::IntPacker &state_packer;
+    PerStateInformation<HDANodeInfo> node_infos;
+    SearchStatistics statistics;
+
+    mpsc_queue::MPSCQueue<MessageBatch> inbox;
+    vector<MessageBatch> outboxes;
+    vector<MessageBatch> received_batches;
+    int num_sent_states;
+    int num_received_states;
+
+    vector<PackedStateBin> successor_buffer;
+    vector<OperatorID> applicable_ops;
+
+    void insert_node(
+        const PackedStateBin *buffer, const SuccessorMessage &message);
+    void generate_successors(const State &state, const HDANodeInfo &info);
+    bool expand_next_node();
+    void receive_messages();
+    void flush_outboxes();
+public:
+    HDAWorker(
+        HDASearch &search, int id, const shared_ptr<Evaluator> &heuristic);
+
+    void insert_initial_state(const State &initial_state);
+    void run();
+
+    bool has_messages() const {
+        return !inbox.empty();
+    }
+
+    const HDANodeInfo &get_node_info(StateID state_id) const {
+        return node_infos[state_registry.lookup_state(state_id)];
+    }
+
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+
+    int get_num_registered_states() const {
+        return state_registry.size();
+    }
+
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+HDAWorker::HDAWorker(
+    HDASearch &search, int id, const shared_ptr<Evaluator> &heuristic)
+    : search(search),
+      id(id),
+      num_bins(search.state_registry.get_state_packer().get_num_bins()),
+      heuristic(heuristic),
+      state_registry(search.task_proxy),
+      state_packer(state_registry.get_state_packer()),
+      statistics(search.log),
+      outboxes(search.num_threads),
+      num_sent_states(0),
+      num_received_states(0),
+      successor_buffer(num_bins) {
+    open_list = search_common::create_astar_open_list_factory_and_f_eval(
+                    heuristic, utils::Verbosity::SILENT)
+                    .first->create_state_open_list();
+}
+
+void HDAWorker::insert_initial_state(const State &initial_state) {
+    SuccessorMessage message{
+        0, 0, -1, StateID::no_state, OperatorID::no_operator};
+    insert_node(initial_state.get_buffer(), message);
+
+    State state = state_registry.register_state(initial_state.get_buffer());
+    if (node_infos[state].status == HDANodeInfo::DEAD_END) {
+        search.log << "Initial state is a dead end." << endl;
+    } else {
+        EvaluationContext eval_context(state, 0, false, nullptr);
+        print_initial_evaluator_values(eval_context);
+    }
+}
+
+void HDAWorker::insert_node(
+    const PackedStateBin *buffer, const SuccessorMessage &message) {
+    State state = state_registry.register_state(buffer);
+    HDANodeInfo &info = node_infos[state];
+    if (info.status == HDANodeInfo::DEAD_END) {
+        return;
+    }
+    if (info.status != HDANodeInfo::NEW && message.g >= info.g) {
+        return;
+    }
+
+    EvaluationContext eval_context(state, message.g, false, &statistics);
+    if (info.status == HDANodeInfo::NEW) {
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(eval_context)) {
+            info.status = HDANodeInfo::DEAD_END;
+            statistics.inc_dead_ends();
+            return;
+        }
+        info.h = eval_context.get_evaluator_value(heuristic.get());
+    } else if (info.status == HDANodeInfo::CLOSED) {
+        statistics.inc_reopened();
+    }
+    info.status = HDANodeInfo::OPEN;
+    info.g = message.g;
+    info.real_g = message.real_g;
+    info.parent_owner = message.parent_owner;
+    info.parent_state_id = message.parent_id;
+    info.creating_operator_id = message.creating_operator_id;
+
+    /*
+      Nodes that cannot lead to a cheaper plan than the incumbent are kept as
+      open nodes but not inserted into the open list. If we later find a
+      cheaper path to them, they are inserted as usual.
+    */
+    int f = info.g + info.h;
+    if (f < search.incumbent_cost.load(memory_order_relaxed)) {
+        open_list->insert(eval_context, state.get_id());
+    }
+}
+
+void HDAWorker::generate_successors(
+    const State &state, const HDANodeInfo &info) {
+    applicable_ops.clear();
+    search.successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated_ops(applicable_ops.size());
+
+    OperatorsProxy operators = search.task_proxy.get_operators();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        if ((info.real_g + op.get_cost()) >= search.bound) {
+            continue;
+        }
+        int succ_g = info.g + search.get_adjusted_cost(op);
+        if (succ_g >= search.incumbent_cost.load(memory_order_relaxed)) {
+            continue;
+        }
+
+        copy(
+            state.get_buffer(), state.get_buffer() + num_bins,
+            successor_buffer.begin());
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(
+                    successor_buffer.data(), effect_pair.var,
+                    effect_pair.value);
+            }
+        }
+        statistics.inc_generated();
+
+        SuccessorMessage message{
+            succ_g, info.real_g + op.get_cost(), id, state.get_id(), op_id};
+        int owner = search.get_owner(successor_buffer.data());
+        if (owner == id) {
+            insert_node(successor_buffer.data(), message);
+        } else {
+            MessageBatch &outbox = outboxes[owner];
+            outbox.state_data.insert(
+                outbox.state_data.end(), successor_buffer.begin(),
+                successor_buffer.end());
+            outbox.successors.push_back(message);
+        }
+    }
+}
+
+bool HDAWorker::expand_next_node() {
+    while (!open_list->empty()) {
+        StateID state_id = open_list->remove_min();
+        State state = state_registry.lookup_state(state_id);
+        HDANodeInfo &info = node_infos[state];
+        if (info.status == HDANodeInfo::CLOSED) {
+            // Stale entry of a node that was reached again with a lower g.
+            continue;
+        }
+
+        int f = info.g + info.h;
+        if (f >= search.incumbent_cost.load(memory_order_relaxed)) {
+            /*
+              Since the open list is ordered by f, none of the remaining
+              nodes can lead to a cheaper plan.
+            */
+            open_list->clear();
+            return false;
+        }
+
+        info.status = HDANodeInfo::CLOSED;
+        statistics.inc_expanded();
+        if (task_properties::is_goal_state(search.task_proxy, state)) {
+            search.update_incumbent(info.g, id, state_id);
+        } else {
+            generate_successors(state, info);
+        }
+        return true;
+    }
+    return false;
+}
+
+void HDAWorker::receive_messages() {
+    if (inbox.empty()) {
+        return;
+    }
+    inbox.pop_all(received_batches);
+    for (const MessageBatch &batch : received_batches) {
+        for (size_t i = 0; i < batch.successors.size(); ++i) {
+            insert_node(&batch.state_data[i * num_bins], batch.successors[i]);
+        }
+        num_received_states += batch.successors.size();
+        search.num_messages_in_flight.fetch_sub(1);
+    }
+    received_batches.clear();
+}
+
+void HDAWorker::flush_outboxes() {
+    for (int owner = 0; owner < search.num_threads; ++owner) {
+        MessageBatch &outbox = outboxes[owner];
+        if (!outbox.empty()) {
+            num_sent_states += outbox.successors.size();
+            // Count the message as in flight before the receiver can see it.
+            search.num_messages_in_flight.fetch_add(1);
+            search.workers[owner]->inbox.push(move(outbox));
+            outbox = MessageBatch();
+        }
+    }
+}
+
+void HDAWorker::run() {
+    while (!search.terminated.load(memory_order_relaxed)) {
+        receive_messages();
+        bool expanded = expand_next_node();
+        flush_outboxes();
+        if (!expanded && !search.wait_for_work(*this)) {
+            break;
+        }
+    }
+}
+
+void HDAWorker::print_statistics(utils::LogProxy &log) const {
+    log << "Thread " << id << ": expanded " << statistics.get_expanded()
+        << " state(s), registered " << state_registry.size()
+        << " state(s), sent " << num_sent_states << " state(s), received "
+        << num_received_states << " state(s)." << endl;
+}
+
+HDASearch::HDASearch(
+    const parser::LazyValue &eval, int threads, OperatorCost cost_type,
+    int bound, double max_time, const string &description,
+    utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      eval_config(eval),
+      num_threads(threads),
+      incumbent_cost(numeric_limits<int>::max()),
+      incumbent_owner(-1),
+      incumbent_goal_id(StateID::no_state),
+      terminated(false),
+      num_messages_in_flight(0),
+      num_idle_workers(0) {
+}
+
+HDASearch::~HDASearch() {
+}
+
+void HDASearch::initialize() {
+    log << "Conducting hash-distributed A* search with " << num_threads
+        << " thread(s), (real) bound = " << bound << endl;
+    /*
+      All registries share the axiom evaluator of the task, which is not
+      thread-safe. Successors are also computed directly on packed data.
+    */
+    task_properties::verify_no_axioms(task_proxy);
+
+    set<Evaluator *> heuristics;
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        shared_ptr<Evaluator> heuristic;
+        try {
+            heuristic = eval_config.construct<shared_ptr<Evaluator>>();
+        } catch (const utils::ContextError &e) {
+            cerr << "Delayed construction of LazyValue failed" << endl;
+            cerr << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        if (!heuristics.insert(heuristic.get()).second) {
+            cerr << "hdastar needs a separate evaluator for each thread. "
+                 << "Do not bind its evaluator to a variable with let."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        set<Evaluator *> path_dependent_evaluators;
+        heuristic->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "hdastar does not support path-dependent evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        workers.push_back(make_unique<HDAWorker>(*this, i, heuristic));
+    }
+
+    const State &initial_state = state_registry.get_initial_state();
+    workers[get_owner(initial_state.get_buffer())]->insert_initial_state(
+        initial_state);
+}
+
+int HDASearch::get_owner(const PackedStateBin *buffer) const {
+    utils::HashState hash_state;
+    int num_bins = state_registry.get_state_packer().get_num_bins();
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    /*
+      The registries place states in their hash sets based on a Zobrist hash
+      of the bins (see state_registry.cc), which is unrelated to this hash.
+      Owners and hash set positions are therefore distributed independently,
+      and all states of a worker do not end up in a few hash set buckets.
+    */
+    return static_cast<int>((hash_state.get_hash64() >> 32) % num_threads);
+}
+
+void HDASearch::update_incumbent(int cost, int owner, StateID goal_id) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (cost < incumbent_cost.load(memory_order_relaxed)) {
+        incumbent_cost.store(cost, memory_order_relaxed);
+        incumbent_owner = owner;
+        incumbent_goal_id = goal_id;
+        log << "Thread " << owner << " found a solution with cost " << cost
+            << "." << endl;
+    }
+}
+
+void HDASearch::terminate() {
+    {
+        lock_guard<mutex> lock(idle_mutex);
+        terminated = true;
+    }
+    idle_cv.notify_all();
+}
+
+bool HDASearch::wait_for_work(const HDAWorker &worker) {
+    unique_lock<mutex> lock(idle_mutex);
+    ++num_idle_workers;
+    while (!terminated) {
+        if (worker.has_messages()) {
+            --num_idle_workers;
+            return true;
+        }
+        if (num_idle_workers == num_threads && num_messages_in_flight == 0) {
+            terminated = true;
+            idle_cv.notify_all();
+            return false;
+        }
+        /*
+          Senders do not notify idle workers, so we poll the inbox. The
+          timeout keeps the latency low without busy waiting.
+        */
+        idle_cv.wait_for(lock, chrono::milliseconds(1));
+    }
+    return false;
+}
+
+Plan HDASearch::trace_plan() const {
+    Plan plan;
+    int owner = incumbent_owner;
+    StateID state_id = incumbent_goal_id;
+    while (true) {
+        const HDANodeInfo &info = workers[owner]->get_node_info(state_id);
+        if (info.creating_operator_id == OperatorID::no_operator) {
+            break;
+        }
+        plan.push_back(info.creating_operator_id);
+        owner = info.parent_owner;
+        state_id = info.parent_state_id;
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void HDASearch::aggregate_statistics() {
+    for (const unique_ptr<HDAWorker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->get_statistics();
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(
+            worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+}
+
+SearchStatus HDASearch::step() {
+    /*
+      Note that the timer measures the CPU time of the whole process, i.e.,
+      the time used by all threads together.
+    */
+    utils::CountdownTimer timer(max_time);
+    bool timed_out = false;
+    bool out_of_memory = false;
+
+    vector<exception_ptr> errors(num_threads);
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this, i, &errors]() {
+            try {
+                workers[i]->run();
+            } catch (...) {
+                errors[i] = current_exception();
+                terminate();
+            }
+        });
+    }
+    {
+        unique_lock<mutex> lock(idle_mutex);
+        while (!terminated) {
+            idle_cv.wait_for(lock, chrono::milliseconds(10));
+            if (!terminated && timer.is_expired()) {
+                timed_out = true;
+                terminated = true;
+            }
+            /*
+              The threads do not return to search() before they terminate,
+              so we check the memory budget here. Memory pressure hooks must
+              not run while the threads use the evaluators and open lists.
+            */
+            if (!terminated && utils::memory_budget_is_exhausted()) {
+                out_of_memory = true;
+                terminated = true;
+            }
+        }
+    }
+    idle_cv.notify_all();
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+    for (const exception_ptr &error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    aggregate_statistics();
+
+    /*
+      Before termination, a plan is not guaranteed to be optimal because
+      other workers might still find a cheaper one.
+    */
+    if (timed_out) {
+        return TIMEOUT;
+    }
+    if (out_of_memory) {
+        utils::fire_remaining_memory_pressure_stages();
+        log << "Memory budget exhausted. Abort search." << endl;
+        return OUT_OF_MEMORY;
+    }
+    if (incumbent_goal_id != StateID::no_state) {
+        set_plan(trace_plan());
+        return SOLVED;
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void HDASearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    int num_registered_states = 0;
+    for (const unique_ptr<HDAWorker> &worker : workers) {
+        worker->print_statistics(log);
+        num_registered_states += worker->get_num_registered_states();
+    }
+    log << "Number of registered states: " << num_registered_states << endl;
+}
+
+class HDASearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, HDASearch> {
+public:
+    HDASearchFeature() : TypedFeature("hdastar") {
+        document_title("Hash-distributed A* search");
+        document_synopsis(
+            "A parallel version of A* that assigns every state to a thread "
+            "based on a hash of the state (Kishimoto, Fukunaga and Botea, "
+            "ICAPS 2009). Each thread runs A* on its states and sends the "
+            "successors it generates to their owners. We break ties using "
+            "the evaluator. Closed nodes are re-opened.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value. It is constructed once for each thread.",
+            "", plugins::Bounds::unlimited(), true);
+        add_option<int>(
+            "threads", "number of search threads", "2",
+            plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "hdastar");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "not supported");
+
+        document_property("admissible", "yes if the evaluator is admissible");
+        document_property("consistent", "yes if the evaluator is consistent");
+        document_property("safe", "yes if the evaluator is safe");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Evaluators",
+            "Each thread uses its own instance of the evaluator, so the "
+            "evaluator must not be bound to a variable with let. "
+            "Path-dependent evaluators are not supported.");
+        document_note(
+            "Time limit",
+            "max_time and the CPU time limit of the driver refer to the CPU "
+            "time of the whole process, which is the sum over all threads.");
+        document_note(
+            "Memory budget",
+            "If the memory budget (--memory-budget) is exhausted, the search "
+            "stops, but the earlier stages that drop caches and compact open "
+            "lists only take effect once the threads have stopped.");
+    }
+
+    virtual shared_ptr<HDASearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<HDASearch>(
+            opts.get<parser::LazyValue>("eval"), opts.get<int>("threads"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<HDASearchFeature> _plugin;
+}
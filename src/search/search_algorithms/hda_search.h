@@ -0,0 +1,79 @@
+#ifndef SEARCH_ALGORITHMS_HDA_SEARCH_H
+#define SEARCH_ALGORITHMS_HDA_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace hda_search {
+class HDAWorker;
+
+/*
+  Hash-distributed A* (Kishimoto, Fukunaga and Botea, ICAPS 2009).
+
+  Every state has a unique owner thread determined by a hash of its packed
+  data. Each worker runs A* on the states it owns: it keeps its own state
+  registry, search space, open list and evaluator, and sends successors that
+  belong to another worker to that worker's inbox in batches. Workers never
+  share mutable data apart from the inboxes, the incumbent plan cost and the
+  termination detection below.
+
+  A goal state is only accepted when it is expanded, so the cost of every
+  accepted plan is optimal for the part of the search space explored so far.
+  The search terminates once all workers are idle (their open lists contain
+  no node that could lead to a cheaper plan) and no message is in flight.
+*/
+class HDASearch : public SearchAlgorithm {
+    friend class HDAWorker;
+
+    const parser::LazyValue eval_config;
+    const int num_threads;
+    std::vector<std::unique_ptr<HDAWorker>> workers;
+
+    // Best plan found so far, in terms of adjusted operator costs.
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    int incumbent_owner;
+    StateID incumbent_goal_id;
+
+    /*
+      Termination detection: a worker without work increments
+      num_idle_workers. Messages count as in flight from before they are sent
+      until their receiver has processed them, so if all workers are idle and
+      no message is in flight, no worker can get new work.
+    */
+    std::atomic<bool> terminated;
+    std::atomic<int> num_messages_in_flight;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    int num_idle_workers;
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void update_incumbent(int cost, int owner, StateID goal_id);
+    void terminate();
+    bool wait_for_work(const HDAWorker &worker);
+    Plan trace_plan() const;
+    void aggregate_statistics();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDASearch(
+        const parser::LazyValue &eval, int threads, OperatorCost cost_type,
+        int bound, double max_time, const std::string &description,
+        utils::Verbosity verbosity);
+    virtual ~HDASearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,296 @@
+#include "idastar_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../algorithms/int_packer.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace idastar_search {
+static const int INF = numeric_limits<int>::max();
+
+TranspositionTable::TranspositionTable(int max_entries) : mask(0) {
+    if (max_entries > 0) {
+        size_t num_entries = 1;
+        while (2 * num_entries <= static_cast<size_t>(max_entries)) {
+            num_entries *= 2;
+        }
+        entries.assign(num_entries, {EMPTY_KEY, 0, 0, 0});
+        mask = num_entries - 1;
+    }
+}
+
+IDAStarSearch::IDAStarSearch(
+    const shared_ptr<Evaluator> &eval, int transposition_table_size,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      evaluator(eval),
+      transposition_table(transposition_table_size),
+      depth(0),
+      f_bound(0),
+      next_f_bound(INF),
+      num_iterations(0),
+      max_depth(0),
+      num_transposition_table_hits(0) {
+}
+
+void IDAStarSearch::initialize() {
+    log << "Conducting iterative-deepening A* search, (real) bound = "
+        << bound << endl;
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "idastar does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (!transposition_table.empty()) {
+        log << "Transposition table size: "
+            << transposition_table.get_size_in_bytes() << " bytes" << endl;
+    }
+    packed_buffer.resize(state_registry.get_state_packer().get_num_bins());
+
+    const State &initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        log << "Initial state is a dead end." << endl;
+        f_bound = INF;
+    } else {
+        f_bound = eval_context.get_evaluator_value(evaluator.get());
+    }
+}
+
+uint64_t IDAStarSearch::compute_key(const State &state) {
+    state.unpack();
+    state_registry.get_state_packer().pack_all(
+        state.get_unpacked_values().data(), packed_buffer.data());
+    uint64_t key = utils::get_hash64(packed_buffer);
+    // The transposition table uses 0 for empty entries.
+    return key == 0 ? 1 : key;
+}
+
+int IDAStarSearch::compute_h(const State &state, uint64_t key, int g) {
+    const TranspositionTable::Entry *entry = transposition_table.lookup(key);
+    if (entry) {
+        ++num_transposition_table_hits;
+        return entry->h;
+    }
+    EvaluationContext eval_context(state, g, false, &statistics);
+    statistics.inc_evaluated_states();
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        return INF;
+    }
+    return eval_context.get_evaluator_value(evaluator.get());
+}
+
+bool IDAStarSearch::visit(
+    const State &state, uint64_t key, int g, int real_g, int h,
+    OperatorID creating_operator) {
+    if (depth == static_cast<int>(frames.size())) {
+        frames.push_back(
+            {state, key, g, real_g, h, INF, creating_operator, {}, 0});
+    } else {
+        SearchFrame &frame = frames[depth];
+        frame.state = state;
+        frame.key = key;
+        frame.g = g;
+        frame.real_g = real_g;
+        frame.h = h;
+        frame.min_f = INF;
+        frame.creating_operator = creating_operator;
+        frame.next_operator = 0;
+    }
+    SearchFrame &frame = frames[depth];
+    ++depth;
+    max_depth = max(max_depth, depth);
+    path_keys.insert(key);
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        return true;
+    }
+    statistics.inc_expanded();
+    frame.applicable_operators.clear();
+    successor_generator.generate_applicable_ops(
+        state, frame.applicable_operators);
+    return false;
+}
+
+/*
+  Store the lower bound on the goal distance of the state on top of the
+  stack and remove it from the stack.
+*/
+void IDAStarSearch::backtrack() {
+    assert(depth > 0);
+    const SearchFrame &frame = frames[depth - 1];
+    int h = frame.min_f == INF ? INF : max(frame.h, frame.min_f - frame.g);
+    transposition_table.store(frame.key, h, frame.g, num_iterations);
+    path_keys.erase(frame.key);
+    --depth;
+    if (depth > 0 && h != INF) {
+        SearchFrame &parent = frames[depth - 1];
+        parent.min_f = min(parent.min_f, frame.g + h);
+    }
+}
+
+void IDAStarSearch::extract_plan() {
+    log << "Solution found!" << endl;
+    Plan plan;
+    for (int i = 1; i < depth; ++i) {
+        plan.push_back(frames[i].creating_operator);
+    }
+    set_plan(plan);
+}
+
+SearchStatus IDAStarSearch::step() {
+    if (depth == 0) {
+        if (f_bound == INF) {
+            log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        ++num_iterations;
+        log << "f bound: " << f_bound << " [expanded "
+            << statistics.get_expanded() << " state(s)]" << endl;
+        statistics.report_f_value_progress(f_bound);
+        next_f_bound = INF;
+        const State &initial_state = state_registry.get_initial_state();
+        uint64_t key = compute_key(initial_state);
+        int h = compute_h(initial_state, key, 0);
+        if (h > f_bound) {
+            f_bound = h;
+        } else if (visit(initial_state, key, 0, 0, h, OperatorID::no_operator)) {
+            extract_plan();
+            return SOLVED;
+        }
+        return IN_PROGRESS;
+    }
+
+    SearchFrame &frame = frames[depth - 1];
+    if (frame.next_operator == frame.applicable_operators.size()) {
+        backtrack();
+        if (depth == 0) {
+            f_bound = next_f_bound;
+        }
+        return IN_PROGRESS;
+    }
+
+    OperatorID op_id = frame.applicable_operators[frame.next_operator++];
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    int succ_g = frame.g + get_adjusted_cost(op);
+    if (frame.real_g + op.get_cost() >= bound) {
+        // We know nothing about the successor, so its bound is 0.
+        frame.min_f = min(frame.min_f, succ_g);
+        return IN_PROGRESS;
+    }
+
+    State succ_state = frame.state.get_unregistered_successor(op);
+    statistics.inc_generated();
+    uint64_t succ_key = compute_key(succ_state);
+    if (path_keys.contains(succ_key)) {
+        // Cycle: we only know that the goal distance is non-negative.
+        frame.min_f = min(frame.min_f, succ_g);
+        return IN_PROGRESS;
+    }
+
+    const TranspositionTable::Entry *entry =
+        transposition_table.lookup(succ_key);
+    if (entry && entry->iteration == num_iterations && entry->g <= succ_g) {
+        ++num_transposition_table_hits;
+        if (entry->h != INF) {
+            frame.min_f = min(frame.min_f, succ_g + entry->h);
+        }
+        return IN_PROGRESS;
+    }
+    int succ_h = compute_h(succ_state, succ_key, succ_g);
+    if (succ_h == INF) {
+        return IN_PROGRESS;
+    }
+    int succ_f = succ_g + succ_h;
+    if (succ_f > f_bound) {
+        frame.min_f = min(frame.min_f, succ_f);
+        next_f_bound = min(next_f_bound, succ_f);
+        return IN_PROGRESS;
+    }
+    if (visit(
+            succ_state, succ_key, succ_g, frame.real_g + op.get_cost(), succ_h,
+            op_id)) {
+        extract_plan();
+        return SOLVED;
+    }
+    return IN_PROGRESS;
+}
+
+void IDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "f bound iterations: " << num_iterations << endl;
+    log << "Maximum search depth: " << max_depth << endl;
+    log << "Transposition table hits: " << num_transposition_table_hits
+        << endl;
+}
+
+class IDAStarSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, IDAStarSearch> {
+public:
+    IDAStarSearchFeature() : TypedFeature("idastar") {
+        document_title("Iterative-deepening A*");
+        document_synopsis(
+            "Iterative-deepening A* (Korf, AIJ 1985) with a transposition "
+            "table (Reinefeld and Marsland, TPAMI 1994). Iterated "
+            "depth-first searches that prune states whose f-value exceeds a "
+            "bound, starting with the h-value of the initial state and "
+            "increasing it to the smallest pruned f-value after each "
+            "iteration. States are not stored in a state registry, so the "
+            "memory usage is bounded by the size of the transposition table "
+            "and the current path. This makes it possible to search "
+            "optimally in tasks where A* runs out of memory, at the cost of "
+            "re-expanding states.");
+
+        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<int>(
+            "transposition_table_size",
+            "maximum number of entries of the transposition table, which "
+            "stores lower bounds on the goal distances of expanded states to "
+            "prune repeated visits (rounded down to a power of two; 24 bytes "
+            "per entry). Use 0 to disable the transposition table.",
+            "1048576", plugins::Bounds("0", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "idastar");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "supported");
+
+        document_property("admissible", "yes if the evaluator is admissible");
+        document_property("consistent", "no");
+        document_property("safe", "yes if the evaluator is safe");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Breadth-first iterative deepening",
+            "For tasks with unit costs, bfhs() is a breadth-first variant of "
+            "iterative-deepening A* that detects all duplicates within a few "
+            "layers and needs memory proportional to the size of the "
+            "largest layers.");
+    }
+
+    virtual shared_ptr<IDAStarSearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<IDAStarSearch>(
+            opts.get<shared_ptr<Evaluator>>("eval"),
+            opts.get<int>("transposition_table_size"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<IDAStarSearchFeature> _plugin;
+}
@@ -0,0 +1,142 @@
+#ifndef SEARCH_ALGORITHMS_IDASTAR_SEARCH_H
+#define SEARCH_ALGORITHMS_IDASTAR_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../utils/hash.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace idastar_search {
+/*
+  Table with a fixed number of entries that stores information about
+  expanded states. Each state has a single slot, and storing a state
+  overwrites the previous entry of its slot. States are identified by a
+  64-bit hash of their packed values, like with hash compaction in the state
+  registry: a hash collision could lead to a wrong bound, but this is very
+  unlikely.
+*/
+class TranspositionTable {
+public:
+    struct Entry {
+        std::uint64_t key;
+        // Lower bound on the goal distance of the state.
+        int h;
+        // g-value and iteration of the last expansion of the state.
+        int g;
+        int iteration;
+    };
+
+private:
+    static const std::uint64_t EMPTY_KEY = 0;
+
+    std::vector<Entry> entries;
+    std::uint64_t mask;
+
+public:
+    // The number of entries is rounded down to a power of two.
+    explicit TranspositionTable(int max_entries);
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    // Return the entry of the given state or nullptr if there is none.
+    const Entry *lookup(std::uint64_t key) const {
+        if (entries.empty()) {
+            return nullptr;
+        }
+        const Entry &entry = entries[key & mask];
+        return entry.key == key ? &entry : nullptr;
+    }
+
+    void store(std::uint64_t key, int h, int g, int iteration) {
+        if (!entries.empty()) {
+            entries[key & mask] = {key, h, g, iteration};
+        }
+    }
+
+    int get_size_in_bytes() const {
+        return entries.size() * sizeof(Entry);
+    }
+};
+
+/*
+  Iterative-deepening A* (Korf, AIJ 1985) with a transposition table
+  (Reinefeld and Marsland, TPAMI 1994).
+
+  Each iteration is a depth-first search that prunes all states whose
+  f-value exceeds the bound of the iteration. The first iteration uses the
+  h-value of the initial state as bound and each further iteration uses the
+  smallest f-value pruned in the previous one.
+
+  States are not registered: the search works on unregistered states and
+  only stores the current path, so its memory usage does not grow over time.
+  States on the current path are not expanded again (cycle detection). The
+  transposition table stores for each expanded state a lower bound on its
+  goal distance: the minimum over its successors of the operator cost plus
+  the bound of the successor (its h-value if it was pruned, its backed-up
+  bound if it was expanded). A state that is reached again in the same
+  iteration with a g-value that is at least as high as when it was expanded
+  is pruned, since its successors have already been searched with a larger
+  remaining budget. In later iterations, the stored bound replaces the
+  h-value of the state.
+*/
+class IDAStarSearch : public SearchAlgorithm {
+    struct SearchFrame {
+        State state;
+        std::uint64_t key;
+        int g;
+        int real_g;
+        int h;
+        // Lower bound on the cost of a plan via this state.
+        int min_f;
+        OperatorID creating_operator;
+        std::vector<OperatorID> applicable_operators;
+        std::size_t next_operator;
+    };
+
+    const std::shared_ptr<Evaluator> evaluator;
+
+    TranspositionTable transposition_table;
+    // Frames of the current path; frames beyond depth are kept for reuse.
+    std::vector<SearchFrame> frames;
+    int depth;
+    utils::HashSet<std::uint64_t> path_keys;
+    std::vector<PackedStateBin> packed_buffer;
+
+    int f_bound;
+    int next_f_bound;
+
+    int num_iterations;
+    int max_depth;
+    int num_transposition_table_hits;
+
+    std::uint64_t compute_key(const State &state);
+    int compute_h(const State &state, std::uint64_t key, int g);
+    // Return true if the state is a goal state.
+    bool visit(
+        const State &state, std::uint64_t key, int g, int real_g, int h,
+        OperatorID creating_operator);
+    void backtrack();
+    void extract_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    IDAStarSearch(
+        const std::shared_ptr<Evaluator> &eval, int transposition_table_size,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "../utils/logging.h"
 
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -16,11 +17,21 @@ IteratedSearch::IteratedSearch(const plugins::Options &opts)
       repeat_last_phase(opts.get<bool>("repeat_last")),
       continue_on_fail(opts.get<bool>("continue_on_fail")),
       continue_on_solve(opts.get<bool>("continue_on_solve")),
+      share_state_registry(opts.get<bool>("share_state_registry")),
       phase(0),
       last_phase_found_solution(false),
       best_bound(bound),
       iterated_found_solution(false) {
     utils::verify_list_not_empty(algorithm_configs, "algorithm_configs");
+    if (share_state_registry && state_registry.uses_hash_compaction()) {
+        /*
+          Phases release the data of states they do not need anymore, but
+          later phases may still need it.
+        */
+        log << "Warning: phases cannot share the state registry with "
+            << "hash compaction." << endl;
+        share_state_registry = false;
+    }
 }
 
 shared_ptr<SearchAlgorithm> IteratedSearch::get_search_algorithm(
@@ -28,6 +39,11 @@ shared_ptr<SearchAlgorithm> IteratedSearch::get_search_algorithm(
     parser::LazyValue &algorithm_config =
         algorithm_configs[algorithm_configs_index];
     shared_ptr<SearchAlgorithm> search_algorithm;
+    unique_ptr<SharedStateRegistryScope> registry_scope;
+    if (share_state_registry) {
+        registry_scope =
+            make_unique<SharedStateRegistryScope>(shared_state_registry);
+    }
     try {
         search_algorithm =
             algorithm_config.construct<shared_ptr<SearchAlgorithm>>();
@@ -155,14 +171,25 @@ public:
         add_option<bool>(
             "continue_on_solve", "continue search after solution found",
             "true");
+        add_option<bool>(
+            "share_state_registry",
+            "let all phases use the same state registry instead of "
+            "registering the states from scratch in each phase. Evaluators "
+            "that are shared between the phases (see Note 2) then keep "
+            "their per-state information, e.g., cached heuristic values and "
+            "the landmarks reached on the paths of earlier phases. Together "
+            "with phases that restart from the initial state, this yields "
+            "restarting weighted A* (Richter et al., ICAPS 2010). Ignored "
+            "with --hash-compaction.",
+            "false");
         add_search_algorithm_options_to_feature(*this, "iterated");
 
         document_note(
             "Note 1",
-            "We don't cache heuristic values between search iterations at"
-            " the moment. If you perform a LAMA-style iterative search,"
-            " heuristic values and other per-state information will be computed"
-            " multiple times.");
+            "Unless share_state_registry=true, we don't cache heuristic"
+            " values between search iterations. If you perform a LAMA-style"
+            " iterative search, heuristic values and other per-state"
+            " information will then be computed multiple times.");
         document_note(
             "Note 2",
             "The configuration\n```\n"
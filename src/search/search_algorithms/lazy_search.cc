@@ -7,6 +7,7 @@
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/profiler.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
@@ -25,6 +26,10 @@ LazySearch::LazySearch(
     utils::Verbosity verbosity)
     : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
       open_list(open->create_edge_open_list()),
+      compact_open_list_hook(
+          utils::MemoryPressureStage::COMPACT_DATA_STRUCTURES,
+          "compact open list of " + description,
+          [this]() { open_list->compact(); }),
       reopen_closed_nodes(reopen_closed),
       randomize_successors(randomize_successors),
       preferred_successors_first(preferred_successors_first),
@@ -125,7 +130,11 @@ SearchStatus LazySearch::fetch_next_state() {
         return FAILED;
     }
 
-    EdgeOpenListEntry next = open_list->remove_min();
+    EdgeOpenListEntry next(StateID::no_state, OperatorID::no_operator);
+    {
+        PROFILE_SCOPE(utils::ProfilerComponent::OPEN_LIST);
+        next = open_list->remove_min();
+    }
 
     current_predecessor_id = next.first;
     current_operator_id = next.second;
@@ -230,6 +239,10 @@ void LazySearch::reward_progress() {
     open_list->boost_preferred();
 }
 
+int LazySearch::get_open_list_size() const {
+    return open_list->get_num_entries();
+}
+
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
@@ -9,6 +9,7 @@
 #include "../search_progress.h"
 #include "../search_space.h"
 
+#include "../utils/memory.h"
 #include "../utils/rng.h"
 
 #include <memory>
@@ -20,6 +21,7 @@ namespace lazy_search {
 class LazySearch : public SearchAlgorithm {
 protected:
     std::unique_ptr<EdgeOpenList> open_list;
+    utils::MemoryPressureHook compact_open_list_hook;
 
     // Search behavior parameters
     bool reopen_closed_nodes; // whether to reopen closed nodes upon finding
@@ -40,6 +42,7 @@ protected:
 
     virtual void initialize() override;
     virtual SearchStatus step() override;
+    virtual int get_open_list_size() const override;
 
     void generate_successors();
     SearchStatus fetch_next_state();
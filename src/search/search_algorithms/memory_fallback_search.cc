@@ -0,0 +1,137 @@
+#include "memory_fallback_search.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/component_errors.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace memory_fallback_search {
+MemoryFallbackSearch::MemoryFallbackSearch(
+    const parser::LazyValue &search, const parser::LazyValue &fallback,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      search_config(search),
+      fallback_config(fallback) {
+}
+
+void MemoryFallbackSearch::initialize() {
+    if (!utils::has_memory_budget()) {
+        log << "Warning: memory_fallback() only switches to the fallback "
+            << "search if a memory budget is set (--memory-budget)." << endl;
+    }
+}
+
+shared_ptr<SearchAlgorithm> MemoryFallbackSearch::create_search_algorithm(
+    const parser::LazyValue &config) {
+    shared_ptr<SearchAlgorithm> search_algorithm;
+    try {
+        search_algorithm = config.construct<shared_ptr<SearchAlgorithm>>();
+    } catch (const utils::ContextError &e) {
+        cerr << "Delayed construction of LazyValue failed" << endl;
+        cerr << e.get_message() << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (bound < search_algorithm->get_bound()) {
+        search_algorithm->set_bound(bound);
+    }
+    log << "Starting search: " << search_algorithm->get_description() << endl;
+    return search_algorithm;
+}
+
+SearchStatus MemoryFallbackSearch::run(SearchAlgorithm &search_algorithm) {
+    search_algorithm.search();
+    search_algorithm.print_statistics();
+
+    const SearchStatistics &current_stats = search_algorithm.get_statistics();
+    statistics.inc_expanded(current_stats.get_expanded());
+    statistics.inc_evaluated_states(current_stats.get_evaluated_states());
+    statistics.inc_evaluations(current_stats.get_evaluations());
+    statistics.inc_generated(current_stats.get_generated());
+    statistics.inc_generated_ops(current_stats.get_generated_ops());
+    statistics.inc_reopened(current_stats.get_reopened());
+
+    if (search_algorithm.found_solution()) {
+        set_plan(search_algorithm.get_plan());
+        return SOLVED;
+    }
+    return search_algorithm.get_status();
+}
+
+SearchStatus MemoryFallbackSearch::step() {
+    SearchStatus status = run(*create_search_algorithm(search_config));
+    if (status != OUT_OF_MEMORY) {
+        return status == SOLVED ? SOLVED : FAILED;
+    }
+    /*
+      The first search algorithm has been destroyed at this point, so its
+      memory is available for the fallback.
+    */
+    log << "Switching to fallback search." << endl;
+    status = run(*create_search_algorithm(fallback_config));
+    return status == SOLVED ? SOLVED : FAILED;
+}
+
+void MemoryFallbackSearch::print_statistics() const {
+    log << "Cumulative statistics:" << endl;
+    statistics.print_detailed_statistics();
+}
+
+class MemoryFallbackSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, MemoryFallbackSearch> {
+public:
+    MemoryFallbackSearchFeature() : TypedFeature("memory_fallback") {
+        document_title("Memory fallback search");
+        document_synopsis(
+            "Runs a search algorithm until it finishes or the memory budget "
+            "set with --memory-budget is exhausted. In the latter case, the "
+            "search algorithm is destroyed, which releases its memory, and "
+            "the fallback search algorithm starts from scratch. Use a search "
+            "algorithm with bounded memory usage such as idastar() as "
+            "fallback, so that long-running jobs can still find a plan "
+            "instead of failing at the memory limit.");
+
+        add_option<shared_ptr<SearchAlgorithm>>(
+            "search", "search algorithm to run first", "",
+            plugins::Bounds::unlimited(), true);
+        add_option<shared_ptr<SearchAlgorithm>>(
+            "fallback",
+            "search algorithm to run if the first one exhausts the memory "
+            "budget",
+            "", plugins::Bounds::unlimited(), true);
+        add_search_algorithm_options_to_feature(*this, "memory_fallback");
+
+        document_note(
+            "Memory budget",
+            "Before the search is stopped, the planner tries to free memory "
+            "in other ways: it drops the caches of heuristics at 80% of the "
+            "budget (except for heuristics used as lazy_evaluator of eager "
+            "search, whose re-evaluation of states relies on the cache) and "
+            "compacts the open lists of eager and lazy search at "
+            "90% of the budget. The fallback search algorithm starts at 100% "
+            "of the budget, so the budget should leave room for it below the "
+            "memory limit of the planner.");
+        document_note(
+            "Sharing heuristics",
+            "Heuristics that are defined with let() outside of "
+            "memory_fallback() are shared by both search algorithms and only "
+            "computed once, for example:\n```\n"
+            "--memory-budget 3000 --search "
+            "\"let(h, pdb(), memory_fallback(astar(h), idastar(h)))\"\n```");
+    }
+
+    virtual shared_ptr<MemoryFallbackSearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<MemoryFallbackSearch>(
+            opts.get<parser::LazyValue>("search"),
+            opts.get<parser::LazyValue>("fallback"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<MemoryFallbackSearchFeature> _plugin;
+}
@@ -0,0 +1,41 @@
+#ifndef SEARCH_ALGORITHMS_MEMORY_FALLBACK_SEARCH_H
+#define SEARCH_ALGORITHMS_MEMORY_FALLBACK_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <memory>
+
+namespace memory_fallback_search {
+/*
+  Run a search algorithm and, if it stops because the memory budget is
+  exhausted (see utils/memory.h), destroy it and continue with a fallback
+  search algorithm. The fallback should have bounded memory usage, e.g.,
+  idastar(). Both algorithms are constructed lazily, so the fallback only
+  allocates memory once the first search has released its memory.
+*/
+class MemoryFallbackSearch : public SearchAlgorithm {
+    parser::LazyValue search_config;
+    parser::LazyValue fallback_config;
+
+    std::shared_ptr<SearchAlgorithm> create_search_algorithm(
+        const parser::LazyValue &config);
+    // Run the given search algorithm and return its final status.
+    SearchStatus run(SearchAlgorithm &search_algorithm);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    MemoryFallbackSearch(
+        const parser::LazyValue &search, const parser::LazyValue &fallback,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
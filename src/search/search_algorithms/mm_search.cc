@@ -0,0 +1,520 @@
+#include "mm_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+#include <tuple>
+
+using namespace std;
+
+namespace mm_search {
+static const int INF = numeric_limits<int>::max();
+static const int UNDEFINED = -1;
+
+StateMatchTree::StateMatchTree(const TaskProxy &task_proxy)
+    : nodes({{INF, -1, {}}}) {
+    for (VariableProxy var : task_proxy.get_variables()) {
+        domain_sizes.push_back(var.get_domain_size());
+    }
+}
+
+void StateMatchTree::insert(const vector<int> &values, int entry, int g) {
+    int node_id = 0;
+    nodes[node_id].min_g = min(nodes[node_id].min_g, g);
+    for (size_t var = 0; var < domain_sizes.size(); ++var) {
+        if (nodes[node_id].children.empty()) {
+            nodes[node_id].children.assign(domain_sizes[var] + 1, -1);
+        }
+        int child_index = values[var] + 1;
+        int child_id = nodes[node_id].children[child_index];
+        if (child_id == -1) {
+            child_id = nodes.size();
+            nodes[node_id].children[child_index] = child_id;
+            nodes.push_back({INF, -1, {}});
+        }
+        node_id = child_id;
+        nodes[node_id].min_g = min(nodes[node_id].min_g, g);
+    }
+    assert(nodes[node_id].entry == -1 || nodes[node_id].entry == entry);
+    nodes[node_id].entry = entry;
+}
+
+void StateMatchTree::find_cheapest_consistent_recursive(
+    int node_id, int var, const vector<int> &values, int &g_limit,
+    int &best_entry) const {
+    const Node &node = nodes[node_id];
+    if (node.min_g >= g_limit) {
+        return;
+    }
+    if (var == static_cast<int>(domain_sizes.size())) {
+        best_entry = node.entry;
+        g_limit = node.min_g;
+        return;
+    }
+    const vector<int> &children = node.children;
+    if (values[var] == UNDEFINED) {
+        for (int child_id : children) {
+            if (child_id != -1) {
+                find_cheapest_consistent_recursive(
+                    child_id, var + 1, values, g_limit, best_entry);
+            }
+        }
+    } else {
+        for (int child_id : {children[0], children[values[var] + 1]}) {
+            if (child_id != -1) {
+                find_cheapest_consistent_recursive(
+                    child_id, var + 1, values, g_limit, best_entry);
+            }
+        }
+    }
+}
+
+int StateMatchTree::find_cheapest_consistent(
+    const vector<int> &values, int &g_limit) const {
+    int best_entry = -1;
+    find_cheapest_consistent_recursive(0, 0, values, g_limit, best_entry);
+    return best_entry;
+}
+
+void MMSearch::Frontier::insert(int node_id) {
+    const Node &node = nodes[node_id];
+    int f = node.g + node.h;
+    priority_queue.push({max(f, 2 * node.g), node.h, node_id, node.g});
+    f_queue.push({f, 0, node_id, node.g});
+    g_queue.push({node.g, 0, node_id, node.g});
+}
+
+bool MMSearch::Frontier::is_outdated(const OpenListEntry &entry) const {
+    const Node &node = nodes[entry.node_id];
+    return !node.is_open || node.g != entry.g;
+}
+
+int MMSearch::Frontier::get_min_key(OpenList &open_list) const {
+    while (!open_list.empty() && is_outdated(open_list.top())) {
+        open_list.pop();
+    }
+    return open_list.empty() ? INF : open_list.top().key;
+}
+
+MMSearch::MMSearch(
+    const shared_ptr<Evaluator> &eval, bool use_backward_heuristic,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      evaluator(eval),
+      use_backward_heuristic(use_backward_heuristic),
+      min_operator_cost(INF),
+      forward(task_proxy),
+      backward(task_proxy),
+      forward_node_ids(-1),
+      best_plan_cost(INF),
+      forward_meeting_node(-1),
+      backward_meeting_node(-1),
+      num_plan_improvements(0) {
+}
+
+void MMSearch::compute_initial_value_distances() {
+    VariablesProxy variables = task_proxy.get_variables();
+    State initial_state = task_proxy.get_initial_state();
+    // Transitions (source value, target value, cost) of each variable.
+    vector<vector<tuple<int, int, int>>> transitions(variables.size());
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int cost = get_adjusted_cost(op);
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            int source = UNDEFINED;
+            for (FactProxy pre : op.get_preconditions()) {
+                if (pre.get_variable().get_id() == fact.var) {
+                    source = pre.get_value();
+                }
+            }
+            transitions[fact.var].emplace_back(source, fact.value, cost);
+        }
+    }
+
+    initial_value_distances.resize(variables.size());
+    for (VariableProxy var : variables) {
+        int var_id = var.get_id();
+        vector<int> &distances = initial_value_distances[var_id];
+        distances.assign(var.get_domain_size(), INF);
+        distances[initial_state[var].get_value()] = 0;
+        // Bellman-Ford suffices for the small domains of the variables.
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto &[source, target, cost] : transitions[var_id]) {
+                int source_distance = (source == UNDEFINED)
+                    ? 0 : distances[source];
+                if (source_distance != INF &&
+                    source_distance + cost < distances[target]) {
+                    distances[target] = source_distance + cost;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+int MMSearch::compute_backward_heuristic(
+    const vector<int> &partial_state) const {
+    if (!use_backward_heuristic) {
+        return 0;
+    }
+    int h = 0;
+    for (size_t var = 0; var < partial_state.size(); ++var) {
+        if (partial_state[var] != UNDEFINED) {
+            h = max(h, initial_value_distances[var][partial_state[var]]);
+        }
+    }
+    return h;
+}
+
+bool MMSearch::regress(
+    const vector<int> &partial_state, const OperatorProxy &op,
+    vector<int> &result) const {
+    result = partial_state;
+    for (EffectProxy effect : op.get_effects()) {
+        FactPair fact = effect.get_fact().get_pair();
+        if (partial_state[fact.var] != UNDEFINED &&
+            partial_state[fact.var] != fact.value) {
+            return false;
+        }
+        result[fact.var] = UNDEFINED;
+    }
+    for (FactProxy pre : op.get_preconditions()) {
+        FactPair fact = pre.get_pair();
+        if (result[fact.var] != UNDEFINED && result[fact.var] != fact.value) {
+            return false;
+        }
+        result[fact.var] = fact.value;
+    }
+    return true;
+}
+
+void MMSearch::initialize() {
+    log << "Conducting bidirectional MM search, bound = " << bound
+        << endl;
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "mm does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    compute_initial_value_distances();
+    VariablesProxy variables = task_proxy.get_variables();
+    achievers.resize(variables.size());
+    for (VariableProxy var : variables) {
+        achievers[var.get_id()].resize(var.get_domain_size());
+    }
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        min_operator_cost = min(min_operator_cost, get_adjusted_cost(op));
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            achievers[fact.var][fact.value].push_back(op.get_id());
+        }
+    }
+    if (min_operator_cost == INF) {
+        min_operator_cost = 0;
+    }
+
+    /*
+      The plan costs refer to the adjusted costs, so the bound only limits
+      them if the adjusted costs are the real costs. Otherwise, we check the
+      real costs of the plans we find.
+    */
+    best_plan_cost = bound;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_cost(op) != op.get_cost()) {
+            best_plan_cost = INF;
+            break;
+        }
+    }
+    State initial_state = state_registry.get_initial_state();
+    generate_forward(initial_state, 0, 0, -1, OperatorID::no_operator);
+    vector<int> goal_state(variables.size(), UNDEFINED);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goal_state[goal.get_variable().get_id()] = goal.get_value();
+    }
+    generate_backward(move(goal_state), 0, 0, -1, OperatorID::no_operator);
+}
+
+void MMSearch::open_node(
+    Frontier &frontier, Frontier &other, int node_id, int g, int real_g,
+    int parent, OperatorID op_id, const vector<int> &values) {
+    Node &node = frontier.nodes[node_id];
+    if (!node.is_open && node.g != INF) {
+        statistics.inc_reopened();
+    }
+    node.g = g;
+    node.real_g = real_g;
+    node.parent = parent;
+    node.creating_operator = op_id;
+    // Nodes with f >= U cannot lead to a cheaper plan.
+    if (node.h >= best_plan_cost - g) {
+        node.is_open = false;
+        return;
+    }
+    node.is_open = true;
+    frontier.insert(node_id);
+    frontier.match_tree.insert(values, node_id, g);
+
+    int g_limit = best_plan_cost - g;
+    int other_node_id =
+        other.match_tree.find_cheapest_consistent(values, g_limit);
+    if (other_node_id != -1 &&
+        real_g < bound - other.nodes[other_node_id].real_g) {
+        best_plan_cost = g + g_limit;
+        ++num_plan_improvements;
+        bool is_forward = (&frontier == &forward);
+        forward_meeting_node = is_forward ? node_id : other_node_id;
+        backward_meeting_node = is_forward ? other_node_id : node_id;
+        log << "Found plan with cost " << best_plan_cost << endl;
+    }
+}
+
+void MMSearch::generate_forward(
+    const State &state, int g, int real_g, int parent, OperatorID op_id) {
+    int node_id = forward_node_ids[state];
+    if (node_id == -1) {
+        EvaluationContext eval_context(state, g, false, &statistics);
+        statistics.inc_evaluated_states();
+        int h = INF;
+        if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            statistics.inc_dead_ends();
+        } else {
+            h = eval_context.get_evaluator_value(evaluator.get());
+        }
+        if (parent == -1) {
+            print_initial_evaluator_values(eval_context);
+        }
+        node_id = forward.nodes.size();
+        forward_node_ids[state] = node_id;
+        forward.nodes.push_back(
+            {INF, INF, h, -1, OperatorID::no_operator, false});
+        forward_states.push_back(state.get_id());
+    }
+    const Node &node = forward.nodes[node_id];
+    if (node.h == INF || g >= node.g) {
+        return;
+    }
+    state.unpack();
+    open_node(
+        forward, backward, node_id, g, real_g, parent, op_id,
+        state.get_unpacked_values());
+}
+
+void MMSearch::generate_backward(
+    vector<int> &&partial_state, int g, int real_g, int parent,
+    OperatorID op_id) {
+    auto [it, inserted] =
+        backward_node_ids.try_emplace(partial_state, backward.nodes.size());
+    int node_id = it->second;
+    if (inserted) {
+        int h = compute_backward_heuristic(partial_state);
+        if (h == INF) {
+            statistics.inc_dead_ends();
+        }
+        backward.nodes.push_back(
+            {INF, INF, h, -1, OperatorID::no_operator, false});
+        backward_states.push_back(move(partial_state));
+    }
+    const Node &node = backward.nodes[node_id];
+    if (node.h == INF || g >= node.g) {
+        return;
+    }
+    open_node(
+        backward, forward, node_id, g, real_g, parent, op_id,
+        backward_states[node_id]);
+}
+
+void MMSearch::expand_forward(int node_id) {
+    Node &node = forward.nodes[node_id];
+    node.is_open = false;
+    int g = node.g;
+    int real_g = node.real_g;
+    ++forward.num_expansions;
+    statistics.inc_expanded();
+
+    State state = state_registry.lookup_state(forward_states[node_id]);
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated(applicable_ops.size());
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_real_g = real_g + op.get_cost();
+        if (succ_real_g >= bound)
+            continue;
+        State succ_state = state_registry.get_successor_state(state, op);
+        generate_forward(
+            succ_state, g + get_adjusted_cost(op), succ_real_g, node_id,
+            op_id);
+    }
+}
+
+void MMSearch::expand_backward(int node_id) {
+    Node &node = backward.nodes[node_id];
+    node.is_open = false;
+    int g = node.g;
+    int real_g = node.real_g;
+    ++backward.num_expansions;
+    statistics.inc_expanded();
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    // Copy the state because generating nodes invalidates references.
+    vector<int> partial_state = backward_states[node_id];
+    vector<int> relevant_ops;
+    for (size_t var = 0; var < partial_state.size(); ++var) {
+        if (partial_state[var] != UNDEFINED) {
+            const vector<int> &ops = achievers[var][partial_state[var]];
+            relevant_ops.insert(relevant_ops.end(), ops.begin(), ops.end());
+        }
+    }
+    utils::sort_unique(relevant_ops);
+    vector<int> predecessor;
+    for (int op_id : relevant_ops) {
+        OperatorProxy op = operators[op_id];
+        int pred_real_g = real_g + op.get_cost();
+        if (pred_real_g >= bound || !regress(partial_state, op, predecessor))
+            continue;
+        statistics.inc_generated();
+        generate_backward(
+            move(predecessor), g + get_adjusted_cost(op), pred_real_g,
+            node_id, OperatorID(op_id));
+    }
+}
+
+SearchStatus MMSearch::step() {
+    int forward_priority = forward.get_min_key(forward.priority_queue);
+    int backward_priority = backward.get_min_key(backward.priority_queue);
+    /*
+      Lower bound on the cost of plans that we have not found yet (Theorem 10
+      of the MM paper). If an open list is empty, the other direction has
+      already met all nodes of the exhausted direction.
+    */
+    int lower_bound = INF;
+    if (forward_priority != INF && backward_priority != INF) {
+        int forward_g = forward.get_min_key(forward.g_queue);
+        int backward_g = backward.get_min_key(backward.g_queue);
+        lower_bound = max(
+            {min(forward_priority, backward_priority),
+             forward.get_min_key(forward.f_queue),
+             backward.get_min_key(backward.f_queue),
+             forward_g + backward_g + min_operator_cost});
+        statistics.report_f_value_progress(lower_bound);
+    }
+    if (lower_bound >= best_plan_cost) {
+        if (forward_meeting_node == -1) {
+            log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        extract_plan();
+        return SOLVED;
+    }
+
+    if (forward_priority <= backward_priority) {
+        int node_id = forward.priority_queue.top().node_id;
+        forward.priority_queue.pop();
+        expand_forward(node_id);
+    } else {
+        int node_id = backward.priority_queue.top().node_id;
+        backward.priority_queue.pop();
+        expand_backward(node_id);
+    }
+    return IN_PROGRESS;
+}
+
+void MMSearch::extract_plan() {
+    Plan plan;
+    for (int node_id = forward_meeting_node;
+         forward.nodes[node_id].parent != -1;
+         node_id = forward.nodes[node_id].parent) {
+        plan.push_back(forward.nodes[node_id].creating_operator);
+    }
+    reverse(plan.begin(), plan.end());
+    for (int node_id = backward_meeting_node;
+         backward.nodes[node_id].parent != -1;
+         node_id = backward.nodes[node_id].parent) {
+        plan.push_back(backward.nodes[node_id].creating_operator);
+    }
+    set_plan(plan);
+}
+
+void MMSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Forward expansions: " << forward.num_expansions << endl;
+    log << "Backward expansions: " << backward.num_expansions << endl;
+    log << "Plan cost improvements: " << num_plan_improvements << endl;
+}
+
+class MMSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, MMSearch> {
+public:
+    MMSearchFeature() : TypedFeature("mm") {
+        document_title("Bidirectional MM search");
+        document_synopsis(
+            "Bidirectional heuristic search that meets in the middle (Holte, "
+            "Felner, Sharon, Sturtevant and Chen, AIJ 2017). The forward "
+            "direction searches from the initial state, guided by the given "
+            "evaluator. The backward direction regresses partial states from "
+            "the goal. Both directions expand nodes in order of the priority "
+            "max(f, 2g), so neither direction expands nodes beyond half of "
+            "the optimal plan cost unless its heuristic estimates exceed "
+            "this. The search stops once the best plan found is at least as "
+            "cheap as the lower bound given by the priorities, f-values and "
+            "g-values of both open lists.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval", "evaluator for h-value in the forward direction");
+        add_option<bool>(
+            "backward_heuristic",
+            "guide the backward direction by the maximum over all variables "
+            "of the cost of reaching the value of the variable in the partial "
+            "state from its initial value in the domain transition graph of "
+            "the variable (atomic projections computed from the initial "
+            "state). Otherwise, the backward direction is uninformed.",
+            "true");
+        add_search_algorithm_options_to_feature(*this, "mm");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "not supported");
+        document_language_support("axioms", "not supported");
+
+        document_property("admissible", "yes if the evaluator is admissible");
+        document_property("consistent", "no");
+        document_property("safe", "yes if the evaluator is safe");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Duplicate detection",
+            "The backward direction only detects duplicates of identical "
+            "partial states, not of partial states that subsume each other. "
+            "Finding the cheapest consistent nodes of the other direction "
+            "needs a search in a match tree, which is expensive for partial "
+            "states with many undefined variables.");
+    }
+
+    virtual shared_ptr<MMSearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<MMSearch>(
+            opts.get<shared_ptr<Evaluator>>("eval"),
+            opts.get<bool>("backward_heuristic"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<MMSearchFeature> _plugin;
+}
@@ -0,0 +1,179 @@
+#ifndef SEARCH_ALGORITHMS_MM_SEARCH_H
+#define SEARCH_ALGORITHMS_MM_SEARCH_H
+
+#include "../per_state_information.h"
+#include "../search_algorithm.h"
+
+#include "../utils/hash.h"
+
+#include <memory>
+#include <queue>
+#include <vector>
+
+class Evaluator;
+
+namespace mm_search {
+/*
+  Index of partial states (states in which variables may be undefined) that
+  finds, for a given partial state, the stored partial state with the
+  smallest g-value that is consistent with it, i.e., that assigns the same
+  value to each variable that both define. Like the match tree for abstract
+  operators (see pdbs::MatchTree), the tree branches on the variables in
+  order, with an extra branch for partial states that leave the variable
+  undefined. Each node stores the smallest g-value of the partial states
+  below it, which prunes the search for cheap consistent states.
+*/
+class StateMatchTree {
+    struct Node {
+        int min_g;
+        // Entry stored at a leaf, or -1 for inner nodes.
+        int entry;
+        // Child for undefined values, followed by the child for each value.
+        std::vector<int> children;
+    };
+
+    std::vector<int> domain_sizes;
+    std::vector<Node> nodes;
+
+    void find_cheapest_consistent_recursive(
+        int node_id, int var, const std::vector<int> &values, int &g_limit,
+        int &best_entry) const;
+public:
+    explicit StateMatchTree(const TaskProxy &task_proxy);
+
+    /*
+      Store the entry for the given partial state, or decrease its g-value
+      if the partial state is already stored.
+    */
+    void insert(const std::vector<int> &values, int entry, int g);
+    /*
+      Return the entry with the smallest g-value below g_limit that is
+      consistent with the given partial state and set g_limit to its
+      g-value, or return -1 if there is none.
+    */
+    int find_cheapest_consistent(
+        const std::vector<int> &values, int &g_limit) const;
+};
+
+/*
+  Bidirectional heuristic search with the MM algorithm (Holte, Felner,
+  Sharon, Sturtevant and Chen, AIJ 2017), which "meets in the middle". The
+  forward direction searches from the initial state in the state registry.
+  The backward direction searches from the goal by regression over partial
+  states.
+
+  Both directions store their nodes in the same way. Whenever a direction
+  generates a node with a new or cheaper g-value, we look up the cheapest
+  consistent node of the other direction in its match tree, which yields
+  the plan cost U of the best plan through both nodes.
+*/
+class MMSearch : public SearchAlgorithm {
+    struct Node {
+        int g;
+        // Cost of the path to the node with respect to the real costs.
+        int real_g;
+        int h;
+        int parent;
+        OperatorID creating_operator;
+        bool is_open;
+    };
+
+    struct OpenListEntry {
+        int key;
+        int tie_breaker;
+        int node_id;
+        int g;
+        bool operator>(const OpenListEntry &other) const {
+            return std::make_pair(key, tie_breaker) >
+                   std::make_pair(other.key, other.tie_breaker);
+        }
+    };
+
+    using OpenList = std::priority_queue<
+        OpenListEntry, std::vector<OpenListEntry>,
+        std::greater<OpenListEntry>>;
+
+    struct Frontier {
+        std::vector<Node> nodes;
+        StateMatchTree match_tree;
+        /*
+          The open lists order the open nodes by MM priority max(f, 2g)
+          (ties broken by h), by f and by g. They contain outdated entries
+          of closed nodes and previous g-values, which we skip lazily.
+        */
+        OpenList priority_queue;
+        OpenList f_queue;
+        OpenList g_queue;
+        int num_expansions;
+
+        explicit Frontier(const TaskProxy &task_proxy)
+            : match_tree(task_proxy), num_expansions(0) {
+        }
+        void insert(int node_id);
+        bool is_outdated(const OpenListEntry &entry) const;
+        // Return the smallest key of a current entry, or INF.
+        int get_min_key(OpenList &open_list) const;
+    };
+
+    std::shared_ptr<Evaluator> evaluator;
+    const bool use_backward_heuristic;
+
+    /*
+      Cost of the cheapest path from the initial value of each variable to
+      each of its values in the domain transition graph of the variable.
+    */
+    std::vector<std::vector<int>> initial_value_distances;
+    // Operators with an effect that achieves each fact.
+    std::vector<std::vector<std::vector<int>>> achievers;
+    // Smallest adjusted operator cost (epsilon in the MM paper).
+    int min_operator_cost;
+
+    Frontier forward;
+    Frontier backward;
+    PerStateInformation<int> forward_node_ids;
+    std::vector<StateID> forward_states;
+    std::vector<std::vector<int>> backward_states;
+    utils::HashMap<std::vector<int>, int> backward_node_ids;
+
+    int best_plan_cost;
+    int forward_meeting_node;
+    int backward_meeting_node;
+    int num_plan_improvements;
+
+    void compute_initial_value_distances();
+    int compute_backward_heuristic(const std::vector<int> &partial_state) const;
+    // Return false if the operator cannot be regressed over the state.
+    bool regress(
+        const std::vector<int> &partial_state, const OperatorProxy &op,
+        std::vector<int> &result) const;
+    /*
+      Store the node with the given g-value in its direction, reopening it
+      if it is closed, and update the best plan via the other direction.
+    */
+    void open_node(
+        Frontier &frontier, Frontier &other, int node_id, int g, int real_g,
+        int parent, OperatorID op_id, const std::vector<int> &values);
+    void generate_forward(
+        const State &state, int g, int real_g, int parent, OperatorID op_id);
+    void generate_backward(
+        std::vector<int> &&partial_state, int g, int real_g, int parent,
+        OperatorID op_id);
+    void expand_forward(int node_id);
+    void expand_backward(int node_id);
+    void extract_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    MMSearch(
+        const std::shared_ptr<Evaluator> &eval, bool use_backward_heuristic,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,549 @@
+#include "parallel_gbfs.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../search_progress.h"
+#include "../search_statistics.h"
+#include "../state_registry.h"
+
+#include "../algorithms/ordered_set.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace parallel_gbfs {
+/*
+  Extra bins that the shared registry stores for every state. The g values
+  are those of the path on which the state was registered first.
+*/
+enum ExtraBin {
+    PARENT,
+    CREATING_OPERATOR,
+    G,
+    REAL_G,
+    NUM_EXTRA_BINS
+};
+
+class ParallelGBFSWorker {
+    ParallelGBFS &search;
+    const int id;
+    const int num_bins;
+    const vector<shared_ptr<Evaluator>> evaluators;
+    const vector<shared_ptr<Evaluator>> preferred_operator_evaluators;
+
+    /*
+      Other workers steal states from the open list, so the open list and
+      the set of expanded states are protected by the mutex. The open list
+      can contain several entries for the same state (e.g., one in each
+      queue of an alternation open list), which we skip after the first one.
+    */
+    unique_ptr<StateOpenList> open_list;
+    utils::HashSet<StateID> closed_states;
+    mutex open_list_mutex;
+
+    // Registry for the states evaluated by this worker.
+    StateRegistry state_registry;
+    const int_packer::IntPacker &state_packer;
+    SearchProgress search_progress;
+    SearchStatistics statistics;
+    int num_stolen_states;
+
+    vector<PackedStateBin> successor_buffer;
+    vector<OperatorID> applicable_ops;
+
+    StateID remove_min();
+    StateID fetch_next_state();
+    void insert(EvaluationContext &eval_context, StateID state_id);
+    void check_progress(const EvaluationContext &eval_context);
+    void collect_preferred_operators(
+        EvaluationContext &eval_context,
+        ordered_set::OrderedSet<OperatorID> &preferred_operators) const;
+    void expand(StateID state_id);
+    void generate_successors(
+        StateID state_id, const State &state,
+        const EvaluationContext &eval_context,
+        const ordered_set::OrderedSet<OperatorID> &preferred_operators);
+public:
+    ParallelGBFSWorker(
+        ParallelGBFS &search, int id,
+        const vector<shared_ptr<Evaluator>> &evals,
+        const vector<shared_ptr<Evaluator>> &preferred);
+
+    void insert_initial_state(StateID initial_state_id);
+    void run();
+
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+ParallelGBFSWorker::ParallelGBFSWorker(
+    ParallelGBFS &search, int id, const vector<shared_ptr<Evaluator>> &evals,
+    const vector<shared_ptr<Evaluator>> &preferred)
+    : search(search),
+      id(id),
+      num_bins(search.shared_registry.get_state_packer().get_num_bins()),
+      evaluators(evals),
+      preferred_operator_evaluators(preferred),
+      open_list(search_common::create_greedy_open_list_factory(
+                    evals, preferred, search.boost)
+                    ->create_state_open_list()),
+      state_registry(search.task_proxy),
+      state_packer(state_registry.get_state_packer()),
+      statistics(search.log),
+      num_stolen_states(0),
+      successor_buffer(num_bins + NUM_EXTRA_BINS) {
+}
+
+void ParallelGBFSWorker::insert_initial_state(StateID initial_state_id) {
+    State initial_state = state_registry.register_state(
+        search.shared_registry.lookup_buffer(initial_state_id));
+    if (search.deferred_evaluation) {
+        // Like lazy search, we count the evaluation when expanding the state.
+        EvaluationContext eval_context(initial_state, 0, true, nullptr);
+        insert(eval_context, initial_state_id);
+        print_initial_evaluator_values(eval_context);
+        return;
+    }
+
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    if (open_list->is_dead_end(eval_context)) {
+        search.log << "Initial state is a dead end." << endl;
+    } else {
+        check_progress(eval_context);
+        insert(eval_context, initial_state_id);
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+StateID ParallelGBFSWorker::remove_min() {
+    lock_guard<mutex> lock(open_list_mutex);
+    while (!open_list->empty()) {
+        StateID state_id = open_list->remove_min();
+        if (closed_states.insert(state_id).second) {
+            return state_id;
+        }
+    }
+    return StateID::no_state;
+}
+
+StateID ParallelGBFSWorker::fetch_next_state() {
+    StateID state_id = remove_min();
+    for (int i = 1; i < search.num_threads && state_id == StateID::no_state;
+         ++i) {
+        int victim = (id + i) % search.num_threads;
+        state_id = search.workers[victim]->remove_min();
+        if (state_id != StateID::no_state) {
+            ++num_stolen_states;
+        }
+    }
+    return state_id;
+}
+
+void ParallelGBFSWorker::insert(
+    EvaluationContext &eval_context, StateID state_id) {
+    // Count the state before any worker can expand it.
+    search.num_pending_states.fetch_add(1);
+    lock_guard<mutex> lock(open_list_mutex);
+    open_list->insert(eval_context, state_id);
+}
+
+void ParallelGBFSWorker::check_progress(
+    const EvaluationContext &eval_context) {
+    bool progress;
+    {
+        lock_guard<mutex> lock(search.progress_mutex);
+        progress = search_progress.check_progress(eval_context);
+        if (progress) {
+            statistics.print_checkpoint_line(eval_context.get_g_value());
+        }
+    }
+    if (progress) {
+        lock_guard<mutex> lock(open_list_mutex);
+        open_list->boost_preferred();
+    }
+}
+
+void ParallelGBFSWorker::collect_preferred_operators(
+    EvaluationContext &eval_context,
+    ordered_set::OrderedSet<OperatorID> &preferred_operators) const {
+    for (const shared_ptr<Evaluator> &preferred_operator_evaluator :
+         preferred_operator_evaluators) {
+        ::collect_preferred_operators(
+            eval_context, preferred_operator_evaluator.get(),
+            preferred_operators);
+    }
+}
+
+void ParallelGBFSWorker::expand(StateID state_id) {
+    const PackedStateBin *extra_data =
+        search.shared_registry.lookup_extra_data(state_id);
+    int g = static_cast<int>(extra_data[G]);
+    State state = state_registry.register_state(
+        search.shared_registry.lookup_buffer(state_id));
+
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    if (search.deferred_evaluation) {
+        EvaluationContext eval_context(state, g, true, &statistics);
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(eval_context)) {
+            statistics.inc_dead_ends();
+            return;
+        }
+        check_progress(eval_context);
+        statistics.inc_expanded();
+        if (task_properties::is_goal_state(search.task_proxy, state)) {
+            search.set_goal(state_id);
+            return;
+        }
+        collect_preferred_operators(eval_context, preferred_operators);
+        generate_successors(state_id, state, eval_context, preferred_operators);
+    } else {
+        statistics.inc_expanded();
+        if (task_properties::is_goal_state(search.task_proxy, state)) {
+            search.set_goal(state_id);
+            return;
+        }
+        EvaluationContext eval_context(state, g, false, &statistics, true);
+        collect_preferred_operators(eval_context, preferred_operators);
+        generate_successors(state_id, state, eval_context, preferred_operators);
+    }
+}
+
+void ParallelGBFSWorker::generate_successors(
+    StateID state_id, const State &state,
+    const EvaluationContext &eval_context,
+    const ordered_set::OrderedSet<OperatorID> &preferred_operators) {
+    const PackedStateBin *extra_data =
+        search.shared_registry.lookup_extra_data(state_id);
+    int g = static_cast<int>(extra_data[G]);
+    int real_g = static_cast<int>(extra_data[REAL_G]);
+
+    applicable_ops.clear();
+    search.successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated_ops(applicable_ops.size());
+
+    OperatorsProxy operators = search.task_proxy.get_operators();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        if ((real_g + op.get_cost()) >= search.bound) {
+            continue;
+        }
+        int succ_g = g + search.get_adjusted_cost(op);
+
+        copy(
+            state.get_buffer(), state.get_buffer() + num_bins,
+            successor_buffer.begin());
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(
+                    successor_buffer.data(), effect_pair.var,
+                    effect_pair.value);
+            }
+        }
+        PackedStateBin *succ_extra_data = successor_buffer.data() + num_bins;
+        succ_extra_data[PARENT] =
+            ConcurrentStateRegistry::state_id_to_bin(state_id);
+        succ_extra_data[CREATING_OPERATOR] =
+            static_cast<PackedStateBin>(op_id.get_index());
+        succ_extra_data[G] = static_cast<PackedStateBin>(succ_g);
+        succ_extra_data[REAL_G] =
+            static_cast<PackedStateBin>(real_g + op.get_cost());
+        statistics.inc_generated();
+
+        pair<StateID, bool> result =
+            search.shared_registry.insert_state(successor_buffer.data());
+        if (!result.second) {
+            // Another path to this state was registered before.
+            continue;
+        }
+        StateID succ_id = result.first;
+        bool is_preferred = preferred_operators.contains(op_id);
+
+        if (search.deferred_evaluation) {
+            EvaluationContext succ_eval_context(
+                eval_context, succ_g, is_preferred, nullptr);
+            insert(succ_eval_context, succ_id);
+        } else {
+            State succ_state =
+                state_registry.register_state(successor_buffer.data());
+            EvaluationContext succ_eval_context(
+                succ_state, succ_g, is_preferred, &statistics);
+            statistics.inc_evaluated_states();
+            if (open_list->is_dead_end(succ_eval_context)) {
+                statistics.inc_dead_ends();
+                continue;
+            }
+            check_progress(succ_eval_context);
+            insert(succ_eval_context, succ_id);
+        }
+    }
+}
+
+void ParallelGBFSWorker::run() {
+    while (!search.terminated.load(memory_order_relaxed)) {
+        StateID state_id = fetch_next_state();
+        if (state_id != StateID::no_state) {
+            expand(state_id);
+            search.num_pending_states.fetch_sub(1);
+        } else if (search.num_pending_states.load() == 0) {
+            search.terminated = true;
+        } else {
+            /*
+              Other workers are still expanding states and might insert
+              new states soon.
+            */
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+    }
+}
+
+void ParallelGBFSWorker::print_statistics(utils::LogProxy &log) const {
+    log << "Thread " << id << ": expanded " << statistics.get_expanded()
+        << " state(s), stole " << num_stolen_states << " state(s), registered "
+        << state_registry.size() << " state(s)." << endl;
+}
+
+ParallelGBFS::ParallelGBFS(
+    const vector<parser::LazyValue> &evals,
+    const vector<parser::LazyValue> &preferred, int boost,
+    bool deferred_evaluation, int threads, OperatorCost cost_type, int bound,
+    double max_time, const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      eval_configs(evals),
+      preferred_configs(preferred),
+      boost(boost),
+      deferred_evaluation(deferred_evaluation),
+      num_threads(threads),
+      shared_registry(task_proxy, NUM_EXTRA_BINS),
+      terminated(false),
+      num_pending_states(0),
+      goal_id(StateID::no_state) {
+}
+
+ParallelGBFS::~ParallelGBFS() {
+}
+
+void ParallelGBFS::initialize() {
+    log << "Conducting parallel greedy best-first search"
+        << (deferred_evaluation ? " with deferred evaluation" : "")
+        << " with " << num_threads << " thread(s), (real) bound = " << bound
+        << endl;
+    // Successors are computed directly on packed data.
+    task_properties::verify_no_axioms(task_proxy);
+
+    set<Evaluator *> evaluators_of_other_workers;
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        vector<shared_ptr<Evaluator>> evals =
+            construct_evaluators(eval_configs);
+        vector<shared_ptr<Evaluator>> preferred =
+            construct_evaluators(preferred_configs);
+        set<Evaluator *> worker_evaluators;
+        set<Evaluator *> path_dependent_evaluators;
+        for (const vector<shared_ptr<Evaluator>> *evaluators :
+             {&evals, &preferred}) {
+            for (const shared_ptr<Evaluator> &evaluator : *evaluators) {
+                worker_evaluators.insert(evaluator.get());
+                evaluator->get_path_dependent_evaluators(
+                    path_dependent_evaluators);
+            }
+        }
+        for (Evaluator *evaluator : worker_evaluators) {
+            if (!evaluators_of_other_workers.insert(evaluator).second) {
+                cerr << "Parallel greedy best-first search needs separate "
+                     << "evaluators for each thread. Do not bind its "
+                     << "evaluators to variables with let." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+        }
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "Parallel greedy best-first search does not support "
+                 << "path-dependent evaluators." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        workers.push_back(
+            make_unique<ParallelGBFSWorker>(*this, i, evals, preferred));
+    }
+
+    vector<PackedStateBin> initial_extra_data(NUM_EXTRA_BINS, 0);
+    initial_extra_data[PARENT] =
+        ConcurrentStateRegistry::state_id_to_bin(StateID::no_state);
+    initial_extra_data[CREATING_OPERATOR] =
+        static_cast<PackedStateBin>(OperatorID::no_operator.get_index());
+    StateID initial_state_id =
+        shared_registry.get_initial_state_id(initial_extra_data.data());
+    workers[0]->insert_initial_state(initial_state_id);
+}
+
+void ParallelGBFS::set_goal(StateID state_id) {
+    lock_guard<mutex> lock(solution_mutex);
+    if (goal_id == StateID::no_state) {
+        goal_id = state_id;
+        terminated = true;
+    }
+}
+
+Plan ParallelGBFS::trace_plan() const {
+    Plan plan;
+    StateID state_id = goal_id;
+    while (true) {
+        const PackedStateBin *extra_data =
+            shared_registry.lookup_extra_data(state_id);
+        int op_index = static_cast<int>(extra_data[CREATING_OPERATOR]);
+        if (op_index == OperatorID::no_operator.get_index()) {
+            break;
+        }
+        plan.push_back(OperatorID(op_index));
+        state_id = ConcurrentStateRegistry::bin_to_state_id(extra_data[PARENT]);
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void ParallelGBFS::aggregate_statistics() {
+    for (const unique_ptr<ParallelGBFSWorker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->get_statistics();
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(
+            worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+}
+
+SearchStatus ParallelGBFS::step() {
+    /*
+      Note that the timer measures the CPU time of the whole process, i.e.,
+      the time used by all threads together.
+    */
+    utils::CountdownTimer timer(max_time);
+    bool timed_out = false;
+    bool out_of_memory = false;
+
+    vector<exception_ptr> errors(num_threads);
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this, i, &errors]() {
+            try {
+                workers[i]->run();
+            } catch (...) {
+                errors[i] = current_exception();
+                terminated = true;
+            }
+        });
+    }
+    while (!terminated) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        if (!terminated && timer.is_expired()) {
+            timed_out = true;
+            terminated = true;
+        }
+        /*
+          The threads do not return to search() before they terminate, so we
+          check the memory budget here. Memory pressure hooks must not run
+          while the threads use the evaluators and open lists.
+        */
+        if (!terminated && utils::memory_budget_is_exhausted()) {
+            out_of_memory = true;
+            terminated = true;
+        }
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+    for (const exception_ptr &error : errors) {
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    aggregate_statistics();
+
+    if (goal_id != StateID::no_state) {
+        log << "Solution found!" << endl;
+        set_plan(trace_plan());
+        return SOLVED;
+    }
+    if (timed_out) {
+        return TIMEOUT;
+    }
+    if (out_of_memory) {
+        utils::fire_remaining_memory_pressure_stages();
+        log << "Memory budget exhausted. Abort search." << endl;
+        return OUT_OF_MEMORY;
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void ParallelGBFS::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (const unique_ptr<ParallelGBFSWorker> &worker : workers) {
+        worker->print_statistics(log);
+    }
+    shared_registry.print_statistics(log);
+}
+
+vector<shared_ptr<Evaluator>> construct_evaluators(
+    const vector<parser::LazyValue> &configs) {
+    vector<shared_ptr<Evaluator>> evaluators;
+    evaluators.reserve(configs.size());
+    for (const parser::LazyValue &config : configs) {
+        try {
+            evaluators.push_back(config.construct<shared_ptr<Evaluator>>());
+        } catch (const utils::ContextError &e) {
+            cerr << "Delayed construction of LazyValue failed" << endl;
+            cerr << e.get_message() << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+    }
+    return evaluators;
+}
+
+void add_parallel_gbfs_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "threads",
+        "number of search threads. With more than one thread, the search "
+        "runs a parallel greedy best-first search with one open list per "
+        "thread.",
+        "1", plugins::Bounds("1", "infinity"));
+    feature.document_note(
+        "Parallel search",
+        "With threads > 1, every thread has its own open list and its own "
+        "instances of the evaluators, and threads whose open list is empty "
+        "take states from the open lists of other threads (K-parallel "
+        "best-first search, Vidal, Bordeaux and Hamadi, SoCS 2010). All "
+        "threads share the closed list. Evaluators must therefore not be "
+        "bound to variables with let. Path-dependent evaluators, pruning, "
+        "re-opening closed nodes, successor ordering and tasks with axioms "
+        "are not supported. The number of expanded states and the plan can "
+        "differ between runs. max_time refers to the CPU time of all threads "
+        "together. If the memory budget (--memory-budget) is exhausted, the "
+        "search stops, but the earlier stages that drop caches and compact "
+        "open lists only take effect once the threads have stopped.");
+}
+}
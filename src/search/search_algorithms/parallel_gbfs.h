@@ -0,0 +1,99 @@
+#ifndef SEARCH_ALGORITHMS_PARALLEL_GBFS_H
+#define SEARCH_ALGORITHMS_PARALLEL_GBFS_H
+
+#include "../concurrent_state_registry.h"
+#include "../search_algorithm.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+
+namespace parallel_gbfs {
+class ParallelGBFSWorker;
+
+/*
+  Parallel greedy best-first search in the style of K-parallel best-first
+  search (Vidal, Bordeaux and Hamadi, SoCS 2010).
+
+  Every thread has its own open list and its own instances of the
+  evaluators. A thread expands the best state of its open list and inserts
+  the new successors into it. If its open list is empty, it removes the best
+  state from the open list of another thread instead, so all threads expand
+  promising states from the start of the search.
+
+  All threads share a ConcurrentStateRegistry as closed list. Only the thread
+  that registers a state first inserts it into its open list, so every state
+  is evaluated and expanded at most once (closed nodes are never re-opened).
+  The registry stores the parent of every state as extra data, which lets
+  any thread trace the plan.
+
+  With deferred evaluation, successors are inserted with the evaluator
+  values of their parent and only evaluated when they are expanded (like
+  in lazy search).
+
+  Since heuristics need registered states (e.g., for caching estimates),
+  every thread additionally registers the states that it evaluates in its
+  own StateRegistry.
+
+  The search stops as soon as a thread expands a goal state.
+*/
+class ParallelGBFS : public SearchAlgorithm {
+    friend class ParallelGBFSWorker;
+
+    const std::vector<parser::LazyValue> eval_configs;
+    const std::vector<parser::LazyValue> preferred_configs;
+    const int boost;
+    const bool deferred_evaluation;
+    const int num_threads;
+
+    ConcurrentStateRegistry shared_registry;
+    std::vector<std::unique_ptr<ParallelGBFSWorker>> workers;
+
+    std::atomic<bool> terminated;
+    /*
+      Number of states that were inserted into an open list and whose
+      expansion has not finished yet. If it is 0, all open lists are empty
+      and no thread can generate new states.
+    */
+    std::atomic<int> num_pending_states;
+    std::mutex solution_mutex;
+    StateID goal_id;
+    // Serializes the output of new best evaluator values.
+    std::mutex progress_mutex;
+
+    void set_goal(StateID state_id);
+    Plan trace_plan() const;
+    void aggregate_statistics();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    ParallelGBFS(
+        const std::vector<parser::LazyValue> &evals,
+        const std::vector<parser::LazyValue> &preferred, int boost,
+        bool deferred_evaluation, int threads, OperatorCost cost_type,
+        int bound, double max_time, const std::string &description,
+        utils::Verbosity verbosity);
+    virtual ~ParallelGBFS() override;
+
+    virtual void print_statistics() const override;
+};
+
+/*
+  Construct the evaluators of lazily constructed list options such as the
+  "evals" and "preferred" options of eager_greedy and lazy_greedy.
+*/
+extern std::vector<std::shared_ptr<Evaluator>> construct_evaluators(
+    const std::vector<parser::LazyValue> &configs);
+
+extern void add_parallel_gbfs_options_to_feature(plugins::Feature &feature);
+}
+
+#endif
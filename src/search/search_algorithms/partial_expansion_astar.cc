@@ -0,0 +1,304 @@
+#include "partial_expansion_astar.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/language.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+
+using namespace std;
+
+namespace partial_expansion_astar {
+static const int INF = numeric_limits<int>::max();
+
+PartialExpansionAStar::PartialExpansionAStar(
+    const shared_ptr<Evaluator> &eval, bool enhanced, OperatorCost cost_type,
+    int bound, double max_time, const string &description,
+    utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      evaluator(eval),
+      enhanced(enhanced),
+      use_successor_values(false),
+      num_reexpansions(0),
+      num_surplus_successors(0) {
+}
+
+void PartialExpansionAStar::insert_into_open_list(StateID id, int f, int h) {
+    open_list.get_bucket_for_insertion(f).get_bucket_for_insertion(h).push(
+        {id, f, h});
+}
+
+OpenListEntry PartialExpansionAStar::pop_from_open_list() {
+    assert(!open_list.empty());
+    auto &h_buckets = open_list.get_min_bucket();
+    OpenListEntry entry = h_buckets.get_min_bucket().pop();
+    h_buckets.pop_min_bucket_if_empty();
+    open_list.pop_min_bucket_if_empty();
+    return entry;
+}
+
+void PartialExpansionAStar::initialize() {
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "peastar does not support path-dependent evaluators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    State initial_state = state_registry.get_initial_state();
+    if (enhanced) {
+        /*
+          Test whether the evaluator supports computing successor values
+          with the operators applicable in the initial state.
+        */
+        vector<OperatorID> applicable_operators;
+        successor_generator.generate_applicable_ops(
+            initial_state, applicable_operators);
+        vector<int> values;
+        use_successor_values = evaluator->compute_successor_values(
+            initial_state, applicable_operators, values);
+    }
+    log << "Conducting "
+        << (use_successor_values ? "enhanced partial expansion A*"
+                                 : "partial expansion A*")
+        << ", (real) bound = " << bound << endl;
+    if (enhanced && !use_successor_values) {
+        log << "The evaluator cannot compute successor values, so we use "
+            << "partial expansion A* without enhancement." << endl;
+    }
+
+    EvaluationContext eval_context(initial_state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        log << "Initial state is a dead end." << endl;
+    } else {
+        int h = eval_context.get_evaluator_value(evaluator.get());
+        statistics.report_f_value_progress(h);
+        SearchNode node = search_space.get_node(initial_state);
+        node.open_initial();
+        partial_expansion_infos[initial_state].stored_f = h;
+        insert_into_open_list(initial_state.get_id(), h, h);
+    }
+}
+
+SearchStatus PartialExpansionAStar::step() {
+    while (!open_list.empty()) {
+        OpenListEntry entry = pop_from_open_list();
+        State state = state_registry.lookup_state(entry.id);
+        SearchNode node = search_space.get_node(state);
+        /*
+          Skip outdated entries: the node has been closed or reinserted with
+          another f-value since the entry was inserted.
+        */
+        if (node.is_closed() ||
+            partial_expansion_infos[state].stored_f != entry.f) {
+            continue;
+        }
+        return expand(node, entry);
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void PartialExpansionAStar::insert_successor(
+    const SearchNode &node, const OperatorProxy &op, const State &succ_state,
+    int succ_f, int succ_h) {
+    SearchNode succ_node = search_space.get_node(succ_state);
+    int adjusted_cost = get_adjusted_cost(op);
+    if (succ_node.is_new()) {
+        succ_node.open_new_node(node, op, adjusted_cost);
+    } else if (succ_node.get_g() > node.get_g() + adjusted_cost) {
+        // We found a new cheapest path to an open or closed state.
+        if (succ_node.is_open()) {
+            succ_node.update_open_node_parent(node, op, adjusted_cost);
+        } else {
+            assert(succ_node.is_closed());
+            statistics.inc_reopened();
+            succ_node.reopen_closed_node(node, op, adjusted_cost);
+        }
+    } else {
+        return;
+    }
+    /*
+      The successors that were inserted by partial expansions of the node
+      with its previous g-value may not be reached optimally anymore, so we
+      start partial expansions of the node from scratch.
+    */
+    PartialExpansionInfo &info = partial_expansion_infos[succ_state];
+    info.stored_f = succ_f;
+    info.expanded_f = -1;
+    insert_into_open_list(succ_state.get_id(), succ_f, succ_h);
+}
+
+SearchStatus PartialExpansionAStar::expand(
+    SearchNode &node, const OpenListEntry &entry) {
+    const State &state = node.get_state();
+    int stored_f = entry.f;
+    int expanded_f = partial_expansion_infos[state].expanded_f;
+    statistics.inc_expanded();
+    statistics.report_f_value_progress(stored_f);
+    if (expanded_f != -1) {
+        ++num_reexpansions;
+    }
+
+    if (check_goal_and_set_plan(state))
+        return SOLVED;
+
+    vector<OperatorID> applicable_operators;
+    successor_generator.generate_applicable_ops(state, applicable_operators);
+    erase_if(applicable_operators, [&](OperatorID op_id) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        return node.get_real_g() + op.get_cost() >= bound;
+    });
+
+    vector<int> succ_h_values;
+    if (use_successor_values) {
+        bool supported = evaluator->compute_successor_values(
+            state, applicable_operators, succ_h_values);
+        utils::unused_variable(supported);
+        assert(supported);
+        /*
+          Successor values are computed without generating the successor
+          states, so we cannot tell whether a successor has been evaluated
+          before and count every value as an evaluated state.
+        */
+        statistics.inc_evaluated_states(applicable_operators.size());
+        statistics.inc_evaluations(applicable_operators.size());
+    }
+
+    // Smallest f-value of a successor that is not inserted in this expansion.
+    int next_f = INF;
+    for (size_t i = 0; i < applicable_operators.size(); ++i) {
+        OperatorProxy op = task_proxy.get_operators()[applicable_operators[i]];
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+
+        if (use_successor_values) {
+            int succ_h = succ_h_values[i];
+            if (succ_h == EvaluationResult::INFTY)
+                continue;
+            int succ_f = succ_g + succ_h;
+            if (succ_f > stored_f) {
+                next_f = min(next_f, succ_f);
+                ++num_surplus_successors;
+            } else if (succ_f > expanded_f) {
+                State succ_state =
+                    state_registry.get_successor_state(state, op);
+                statistics.inc_generated();
+                insert_successor(node, op, succ_state, succ_f, succ_h);
+            }
+            continue;
+        }
+
+        State succ_state = state_registry.get_successor_state(state, op);
+        statistics.inc_generated();
+        SearchNode succ_node = search_space.get_node(succ_state);
+        if (succ_node.is_dead_end())
+            continue;
+        if (succ_node.is_new())
+            statistics.inc_evaluated_states();
+        EvaluationContext succ_eval_context(
+            succ_state, succ_g, false, &statistics);
+        if (succ_eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            if (succ_node.is_new()) {
+                succ_node.mark_as_dead_end();
+                statistics.inc_dead_ends();
+            }
+            continue;
+        }
+        int succ_h = succ_eval_context.get_evaluator_value(evaluator.get());
+        int succ_f = succ_g + succ_h;
+        if (succ_f > stored_f) {
+            next_f = min(next_f, succ_f);
+            ++num_surplus_successors;
+        } else if (succ_f > expanded_f) {
+            insert_successor(node, op, succ_state, succ_f, succ_h);
+        }
+    }
+
+    if (next_f == INF) {
+        node.close();
+    } else {
+        PartialExpansionInfo &info = partial_expansion_infos[state];
+        info.stored_f = next_f;
+        info.expanded_f = stored_f;
+        insert_into_open_list(state.get_id(), next_f, entry.h);
+    }
+    return IN_PROGRESS;
+}
+
+void PartialExpansionAStar::print_statistics() const {
+    statistics.print_detailed_statistics();
+    if (use_successor_values) {
+        log << "Evaluated states include repeated successor values of the "
+            << "same state." << endl;
+    }
+    search_space.print_statistics();
+    log << "Re-expansions of partially expanded states: " << num_reexpansions
+        << endl;
+    log << "Surplus successors (not inserted into the open list): "
+        << num_surplus_successors << endl;
+}
+
+class PartialExpansionAStarFeature
+    : public plugins::TypedFeature<SearchAlgorithm, PartialExpansionAStar> {
+public:
+    PartialExpansionAStarFeature() : TypedFeature("peastar") {
+        document_title("Partial expansion A*");
+        document_synopsis(
+            "Partial expansion A* (Yoshizumi et al., AAAI 2000) and "
+            "enhanced partial expansion A* (Felner et al., AAAI 2012). "
+            "Expanding a state only inserts the successors whose f-value "
+            "equals the f-value with which the state is stored in the open "
+            "list. The state is then reinserted with the next larger f-value "
+            "of a successor. Successors with an f-value above the optimal "
+            "plan cost are never stored in the open list, which saves memory "
+            "in tasks with many such successors, at the cost of re-expanding "
+            "states. Closed nodes are re-opened.");
+
+        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<bool>(
+            "enhanced",
+            "compute the h-values of the successors from the expanded state "
+            "and the operators if the evaluator supports this, so that only "
+            "the successors that are inserted into the open list are "
+            "generated (enhanced partial expansion A*)",
+            "true");
+        add_search_algorithm_options_to_feature(*this, "peastar");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "supported");
+
+        document_property("admissible", "yes if the evaluator is admissible");
+        document_property("consistent", "no");
+        document_property("safe", "yes if the evaluator is safe");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Enhanced partial expansion",
+            "Currently, pdb() and the potential heuristics can compute the "
+            "h-values of successors without generating them. Without "
+            "enhancement, all successors are generated and evaluated in "
+            "every partial expansion, so evaluators should cache their "
+            "estimates.");
+    }
+
+    virtual shared_ptr<PartialExpansionAStar> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<PartialExpansionAStar>(
+            opts.get<shared_ptr<Evaluator>>("eval"), opts.get<bool>("enhanced"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<PartialExpansionAStarFeature> _plugin;
+}
@@ -0,0 +1,90 @@
+#ifndef SEARCH_ALGORITHMS_PARTIAL_EXPANSION_ASTAR_H
+#define SEARCH_ALGORITHMS_PARTIAL_EXPANSION_ASTAR_H
+
+#include "../per_state_information.h"
+#include "../search_algorithm.h"
+
+#include "../algorithms/bucket_array.h"
+
+#include <memory>
+#include <vector>
+
+class Evaluator;
+
+namespace partial_expansion_astar {
+struct OpenListEntry {
+    StateID id;
+    int f;
+    int h;
+};
+
+struct PartialExpansionInfo {
+    // The f-value with which the node is stored in the open list.
+    int stored_f;
+    /*
+      The stored f-value of the last partial expansion of the node, or -1 if
+      the node has not been expanded since its g-value changed. All
+      successors with an f-value of at most expanded_f have already been
+      inserted into the open list.
+    */
+    int expanded_f;
+
+    PartialExpansionInfo() : stored_f(-1), expanded_f(-1) {
+    }
+};
+
+/*
+  Partial expansion A* (PEA*, Yoshizumi et al., AAAI 2000) and enhanced
+  partial expansion A* (EPEA*, Felner et al., AAAI 2012).
+
+  A* inserts all successors of an expanded node into the open list, although
+  the successors with an f-value above the optimal plan cost are never
+  expanded. PEA* stores a node with an f-value F, which is initially its
+  f-value. Expanding the node only inserts the successors whose f-value is F
+  (or below F if the heuristic is inconsistent) and reinserts the node with
+  the smallest larger f-value of a successor. Only if there is no such
+  successor, the node is closed. This trades re-expansions for a smaller open
+  list.
+
+  PEA* still computes all successors and their heuristic values in every
+  expansion. If the evaluator can compute the heuristic values of the
+  successors directly from the expanded state and the operators (see
+  Evaluator::compute_successor_values), EPEA* only generates the successors
+  that it inserts into the open list.
+*/
+class PartialExpansionAStar : public SearchAlgorithm {
+    const std::shared_ptr<Evaluator> evaluator;
+    const bool enhanced;
+    bool use_successor_values;
+
+    // Ordered by f-value and then h-value, FIFO for ties.
+    bucket_array::BucketArray<
+        bucket_array::BucketArray<bucket_array::FifoBucket<OpenListEntry>>>
+        open_list;
+    PerStateInformation<PartialExpansionInfo> partial_expansion_infos;
+
+    int num_reexpansions;
+    int num_surplus_successors;
+
+    void insert_into_open_list(StateID id, int f, int h);
+    OpenListEntry pop_from_open_list();
+    void insert_successor(
+        const SearchNode &node, const OperatorProxy &op,
+        const State &succ_state, int succ_f, int succ_h);
+    SearchStatus expand(SearchNode &node, const OpenListEntry &entry);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    PartialExpansionAStar(
+        const std::shared_ptr<Evaluator> &eval, bool enhanced,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
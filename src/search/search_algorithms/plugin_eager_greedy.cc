@@ -1,23 +1,28 @@
 #include "eager_search.h"
+#include "parallel_gbfs.h"
 #include "search_common.h"
 
 #include "../plugins/plugin.h"
+#include "../pruning/null_pruning_method.h"
+#include "../utils/system.h"
 
 using namespace std;
 
 namespace plugin_eager_greedy {
 class EagerGreedySearchFeature
-    : public plugins::TypedFeature<SearchAlgorithm, eager_search::EagerSearch> {
+    : public plugins::TypedFeature<SearchAlgorithm, SearchAlgorithm> {
 public:
     EagerGreedySearchFeature() : TypedFeature("eager_greedy") {
         document_title("Greedy search (eager)");
         document_synopsis("");
 
-        add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
+        add_list_option<shared_ptr<Evaluator>>("evals", "evaluators", "", true);
         add_list_option<shared_ptr<Evaluator>>(
-            "preferred", "use preferred operators of these evaluators", "[]");
+            "preferred", "use preferred operators of these evaluators", "[]",
+            true);
         add_option<int>(
             "boost", "boost value for preferred operator open lists", "0");
+        parallel_gbfs::add_parallel_gbfs_options_to_feature(*this);
         eager_search::add_eager_search_options_to_feature(
             *this, "eager_greedy");
 
@@ -56,14 +61,32 @@ public:
             true);
     }
 
-    virtual shared_ptr<eager_search::EagerSearch> create_component(
+    virtual shared_ptr<SearchAlgorithm> create_component(
         const plugins::Options &opts) const override {
+        vector<parser::LazyValue> evals =
+            opts.get<parser::LazyValue>("evals").construct_lazy_list();
+        vector<parser::LazyValue> preferred =
+            opts.get<parser::LazyValue>("preferred").construct_lazy_list();
+        int threads = opts.get<int>("threads");
+        if (threads > 1) {
+            if (!dynamic_pointer_cast<null_pruning_method::NullPruningMethod>(
+                    opts.get<shared_ptr<PruningMethod>>("pruning"))) {
+                cerr << "eager_greedy does not support pruning with more "
+                     << "than one thread." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+            }
+            return plugins::make_shared_from_arg_tuples<
+                parallel_gbfs::ParallelGBFS>(
+                evals, preferred, opts.get<int>("boost"), false, threads,
+                get_search_algorithm_arguments_from_options(opts));
+        }
+        vector<shared_ptr<Evaluator>> preferred_evaluators =
+            parallel_gbfs::construct_evaluators(preferred);
         return plugins::make_shared_from_arg_tuples<eager_search::EagerSearch>(
             search_common::create_greedy_open_list_factory(
-                opts.get_list<shared_ptr<Evaluator>>("evals"),
-                opts.get_list<shared_ptr<Evaluator>>("preferred"),
-                opts.get<int>("boost")),
-            false, nullptr, opts.get_list<shared_ptr<Evaluator>>("preferred"),
+                parallel_gbfs::construct_evaluators(evals),
+                preferred_evaluators, opts.get<int>("boost")),
+            false, nullptr, preferred_evaluators,
             eager_search::get_eager_search_arguments_from_options(opts));
     }
 };
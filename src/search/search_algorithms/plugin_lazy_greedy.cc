@@ -1,7 +1,9 @@
 #include "lazy_search.h"
+#include "parallel_gbfs.h"
 #include "search_common.h"
 
 #include "../plugins/plugin.h"
+#include "../utils/system.h"
 
 using namespace std;
 
@@ -9,13 +11,13 @@ namespace plugin_lazy_greedy {
 static const string DEFAULT_LAZY_BOOST = "1000";
 
 class LazyGreedySearchFeature
-    : public plugins::TypedFeature<SearchAlgorithm, lazy_search::LazySearch> {
+    : public plugins::TypedFeature<SearchAlgorithm, SearchAlgorithm> {
 public:
     LazyGreedySearchFeature() : TypedFeature("lazy_greedy") {
         document_title("Greedy search (lazy)");
         document_synopsis("");
 
-        add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
+        add_list_option<shared_ptr<Evaluator>>("evals", "evaluators", "", true);
         add_option<int>(
             "boost",
             "boost value for alternation queues that are restricted "
@@ -24,8 +26,10 @@ public:
 
         add_option<bool>("reopen_closed", "reopen closed nodes", "false");
         add_list_option<shared_ptr<Evaluator>>(
-            "preferred", "use preferred operators of these evaluators", "[]");
+            "preferred", "use preferred operators of these evaluators", "[]",
+            true);
         add_successors_order_options_to_feature(*this);
+        parallel_gbfs::add_parallel_gbfs_options_to_feature(*this);
         add_search_algorithm_options_to_feature(*this, "lazy_greedy");
 
         document_note(
@@ -63,15 +67,34 @@ public:
             true);
     }
 
-    virtual shared_ptr<lazy_search::LazySearch> create_component(
+    virtual shared_ptr<SearchAlgorithm> create_component(
         const plugins::Options &opts) const override {
+        vector<parser::LazyValue> evals =
+            opts.get<parser::LazyValue>("evals").construct_lazy_list();
+        vector<parser::LazyValue> preferred =
+            opts.get<parser::LazyValue>("preferred").construct_lazy_list();
+        int threads = opts.get<int>("threads");
+        if (threads > 1) {
+            if (opts.get<bool>("reopen_closed") ||
+                opts.get<bool>("randomize_successors") ||
+                opts.get<bool>("preferred_successors_first")) {
+                cerr << "lazy_greedy does not support reopen_closed, "
+                     << "randomize_successors and preferred_successors_first "
+                     << "with more than one thread." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+            }
+            return plugins::make_shared_from_arg_tuples<
+                parallel_gbfs::ParallelGBFS>(
+                evals, preferred, opts.get<int>("boost"), true, threads,
+                get_search_algorithm_arguments_from_options(opts));
+        }
+        vector<shared_ptr<Evaluator>> preferred_evaluators =
+            parallel_gbfs::construct_evaluators(preferred);
         return plugins::make_shared_from_arg_tuples<lazy_search::LazySearch>(
             search_common::create_greedy_open_list_factory(
-                opts.get_list<shared_ptr<Evaluator>>("evals"),
-                opts.get_list<shared_ptr<Evaluator>>("preferred"),
-                opts.get<int>("boost")),
-            opts.get<bool>("reopen_closed"),
-            opts.get_list<shared_ptr<Evaluator>>("preferred"),
+                parallel_gbfs::construct_evaluators(evals),
+                preferred_evaluators, opts.get<int>("boost")),
+            opts.get<bool>("reopen_closed"), preferred_evaluators,
             get_successors_order_arguments_from_options(opts),
             get_search_algorithm_arguments_from_options(opts));
     }
@@ -0,0 +1,548 @@
+#include "symbolic_search.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace std;
+using bdd::BDD;
+
+namespace symbolic_search {
+static const int INF = numeric_limits<int>::max();
+// Layer of states that were reached but not closed yet.
+static const int GENERATED_LAYER = -1;
+
+static int get_num_bits(int domain_size) {
+    int num_bits = 0;
+    while ((1 << num_bits) < domain_size) {
+        ++num_bits;
+    }
+    return num_bits;
+}
+
+SymbolicVariables::SymbolicVariables(
+    const TaskProxy &task_proxy, int initial_gc_threshold) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_bdd_vars = 0;
+    bdd_vars.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        int num_bits = get_num_bits(var.get_domain_size());
+        bdd_vars.emplace_back();
+        for (int bit = 0; bit < num_bits; ++bit) {
+            bdd_vars.back().push_back(num_bdd_vars++);
+        }
+    }
+    manager = make_unique<bdd::BDDManager>(num_bdd_vars, initial_gc_threshold);
+
+    fact_bdds.resize(variables.size());
+    valid_values.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        int var_id = var.get_id();
+        const vector<int> &bits = bdd_vars[var_id];
+        int num_bits = bits.size();
+        BDD valid = manager->get_false();
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            BDD fact = manager->get_true();
+            for (int i = 0; i < num_bits; ++i) {
+                if ((value >> (num_bits - 1 - i)) & 1) {
+                    fact &= manager->variable(bits[i]);
+                } else {
+                    fact &= manager->negated_variable(bits[i]);
+                }
+            }
+            valid |= fact;
+            fact_bdds[var_id].push_back(move(fact));
+        }
+        valid_values.push_back(move(valid));
+    }
+}
+
+BDD SymbolicVariables::get_cube(const vector<int> &vars) {
+    vector<int> cube_vars;
+    for (int var : vars) {
+        cube_vars.insert(
+            cube_vars.end(), bdd_vars[var].begin(), bdd_vars[var].end());
+    }
+    return manager->cube(cube_vars);
+}
+
+BDD SymbolicVariables::get_state_bdd(const vector<int> &values) {
+    BDD state = manager->get_true();
+    for (size_t var = 0; var < values.size(); ++var) {
+        state &= fact_bdds[var][values[var]];
+    }
+    return state;
+}
+
+vector<int> SymbolicVariables::pick_state(const BDD &states) const {
+    vector<int> model = states.pick_model();
+    vector<int> values;
+    values.reserve(bdd_vars.size());
+    for (const vector<int> &bits : bdd_vars) {
+        int value = 0;
+        for (int bit : bits) {
+            value = 2 * value + model[bit];
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+TransitionRelation::TransitionRelation(
+    const OperatorProxy &op, int cost, SymbolicVariables &vars)
+    : op_id(op.get_id()), cost(cost) {
+    bdd::BDDManager &manager = vars.get_manager();
+    precondition = manager.get_true();
+    for (FactProxy fact : op.get_preconditions()) {
+        precondition &= vars.get_fact_bdd(fact.get_pair());
+    }
+    effect = manager.get_true();
+    regression_precondition = precondition;
+    vector<int> effect_vars;
+    for (EffectProxy eff : op.get_effects()) {
+        FactPair fact = eff.get_fact().get_pair();
+        effect &= vars.get_fact_bdd(fact);
+        regression_precondition &= vars.get_valid_values(fact.var);
+        effect_vars.push_back(fact.var);
+    }
+    effect_vars_cube = vars.get_cube(effect_vars);
+}
+
+SymbolicSearch::SymbolicSearch(
+    SearchDirection direction, int initial_gc_threshold,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(cost_type, bound, max_time, description, verbosity),
+      direction(direction),
+      initial_gc_threshold(initial_gc_threshold),
+      best_plan_cost(INF),
+      last_reported_lower_bound(-1),
+      peak_live_nodes(0) {
+}
+
+SymbolicSearch::~SymbolicSearch() {
+    // Destroy all BDDs before the manager.
+    best_meeting = nullptr;
+    forward_frontier = nullptr;
+    backward_frontier = nullptr;
+    transitions_by_cost.clear();
+    zero_cost_transitions.clear();
+}
+
+void SymbolicSearch::initialize() {
+    log << "Conducting symbolic uniform-cost search, bound = " << bound
+        << endl;
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    /*
+      The buckets only store g-values for the adjusted costs, so we can
+      only enforce a bound on the real plan cost if both costs agree.
+    */
+    if (bound != INF) {
+        for (OperatorProxy op : task_proxy.get_operators()) {
+            if (get_adjusted_cost(op) != op.get_cost()) {
+                cerr << "symbolic_ucs does not support bounds with cost "
+                     << "types that change the operator costs." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+            }
+        }
+    }
+
+    vars = make_unique<SymbolicVariables>(task_proxy, initial_gc_threshold);
+    bdd::BDDManager &manager = vars->get_manager();
+    log << "BDD variables: " << manager.get_num_variables() << endl;
+
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int cost = get_adjusted_cost(op);
+        if (cost == 0) {
+            zero_cost_transitions.emplace_back(op, cost, *vars);
+        } else {
+            transitions_by_cost[cost].emplace_back(op, cost, *vars);
+        }
+    }
+    log << "Transition relations: " << transitions_by_cost.size()
+        << " cost partition(s), " << zero_cost_transitions.size()
+        << " zero-cost operator(s)" << endl;
+
+    State initial_state = task_proxy.get_initial_state();
+    initial_state.unpack();
+    forward_frontier = make_unique<Frontier>(true);
+    forward_frontier->closed = manager.get_false();
+    forward_frontier->open[0] = vars->get_state_bdd(initial_state.get_unpacked_values());
+
+    BDD goal_states = manager.get_true();
+    for (VariableProxy var : task_proxy.get_variables()) {
+        goal_states &= vars->get_valid_values(var.get_id());
+    }
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goal_states &= vars->get_fact_bdd(goal.get_pair());
+    }
+    backward_frontier = make_unique<Frontier>(false);
+    backward_frontier->closed = manager.get_false();
+    backward_frontier->open[0] = move(goal_states);
+
+    if (direction == SearchDirection::FORWARD) {
+        close_start_states(*backward_frontier);
+    } else if (direction == SearchDirection::BACKWARD) {
+        close_start_states(*forward_frontier);
+    }
+    best_plan_cost = bound;
+}
+
+void SymbolicSearch::close_start_states(Frontier &frontier) {
+    BDD start_states = move(frontier.open.at(0));
+    frontier.open.clear();
+    frontier.closed = start_states;
+    frontier.closed_layers[0].push_back(move(start_states));
+}
+
+BDD SymbolicSearch::get_successors(
+    const Frontier &frontier, const TransitionRelation &transition,
+    const BDD &states) const {
+    return frontier.forward ? transition.image(states)
+                            : transition.preimage(states);
+}
+
+BDD SymbolicSearch::get_predecessors(
+    const Frontier &frontier, const TransitionRelation &transition,
+    const BDD &states) const {
+    return frontier.forward ? transition.preimage(states)
+                            : transition.image(states);
+}
+
+int SymbolicSearch::get_min_open_g(Frontier &frontier) {
+    if (frontier.forward ? direction == SearchDirection::BACKWARD
+                         : direction == SearchDirection::FORWARD) {
+        return 0;
+    }
+    while (!frontier.open.empty()) {
+        auto it = frontier.open.begin();
+        it->second -= frontier.closed;
+        if (!it->second.is_false()) {
+            return it->first;
+        }
+        frontier.open.erase(it);
+    }
+    return INF;
+}
+
+SymbolicSearch::Frontier &SymbolicSearch::select_frontier() {
+    if (direction == SearchDirection::FORWARD) {
+        return *forward_frontier;
+    } else if (direction == SearchDirection::BACKWARD) {
+        return *backward_frontier;
+    }
+    // Both open lists are non-empty here: expand the smaller next bucket.
+    int forward_nodes = forward_frontier->open.begin()->second.get_num_nodes();
+    int backward_nodes = backward_frontier->open.begin()->second.get_num_nodes();
+    return (forward_nodes <= backward_nodes) ? *forward_frontier
+                                             : *backward_frontier;
+}
+
+void SymbolicSearch::set_best_meeting(
+    const Frontier &frontier, BDD &&states, int g, int layer, int other_g,
+    int other_layer) {
+    best_plan_cost = g + other_g;
+    if (frontier.forward) {
+        best_meeting = make_unique<Meeting>(
+            Meeting{move(states), g, layer, other_g, other_layer});
+    } else {
+        best_meeting = make_unique<Meeting>(
+            Meeting{move(states), other_g, other_layer, g, layer});
+    }
+    log << "Found plan with cost " << best_plan_cost << endl;
+}
+
+void SymbolicSearch::check_meeting(
+    const Frontier &frontier, const Frontier &other, const BDD &states,
+    int g, int layer) {
+    BDD common = states & other.closed;
+    if (!common.is_false()) {
+        bool found = false;
+        for (const auto &[other_g, other_layers] : other.closed_layers) {
+            if (found || other_g >= best_plan_cost - g) {
+                break;
+            }
+            for (size_t other_layer = 0; other_layer < other_layers.size();
+                 ++other_layer) {
+                BDD meeting_states = common & other_layers[other_layer];
+                if (!meeting_states.is_false()) {
+                    set_best_meeting(
+                        frontier, move(meeting_states), g, layer, other_g,
+                        other_layer);
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    /*
+      The states might also have been reached but not closed by the other
+      direction. Its start states (g = 0) are layer 0 of their g-value, all
+      other open states were generated from closed states.
+    */
+    for (const auto &[other_g, open_states] : other.open) {
+        if (other_g >= best_plan_cost - g) {
+            break;
+        }
+        BDD meeting_states = states & open_states;
+        if (!meeting_states.is_false()) {
+            set_best_meeting(
+                frontier, move(meeting_states), g, layer, other_g,
+                other_g == 0 ? 0 : GENERATED_LAYER);
+            break;
+        }
+    }
+}
+
+void SymbolicSearch::expand(Frontier &frontier, Frontier &other) {
+    bdd::BDDManager &manager = vars->get_manager();
+    auto bucket = frontier.open.begin();
+    int g = bucket->first;
+    BDD layer = move(bucket->second);
+    frontier.open.erase(bucket);
+    if (log.is_at_least_verbose()) {
+        log << (frontier.forward ? "Forward" : "Backward")
+            << " step with g = " << g << ", " << layer.get_num_nodes()
+            << " BDD nodes" << endl;
+    }
+
+    // Close the states of the bucket and all states reached via zero-cost
+    // operators, one layer per zero-cost step.
+    vector<BDD> &layers = frontier.closed_layers[g];
+    assert(layers.empty());
+    BDD expanded = manager.get_false();
+    while (!layer.is_false()) {
+        frontier.closed |= layer;
+        expanded |= layer;
+        frontier.num_expanded_states += layer.count_models();
+        check_meeting(frontier, other, layer, g, layers.size());
+        BDD next_layer = manager.get_false();
+        for (const TransitionRelation &transition : zero_cost_transitions) {
+            next_layer |= get_successors(frontier, transition, layer);
+        }
+        layers.push_back(move(layer));
+        layer = next_layer - frontier.closed;
+    }
+
+    for (const auto &[cost, transitions] : transitions_by_cost) {
+        if (cost > INF - g || g + cost >= bound) {
+            break;
+        }
+        BDD successors = manager.get_false();
+        for (const TransitionRelation &transition : transitions) {
+            successors |= get_successors(frontier, transition, expanded);
+        }
+        successors -= frontier.closed;
+        if (successors.is_false()) {
+            continue;
+        }
+        int succ_g = g + cost;
+        check_meeting(frontier, other, successors, succ_g, GENERATED_LAYER);
+        auto it = frontier.open.find(succ_g);
+        if (it == frontier.open.end()) {
+            frontier.open.emplace(succ_g, move(successors));
+        } else {
+            it->second |= successors;
+        }
+    }
+    ++frontier.num_steps;
+}
+
+SearchStatus SymbolicSearch::step() {
+    int forward_g = get_min_open_g(*forward_frontier);
+    int backward_g = get_min_open_g(*backward_frontier);
+    /*
+      If a direction has no open states, it has closed all states it can
+      reach. Each of them has been checked against the closed and open
+      states of the other direction, including its start states, so the
+      best plan found so far is optimal.
+    */
+    if (forward_g == INF || backward_g == INF ||
+        forward_g >= best_plan_cost - backward_g) {
+        if (!best_meeting) {
+            log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        extract_plan();
+        return SOLVED;
+    }
+    int lower_bound = forward_g + backward_g;
+    if (lower_bound > last_reported_lower_bound) {
+        last_reported_lower_bound = lower_bound;
+        log << "f = " << lower_bound << " [forward g = " << forward_g
+            << ", backward g = " << backward_g << ", "
+            << vars->get_manager().get_num_live_nodes() << " BDD nodes] "
+            << utils::g_timer << endl;
+    }
+
+    Frontier &frontier = select_frontier();
+    Frontier &other = frontier.forward ? *backward_frontier : *forward_frontier;
+    expand(frontier, other);
+    peak_live_nodes = max(
+        peak_live_nodes, vars->get_manager().get_num_live_nodes());
+    return IN_PROGRESS;
+}
+
+void SymbolicSearch::trace_path(
+    const Frontier &frontier, vector<int> state_values, int g, int layer,
+    vector<OperatorID> &path) const {
+    while (g != 0 || layer != 0) {
+        BDD state = vars->get_state_bdd(state_values);
+        bool found = false;
+        if (layer > 0) {
+            /*
+              States in layer k > 0 were reached from layer k - 1 via a
+              zero-cost operator.
+            */
+            const BDD &previous_layer = frontier.closed_layers.at(g)[layer - 1];
+            for (const TransitionRelation &transition : zero_cost_transitions) {
+                BDD predecessors =
+                    get_predecessors(frontier, transition, state) & previous_layer;
+                if (!predecessors.is_false()) {
+                    path.push_back(transition.op_id);
+                    state_values = vars->pick_state(predecessors);
+                    --layer;
+                    found = true;
+                    break;
+                }
+            }
+        } else {
+            // Generated states and states in layer 0 were reached via an
+            // operator with positive cost from an arbitrary closed layer.
+            for (const auto &[cost, transitions] : transitions_by_cost) {
+                if (cost > g) {
+                    break;
+                }
+                auto it = frontier.closed_layers.find(g - cost);
+                if (it == frontier.closed_layers.end()) {
+                    continue;
+                }
+                for (const TransitionRelation &transition : transitions) {
+                    BDD predecessors =
+                        get_predecessors(frontier, transition, state);
+                    if (predecessors.is_false()) {
+                        continue;
+                    }
+                    const vector<BDD> &previous_layers = it->second;
+                    for (size_t k = 0; k < previous_layers.size(); ++k) {
+                        BDD closed_predecessors =
+                            predecessors & previous_layers[k];
+                        if (!closed_predecessors.is_false()) {
+                            path.push_back(transition.op_id);
+                            state_values = vars->pick_state(closed_predecessors);
+                            g -= cost;
+                            layer = k;
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (found)
+                        break;
+                }
+                if (found)
+                    break;
+            }
+        }
+        if (!found) {
+            cerr << "Could not reconstruct the plan of the symbolic search."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+}
+
+void SymbolicSearch::extract_plan() {
+    assert(best_meeting);
+    vector<int> meeting_state = vars->pick_state(best_meeting->states);
+
+    vector<OperatorID> forward_path;
+    trace_path(
+        *forward_frontier, meeting_state, best_meeting->forward_g,
+        best_meeting->forward_layer, forward_path);
+    vector<OperatorID> backward_path;
+    trace_path(
+        *backward_frontier, meeting_state, best_meeting->backward_g,
+        best_meeting->backward_layer, backward_path);
+
+    Plan plan(forward_path.rbegin(), forward_path.rend());
+    plan.insert(plan.end(), backward_path.begin(), backward_path.end());
+    set_plan(plan);
+}
+
+void SymbolicSearch::print_statistics() const {
+    log << "Forward expansion steps: " << forward_frontier->num_steps << endl;
+    log << "Backward expansion steps: " << backward_frontier->num_steps << endl;
+    log << "Expanded states (forward): "
+        << forward_frontier->num_expanded_states << endl;
+    log << "Expanded states (backward): "
+        << backward_frontier->num_expanded_states << endl;
+    log << "Peak live BDD nodes: " << peak_live_nodes << endl;
+    log << "BDD garbage collections: "
+        << vars->get_manager().get_num_garbage_collections() << endl;
+}
+
+class SymbolicSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, SymbolicSearch> {
+public:
+    SymbolicSearchFeature() : TypedFeature("symbolic_ucs") {
+        document_title("Symbolic uniform-cost search");
+        document_synopsis(
+            "Uniform-cost search on sets of states represented as binary "
+            "decision diagrams (BDDs), in forward, backward or bidirectional "
+            "direction (Torralba, Alcazar, Borrajo and Kissmann, AIJ 2017). "
+            "The transition relations are partitioned by operator cost, and "
+            "the search expands all states with the same g-value at once. "
+            "This is efficient for tasks with large state spaces whose sets "
+            "of states have compact BDD representations.");
+
+        add_option<SearchDirection>(
+            "direction", "search direction", "bidirectional");
+        add_option<int>(
+            "initial_gc_threshold",
+            "number of BDD nodes at which the BDD manager collects garbage "
+            "for the first time (doubled whenever more than half of the "
+            "nodes survive a collection)",
+            "1048576", plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "symbolic_ucs");
+
+        document_language_support("action costs", "supported");
+        document_language_support("conditional effects", "not supported");
+        document_language_support("axioms", "not supported");
+
+        document_property("admissible", "yes");
+        document_property("consistent", "yes");
+        document_property("safe", "yes");
+        document_property("preferred operators", "no");
+
+        document_note(
+            "Bound",
+            "The search prunes states whose g-value reaches the bound. "
+            "Since the g-values refer to the adjusted operator costs (see "
+            "cost_type), bounds are only supported if the cost type does "
+            "not change the cost of any operator.");
+    }
+
+    virtual shared_ptr<SymbolicSearch> create_component(
+        const plugins::Options &opts) const override {
+        return plugins::make_shared_from_arg_tuples<SymbolicSearch>(
+            opts.get<SearchDirection>("direction"),
+            opts.get<int>("initial_gc_threshold"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<SymbolicSearchFeature> _plugin;
+
+static plugins::TypedEnumPlugin<SearchDirection> _enum_plugin(
+    {{"forward", "search from the initial state"},
+     {"backward", "search from the goal states"},
+     {"bidirectional",
+      "alternate between both directions, expanding the direction whose next "
+      "bucket has the smaller BDD"}});
+}
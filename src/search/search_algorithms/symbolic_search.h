@@ -0,0 +1,198 @@
+#ifndef SEARCH_ALGORITHMS_SYMBOLIC_SEARCH_H
+#define SEARCH_ALGORITHMS_SYMBOLIC_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include "../algorithms/bdd.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace symbolic_search {
+enum class SearchDirection {
+    FORWARD,
+    BACKWARD,
+    BIDIRECTIONAL
+};
+
+/*
+  Binary encoding of the finite-domain variables of a task. Each variable
+  with domain size d uses ceil(log2(d)) BDD variables, which encode its
+  value in binary (most significant bit first). The BDD variables of the
+  task variables follow the order of the task variables. Codes greater than
+  or equal to the domain size do not encode a value, so sets of states are
+  always restricted to valid codes.
+
+  The manager is owned by this class, so all BDDs must be destroyed before
+  it.
+*/
+class SymbolicVariables {
+    std::unique_ptr<bdd::BDDManager> manager;
+    // BDD variables of each task variable, most significant bit first.
+    std::vector<std::vector<int>> bdd_vars;
+    std::vector<std::vector<bdd::BDD>> fact_bdds;
+    std::vector<bdd::BDD> valid_values;
+
+public:
+    SymbolicVariables(const TaskProxy &task_proxy, int initial_gc_threshold);
+
+    bdd::BDDManager &get_manager() {
+        return *manager;
+    }
+
+    const bdd::BDD &get_fact_bdd(const FactPair &fact) const {
+        return fact_bdds[fact.var][fact.value];
+    }
+
+    // Set of states in which the given variable has a valid code.
+    const bdd::BDD &get_valid_values(int var) const {
+        return valid_values[var];
+    }
+
+    // Cube of the BDD variables of the given task variables.
+    bdd::BDD get_cube(const std::vector<int> &vars);
+    bdd::BDD get_state_bdd(const std::vector<int> &values);
+    // Return the values of a state in the given non-empty set of states.
+    std::vector<int> pick_state(const bdd::BDD &states) const;
+};
+
+/*
+  Transitions induced by a single operator without conditional effects. We
+  do not use BDD variables for successor states: the operator only changes
+  the variables it has effects on, so its image is computed by restricting
+  a set of states to the precondition, abstracting the effect variables and
+  setting them to the effect values. The preimage works analogously.
+*/
+struct TransitionRelation {
+    OperatorID op_id;
+    int cost;
+    bdd::BDD precondition;
+    bdd::BDD effect;
+    bdd::BDD effect_vars_cube;
+    // Precondition restricted to valid codes of the effect variables.
+    bdd::BDD regression_precondition;
+
+    TransitionRelation(
+        const OperatorProxy &op, int cost, SymbolicVariables &vars);
+
+    bdd::BDD image(const bdd::BDD &states) const {
+        return states.and_exists(precondition, effect_vars_cube) & effect;
+    }
+
+    bdd::BDD preimage(const bdd::BDD &states) const {
+        return states.and_exists(effect, effect_vars_cube) &
+               regression_precondition;
+    }
+};
+
+/*
+  Symbolic uniform-cost search (Dijkstra search on sets of states
+  represented by BDDs) in forward direction from the initial state, in
+  backward direction from the goal states, or in both directions.
+
+  Each direction stores the reached states in buckets by their g-value. An
+  expansion step of a direction removes the bucket with the smallest
+  g-value, closes its states, adds the states reached by zero-cost
+  operators until a fixpoint is reached, and inserts the successors via
+  each cost c > 0 into the bucket g + c. The closed states of each g-value
+  are stored as a sequence of layers (one per zero-cost step), which allows
+  reconstructing a plan.
+
+  Whenever a direction closes or reaches states that the other direction
+  has closed or reached, we obtain a plan whose cost is the sum of the
+  g-values in both directions. The search stops once the sum of the
+  smallest g-values of the open buckets of both directions is at least the
+  cost of the best plan found, which is then optimal, or once a direction
+  has no open buckets left.
+
+  Unidirectional search only closes the start states of the other
+  direction (the initial state or the goal states) without expanding them.
+*/
+class SymbolicSearch : public SearchAlgorithm {
+    struct Frontier {
+        const bool forward;
+        std::map<int, bdd::BDD> open;
+        bdd::BDD closed;
+        // closed_layers[g][k]: states closed with g after k zero-cost steps.
+        std::map<int, std::vector<bdd::BDD>> closed_layers;
+        int num_steps;
+        double num_expanded_states;
+        explicit Frontier(bool forward)
+            : forward(forward), num_steps(0), num_expanded_states(0) {
+        }
+    };
+
+    struct Meeting {
+        bdd::BDD states;
+        // Positions of the states in the forward and backward frontiers.
+        int forward_g;
+        int forward_layer;
+        int backward_g;
+        int backward_layer;
+    };
+
+    const SearchDirection direction;
+    const int initial_gc_threshold;
+
+    // Declared before all BDDs, so that its manager is destroyed last.
+    std::unique_ptr<SymbolicVariables> vars;
+    std::vector<TransitionRelation> zero_cost_transitions;
+    std::map<int, std::vector<TransitionRelation>> transitions_by_cost;
+    std::unique_ptr<Frontier> forward_frontier;
+    std::unique_ptr<Frontier> backward_frontier;
+
+    int best_plan_cost;
+    std::unique_ptr<Meeting> best_meeting;
+    int last_reported_lower_bound;
+    int peak_live_nodes;
+
+    bdd::BDD get_successors(
+        const Frontier &frontier, const TransitionRelation &transition,
+        const bdd::BDD &states) const;
+    bdd::BDD get_predecessors(
+        const Frontier &frontier, const TransitionRelation &transition,
+        const bdd::BDD &states) const;
+    /*
+      Close the start states of a direction that is not searched. They are
+      the only states with finite g-value in that direction, so its
+      smallest open g-value is 0 afterwards.
+    */
+    void close_start_states(Frontier &frontier);
+    // Smallest g-value of an open bucket with states that are not closed.
+    int get_min_open_g(Frontier &frontier);
+    Frontier &select_frontier();
+    void set_best_meeting(
+        const Frontier &frontier, bdd::BDD &&states, int g, int layer,
+        int other_g, int other_layer);
+    // Update the best plan with the states of the other direction.
+    void check_meeting(
+        const Frontier &frontier, const Frontier &other, const bdd::BDD &states,
+        int g, int layer);
+    void expand(Frontier &frontier, Frontier &other);
+    /*
+      Append the operators of a path from the given state to the start of
+      the frontier (the initial state or a goal state). The state must be
+      contained in the given layer or be reachable from a closed state.
+    */
+    void trace_path(
+        const Frontier &frontier, std::vector<int> state_values, int g,
+        int layer, std::vector<OperatorID> &path) const;
+    void extract_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    SymbolicSearch(
+        SearchDirection direction, int initial_gc_threshold,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~SymbolicSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -1,10 +1,25 @@
 #include "search_node_info.h"
 
-static const int pointer_bytes = sizeof(void *);
-static const int info_bytes = 3 * sizeof(int) + sizeof(StateID);
-static const int padding_bytes = info_bytes % pointer_bytes;
+using namespace std;
 
-static_assert(
-    sizeof(SearchNodeInfo) == info_bytes + padding_bytes,
-    "The size of SearchNodeInfo is larger than expected. This probably means "
-    "that packing two fields into one integer using bitfields is not supported.");
+SearchNodeInfoLayout::SearchNodeInfoLayout(
+    bool store_creating_operator, bool store_real_g)
+    : creating_operator_index(NO_FIELD),
+      real_g_index(NO_FIELD),
+      num_fields(PARENT_STATE_ID + 1) {
+    if (store_creating_operator) {
+        creating_operator_index = num_fields++;
+    }
+    if (store_real_g) {
+        real_g_index = num_fields++;
+    }
+}
+
+vector<int> SearchNodeInfoLayout::get_default_entry() const {
+    vector<int> entry(num_fields, -1);
+    ArrayView<int> info(entry.data(), num_fields);
+    set_g(info, -1);
+    set_status(info, NEW);
+    set_parent(info, StateID::no_state, OperatorID::no_operator);
+    return entry;
+}
@@ -2,12 +2,41 @@
 #define SEARCH_NODE_INFO_H
 
 #include "operator_id.h"
+#include "per_state_array.h"
 #include "state_id.h"
 
+#include <vector>
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
-struct SearchNodeInfo {
+/*
+  The search space stores the information about a search node as an array
+  of ints. SearchNodeInfoLayout describes which fields the array contains and
+  provides access to them. The layout is selected at runtime (see
+  SearchSpace) because every stored byte is multiplied by the number of
+  states. The fields are:
+
+    - status (2 bits) and g value (30 bits), always stored
+    - ID of the parent state, always stored
+    - ID of the creating operator, unless it is reconstructed from the parent
+      state and the state when needed
+    - real g value (with the original operator costs), unless it always
+      equals the g value
+
+  With all fields, a node needs 16 bytes; without the optional fields, it
+  needs 8 bytes.
+*/
+class SearchNodeInfoLayout {
+    static const int STATUS_AND_G = 0;
+    static const int PARENT_STATE_ID = 1;
+    static const int NO_FIELD = -1;
+    static const unsigned int STATUS_MASK = 3;
+
+    int creating_operator_index;
+    int real_g_index;
+    int num_fields;
+public:
     enum NodeStatus {
         NEW = 0,
         OPEN = 1,
@@ -15,18 +44,78 @@ struct SearchNodeInfo {
         DEAD_END = 3
     };
 
-    unsigned int status : 2;
-    int g : 30;
-    StateID parent_state_id;
-    OperatorID creating_operator;
-    int real_g;
-
-    SearchNodeInfo()
-        : status(NEW),
-          g(-1),
-          parent_state_id(StateID::no_state),
-          creating_operator(-1),
-          real_g(-1) {
+    SearchNodeInfoLayout(bool store_creating_operator, bool store_real_g);
+
+    // Return the entry of a new node (status NEW, g -1, no parent).
+    std::vector<int> get_default_entry() const;
+
+    bool stores_creating_operator() const {
+        return creating_operator_index != NO_FIELD;
+    }
+
+    bool stores_real_g() const {
+        return real_g_index != NO_FIELD;
+    }
+
+    int get_size_in_bytes() const {
+        return num_fields * sizeof(int);
+    }
+
+    NodeStatus get_status(ConstArrayView<int> info) const {
+        return static_cast<NodeStatus>(
+            static_cast<unsigned int>(info[STATUS_AND_G]) & STATUS_MASK);
+    }
+
+    int get_g(ConstArrayView<int> info) const {
+        // The right shift of a negative number is arithmetic since C++20.
+        return info[STATUS_AND_G] >> 2;
+    }
+
+    int get_real_g(ConstArrayView<int> info) const {
+        return stores_real_g() ? info[real_g_index] : get_g(info);
+    }
+
+    StateID get_parent_state_id(ConstArrayView<int> info) const {
+        return StateID(info[PARENT_STATE_ID]);
+    }
+
+    /*
+      Return the creating operator if it is stored. Otherwise, the search
+      space has to reconstruct it.
+    */
+    OperatorID get_creating_operator(ConstArrayView<int> info) const {
+        return stores_creating_operator()
+                   ? OperatorID(info[creating_operator_index])
+                   : OperatorID::no_operator;
+    }
+
+    void set_status(ArrayView<int> info, NodeStatus status) const {
+        info[STATUS_AND_G] = static_cast<int>(
+            (static_cast<unsigned int>(info[STATUS_AND_G]) & ~STATUS_MASK) |
+            status);
+    }
+
+    void set_g(ArrayView<int> info, int g) const {
+        info[STATUS_AND_G] = static_cast<int>(
+            (static_cast<unsigned int>(g) << 2) |
+            (static_cast<unsigned int>(info[STATUS_AND_G]) & STATUS_MASK));
+    }
+
+    void set_real_g(ArrayView<int> info, int real_g) const {
+        if (stores_real_g()) {
+            info[real_g_index] = real_g;
+        } else {
+            assert(real_g == get_g(info));
+        }
+    }
+
+    void set_parent(
+        ArrayView<int> info, StateID parent_state_id,
+        OperatorID creating_operator) const {
+        info[PARENT_STATE_ID] = parent_state_id.value;
+        if (stores_creating_operator()) {
+            info[creating_operator_index] = creating_operator.get_index();
+        }
     }
 };
 
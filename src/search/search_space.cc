@@ -3,15 +3,18 @@
 #include "search_node_info.h"
 #include "task_proxy.h"
 
+#include "task_utils/successor_generator.h"
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
-    : state(state), info(info) {
+SearchNode::SearchNode(
+    const State &state, ArrayView<int> info, const SearchSpace &search_space)
+    : state(state), info(info), search_space(search_space) {
     assert(state.get_id() != StateID::no_state);
 }
 
@@ -20,108 +23,194 @@ const State &SearchNode::get_state() const {
 }
 
 bool SearchNode::is_open() const {
-    return info.status == SearchNodeInfo::OPEN;
+    return search_space.layout.get_status(info) == SearchNodeInfoLayout::OPEN;
 }
 
 bool SearchNode::is_closed() const {
-    return info.status == SearchNodeInfo::CLOSED;
+    return search_space.layout.get_status(info) ==
+           SearchNodeInfoLayout::CLOSED;
 }
 
 bool SearchNode::is_dead_end() const {
-    return info.status == SearchNodeInfo::DEAD_END;
+    return search_space.layout.get_status(info) ==
+           SearchNodeInfoLayout::DEAD_END;
 }
 
 bool SearchNode::is_new() const {
-    return info.status == SearchNodeInfo::NEW;
+    return search_space.layout.get_status(info) == SearchNodeInfoLayout::NEW;
 }
 
 int SearchNode::get_g() const {
-    assert(info.g >= 0);
-    return info.g;
+    assert(search_space.layout.get_g(info) >= 0);
+    return search_space.layout.get_g(info);
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    return search_space.layout.get_real_g(info);
 }
 
 void SearchNode::open_initial() {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
-    info.g = 0;
-    info.real_g = 0;
-    info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    const SearchNodeInfoLayout &layout = search_space.layout;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::NEW);
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
+    layout.set_g(info, 0);
+    layout.set_real_g(info, 0);
+    layout.set_parent(info, StateID::no_state, OperatorID::no_operator);
 }
 
 void SearchNode::update_parent(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state().get_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    const SearchNodeInfoLayout &layout = search_space.layout;
+    layout.set_g(info, layout.get_g(parent_node.info) + adjusted_cost);
+    layout.set_real_g(
+        info, layout.get_real_g(parent_node.info) + parent_op.get_cost());
+    layout.set_parent(
+        info, parent_node.get_state().get_id(), OperatorID(parent_op.get_id()));
 }
 
 void SearchNode::open_new_node(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::NEW);
-    info.status = SearchNodeInfo::OPEN;
+    const SearchNodeInfoLayout &layout = search_space.layout;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::NEW);
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen_closed_node(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::CLOSED);
-    info.status = SearchNodeInfo::OPEN;
+    const SearchNodeInfoLayout &layout = search_space.layout;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::CLOSED);
+    layout.set_status(info, SearchNodeInfoLayout::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::update_open_node_parent(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::OPEN);
+    assert(
+        search_space.layout.get_status(info) == SearchNodeInfoLayout::OPEN);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::update_closed_node_parent(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
-    assert(info.status == SearchNodeInfo::CLOSED);
+    assert(
+        search_space.layout.get_status(info) == SearchNodeInfoLayout::CLOSED);
     update_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::close() {
-    assert(info.status == SearchNodeInfo::OPEN);
-    info.status = SearchNodeInfo::CLOSED;
+    const SearchNodeInfoLayout &layout = search_space.layout;
+    assert(layout.get_status(info) == SearchNodeInfoLayout::OPEN);
+    layout.set_status(info, SearchNodeInfoLayout::CLOSED);
 }
 
 void SearchNode::mark_as_dead_end() {
-    info.status = SearchNodeInfo::DEAD_END;
+    search_space.layout.set_status(info, SearchNodeInfoLayout::DEAD_END);
 }
 
 void SearchNode::dump(const TaskProxy &task_proxy, utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         log << state.get_id() << ": ";
         task_properties::dump_fdr(state);
-        if (info.creating_operator != OperatorID::no_operator) {
+        OperatorID creating_operator =
+            search_space.get_creating_operator(state, info);
+        if (creating_operator != OperatorID::no_operator) {
             OperatorsProxy operators = task_proxy.get_operators();
-            OperatorProxy op = operators[info.creating_operator.get_index()];
+            OperatorProxy op = operators[creating_operator.get_index()];
             log << " created by " << op.get_name() << " from "
-                << info.parent_state_id << endl;
+                << search_space.layout.get_parent_state_id(info) << endl;
         } else {
             log << " no parent" << endl;
         }
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log)
-    : state_registry(state_registry), log(log) {
+static bool has_adjusted_costs(
+    const TaskProxy &task_proxy, OperatorCost cost_type, bool is_unit_cost) {
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (get_adjusted_action_cost(op, cost_type, is_unit_cost) !=
+            op.get_cost()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static SearchNodeInfoLayout create_layout(
+    const StateRegistry &state_registry, OperatorCost cost_type) {
+    const TaskProxy &task_proxy = state_registry.get_task_proxy();
+    bool store_real_g = has_adjusted_costs(
+        task_proxy, cost_type, task_properties::is_unit_cost(task_proxy));
+    bool store_creating_operator =
+        state_registry.uses_hash_compaction() || store_real_g;
+    return SearchNodeInfoLayout(store_creating_operator, store_real_g);
+}
+
+SearchSpace::SearchSpace(
+    StateRegistry &state_registry, OperatorCost cost_type,
+    utils::LogProxy &log)
+    : state_registry(state_registry),
+      layout(create_layout(state_registry, cost_type)),
+      search_node_infos(layout.get_default_entry()),
+      log(log) {
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    return SearchNode(state, search_node_infos[state], *this);
+}
+
+OperatorID SearchSpace::get_creating_operator(
+    const State &state, ConstArrayView<int> info) const {
+    if (layout.stores_creating_operator()) {
+        return layout.get_creating_operator(info);
+    }
+    StateID parent_id = layout.get_parent_state_id(info);
+    if (parent_id == StateID::no_state) {
+        return OperatorID::no_operator;
+    }
+    State parent_state = state_registry.lookup_state(parent_id);
+    /*
+      Without adjusted costs, the real g values equal the g values. We only
+      accept operators that cost at most the difference of the real g values
+      of the state and its parent, so that the traced path never costs more
+      than the real g value. The operator the search used costs exactly the
+      difference unless the g value of the parent decreased later (e.g.,
+      without reopening).
+    */
+    int max_cost =
+        layout.get_g(info) - layout.get_g(search_node_infos[parent_state]);
+    parent_state.unpack();
+    state.unpack();
+    const TaskProxy &task_proxy = state_registry.get_task_proxy();
+    vector<OperatorID> applicable_ops;
+    successor_generator::g_successor_generators[task_proxy]
+        .generate_applicable_ops(parent_state, applicable_ops);
+    OperatorsProxy operators = task_proxy.get_operators();
+    OperatorID best_op = OperatorID::no_operator;
+    int best_cost = -1;
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        int cost = op.get_cost();
+        if (cost > max_cost ||
+            (best_op != OperatorID::no_operator &&
+             (cost > best_cost ||
+              (cost == best_cost &&
+               op_id.get_index() > best_op.get_index())))) {
+            continue;
+        }
+        State successor = parent_state.get_unregistered_successor(op);
+        if (successor.get_unpacked_values() == state.get_unpacked_values()) {
+            best_op = op_id;
+            best_cost = cost;
+        }
+    }
+    assert(best_op != OperatorID::no_operator);
+    return best_op;
 }
 
 void SearchSpace::trace_path(
@@ -130,13 +219,13 @@ void SearchSpace::trace_path(
     assert(current_state.get_registry() == &state_registry);
     assert(path.empty());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        ConstArrayView<int> info = search_node_infos[current_state];
+        StateID parent_id = layout.get_parent_state_id(info);
+        if (parent_id == StateID::no_state) {
             break;
         }
-        path.push_back(info.creating_operator);
-        current_state = state_registry.lookup_state(info.parent_state_id);
+        path.push_back(get_creating_operator(current_state, info));
+        current_state = state_registry.lookup_state(parent_id);
     }
     reverse(path.begin(), path.end());
 }
@@ -147,15 +236,15 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         State state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        ConstArrayView<int> info = search_node_infos[state];
+        StateID parent_id = layout.get_parent_state_id(info);
         log << id << ": ";
         task_properties::dump_fdr(state);
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
+        if (parent_id != StateID::no_state) {
             OperatorProxy op =
-                operators[node_info.creating_operator.get_index()];
-            log << " created by " << op.get_name() << " from "
-                << node_info.parent_state_id << endl;
+                operators[get_creating_operator(state, info).get_index()];
+            log << " created by " << op.get_name() << " from " << parent_id
+                << endl;
         } else {
             log << "has no parent" << endl;
         }
@@ -164,4 +253,5 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
 
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics(log);
+    log << "Bytes per search node: " << layout.get_size_in_bytes() << endl;
 }
@@ -2,12 +2,13 @@
 #define SEARCH_SPACE_H
 
 #include "operator_cost.h"
-#include "per_state_information.h"
+#include "per_state_array.h"
 #include "search_node_info.h"
 
 #include <vector>
 
 class OperatorProxy;
+class SearchSpace;
 class State;
 class TaskProxy;
 
@@ -17,13 +18,16 @@ class LogProxy;
 
 class SearchNode {
     State state;
-    SearchNodeInfo &info;
+    ArrayView<int> info;
+    const SearchSpace &search_space;
 
     void update_parent(
         const SearchNode &parent_node, const OperatorProxy &parent_op,
         int adjusted_cost);
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(
+        const State &state, ArrayView<int> info,
+        const SearchSpace &search_space);
 
     const State &get_state() const;
 
@@ -54,13 +58,38 @@ public:
     void dump(const TaskProxy &task_proxy, utils::LogProxy &log) const;
 };
 
+/*
+  The search space selects the most compact layout for the search node
+  information that suffices for the task and the search (see
+  SearchNodeInfoLayout):
+
+    - The real g value is only stored if some operator has an adjusted cost
+      (as given by cost_type) that differs from its real cost.
+    - The creating operator is only stored with hash compaction, where the
+      data of states can be released, or if some operator has an adjusted
+      cost that differs from its real cost, where the cheapest operator under
+      the adjusted costs can be more expensive under the real costs.
+      Otherwise, it is reconstructed from the parent state and the state when
+      tracing a path: we use the cheapest applicable operator that leads from
+      the parent to the state (breaking ties by operator ID) and whose cost
+      is at most the difference of the g values of the state and the parent.
+      If several operators lead to the same state, the path can therefore
+      differ from the one the search found, but its cost never exceeds the
+      real g value of the last state.
+*/
 class SearchSpace {
-    PerStateInformation<SearchNodeInfo> search_node_infos;
-
     StateRegistry &state_registry;
+    const SearchNodeInfoLayout layout;
+    PerStateArray<int> search_node_infos;
     utils::LogProxy &log;
+
+    friend class SearchNode;
+    OperatorID get_creating_operator(
+        const State &state, ConstArrayView<int> info) const;
 public:
-    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
+    SearchSpace(
+        StateRegistry &state_registry, OperatorCost cost_type,
+        utils::LogProxy &log);
 
     SearchNode get_node(const State &state);
     void trace_path(
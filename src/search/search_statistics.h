@@ -83,6 +83,13 @@ public:
     int get_generated_ops() const {
         return generated_ops;
     }
+    int get_dead_ends() const {
+        return dead_end_states;
+    }
+    // Return the f-value of the last jump, or -1 before the first one.
+    int get_lastjump_f_value() const {
+        return lastjump_f_value;
+    }
 
     /*
       Call the following method with the f value of every expanded
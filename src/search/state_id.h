@@ -1,6 +1,8 @@
 #ifndef STATE_ID_H
 #define STATE_ID_H
 
+#include "utils/hash.h"
+
 #include <iostream>
 
 // For documentation on classes relevant to storing and working with registered
@@ -8,12 +10,14 @@
 
 class StateID {
     friend class StateRegistry;
+    friend class ConcurrentStateRegistry;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
     template<typename>
     friend class PerStateInformation;
     template<typename>
     friend class PerStateArray;
     friend class PerStateBitset;
+    friend class SearchNodeInfoLayout;
 
     int value;
     explicit StateID(int value_) : value(value_) {
@@ -34,6 +38,16 @@ public:
     bool operator!=(const StateID &other) const {
         return !(*this == other);
     }
+
+    int hash() const {
+        return value;
+    }
 };
 
+namespace utils {
+inline void feed(HashState &hash_state, StateID id) {
+    feed(hash_state, id.hash());
+}
+}
+
 #endif
@@ -5,62 +5,224 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/profiler.h"
+
+#include <algorithm>
+#include <cstdint>
 
 using namespace std;
 
+bool g_hash_compaction = false;
+
+/*
+  We hash states Zobrist-style: the hash of a state is the XOR of the hashes
+  of its bins, where each bin is hashed together with its index. Since XOR is
+  its own inverse, changing a bin from old_value to new_value changes the hash
+  of the state by get_bin_hash(bin, old_value) ^ get_bin_hash(bin, new_value).
+  We use keyed hashes of (bin, value) pairs instead of random keys for all
+  facts because successor states are generated on packed data. Folding the
+  64-bit hashes to 32 bits (see fold_hash()) commutes with XOR, so we can
+  update the folded hashes stored without hash compaction the same way.
+
+  The 64-bit hash is the finalizer of SplitMix64, which is a bijection, so
+  different (bin, value) pairs never get the same 64-bit hash.
+*/
+static uint64_t get_bin_hash(int bin, PackedStateBin value) {
+    uint64_t hash = (static_cast<uint64_t>(bin) << 32) | value;
+    hash += 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
 StateRegistry::StateRegistry(const TaskProxy &task_proxy)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
+      task_has_axioms(task_properties::has_axioms(task_proxy)),
+      hash_compaction(g_hash_compaction),
       state_data_pool(get_bins_per_state()),
+      is_holding_freed_slots(false),
+      new_state_slot(-1),
+      num_released_states(0),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+          StateIDSemanticHash(*this), StateIDSemanticEqual(*this)) {
+}
+
+void StateRegistry::compute_packed_effects() {
+    OperatorsProxy operators = task_proxy.get_operators();
+    packed_effects_start.reserve(operators.size() + 1);
+    has_packed_effects.reserve(operators.size());
+    for (OperatorProxy op : operators) {
+        packed_effects_start.push_back(packed_effects.size());
+        EffectsProxy effects = op.get_effects();
+        bool has_conditional_effect = false;
+        for (EffectProxy effect : effects) {
+            if (!effect.get_conditions().empty()) {
+                has_conditional_effect = true;
+                break;
+            }
+        }
+        has_packed_effects.push_back(!has_conditional_effect);
+        if (has_conditional_effect) {
+            continue;
+        }
+        int first_effect = packed_effects.size();
+        for (EffectProxy effect : effects) {
+            FactPair fact = effect.get_fact().get_pair();
+            int bin = state_packer.get_bin_index(fact.var);
+            PackedStateBin write_mask = state_packer.get_write_mask(fact.var);
+            PackedStateBin value_bits =
+                state_packer.get_shifted_value(fact.var, fact.value);
+            auto it = find_if(
+                packed_effects.begin() + first_effect, packed_effects.end(),
+                [bin](const PackedEffect &packed_effect) {
+                    return packed_effect.bin == bin;
+                });
+            if (it == packed_effects.end()) {
+                packed_effects.push_back({bin, write_mask, value_bits});
+            } else {
+                it->write_mask |= write_mask;
+                it->value_bits |= value_bits;
+            }
+        }
+    }
+    packed_effects_start.push_back(packed_effects.size());
+}
+
+uint64_t StateRegistry::get_stored_hash(StateID id) const {
+    if (hash_compaction) {
+        return fingerprints[id.value];
+    }
+    return state_hashes[id.value];
+}
+
+uint64_t StateRegistry::compute_hash(const PackedStateBin *buffer) const {
+    uint64_t hash = 0;
+    for (int i = 0; i < get_bins_per_state(); ++i) {
+        hash ^= get_bin_hash(i, buffer[i]);
+    }
+    return hash;
+}
+
+uint64_t StateRegistry::update_hash(
+    uint64_t hash, const PackedStateBin *old_buffer,
+    const PackedStateBin *new_buffer) const {
+    for (int i = 0; i < get_bins_per_state(); ++i) {
+        if (old_buffer[i] != new_buffer[i]) {
+            hash ^=
+                get_bin_hash(i, old_buffer[i]) ^ get_bin_hash(i, new_buffer[i]);
+        }
+    }
+    return hash;
+}
+
+PackedStateBin *StateRegistry::push_state_data(const PackedStateBin *buffer) {
+    if (hash_compaction && !free_slots.empty()) {
+        new_state_slot = free_slots.back();
+        free_slots.pop_back();
+        PackedStateBin *data = state_data_pool[new_state_slot];
+        copy(buffer, buffer + get_bins_per_state(), data);
+        return data;
+    }
+    state_data_pool.push_back(buffer);
+    new_state_slot = state_data_pool.size() - 1;
+    return state_data_pool[new_state_slot];
+}
+
+void StateRegistry::free_slot(int slot) {
+    if (is_holding_freed_slots) {
+        held_slots.push_back(slot);
+    } else {
+        free_slots.push_back(slot);
+    }
 }
 
-StateID StateRegistry::insert_id_or_pop_state() {
+StateID StateRegistry::insert_id_or_pop_state(uint64_t hash) {
     /*
-      Attempt to insert a StateID for the last state of state_data_pool
+      Attempt to insert a StateID for the state whose data was pushed last
       if none is present yet. If this fails (another entry for this state
       is present), we have to remove the duplicate entry from the
-      state data pool.
+      state data pool (or, with hash compaction, free its slot).
     */
-    StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    assert(fold_hash(hash) ==
+           fold_hash(compute_hash(state_data_pool[new_state_slot])));
+    StateID id(size());
+    if (hash_compaction) {
+        fingerprints.push_back(hash);
+        state_slots.push_back(new_state_slot);
+    } else {
+        assert(new_state_slot == id.value);
+        state_hashes.push_back(fold_hash(hash));
+    }
+    pair<int, bool> result =
+        registered_states.insert_with_hash(id.value, fold_hash(hash));
     bool is_new_entry = result.second;
     if (!is_new_entry) {
-        state_data_pool.pop_back();
+        if (hash_compaction) {
+            fingerprints.pop_back();
+            state_slots.pop_back();
+            free_slot(new_state_slot);
+        } else {
+            state_data_pool.pop_back();
+            state_hashes.pop_back();
+        }
     }
-    assert(
-        registered_states.size() == static_cast<int>(state_data_pool.size()));
     return StateID(result.first);
 }
 
-State StateRegistry::lookup_state(StateID id) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+const PackedStateBin *StateRegistry::get_state_data(StateID id) const {
+    if (hash_compaction) {
+        int slot = state_slots[id.value];
+        return slot == RELEASED ? nullptr : state_data_pool[slot];
+    }
+    return state_data_pool[id.value];
+}
+
+/*
+  Create the state with the given ID after generating or registering it. If
+  it is a duplicate of a state whose data was released, the generated data
+  is still in its (freed) slot.
+*/
+State StateRegistry::create_new_state(StateID id) const {
+    const PackedStateBin *buffer = get_state_data(id);
+    if (!buffer) {
+        buffer = state_data_pool[new_state_slot];
+    }
     return task_proxy.create_state(*this, id, buffer);
 }
 
-State StateRegistry::lookup_state(
+State StateRegistry::create_new_state(
     StateID id, vector<int> &&state_values) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+    const PackedStateBin *buffer = get_state_data(id);
+    if (!buffer) {
+        buffer = state_data_pool[new_state_slot];
+    }
     return task_proxy.create_state(*this, id, buffer, move(state_values));
 }
 
+State StateRegistry::lookup_state(StateID id) const {
+    return task_proxy.create_state(*this, id, get_state_data(id));
+}
+
+State StateRegistry::lookup_state(
+    StateID id, vector<int> &&state_values) const {
+    return task_proxy.create_state(
+        *this, id, get_state_data(id), move(state_values));
+}
+
 const State &StateRegistry::get_initial_state() {
     if (!cached_initial_state) {
         int num_bins = get_bins_per_state();
         unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
-        // Avoid garbage values in half-full bins.
-        fill_n(buffer.get(), num_bins, 0);
 
         State initial_state = task_proxy.get_initial_state();
-        for (size_t i = 0; i < initial_state.size(); ++i) {
-            state_packer.set(buffer.get(), i, initial_state[i].get_value());
-        }
-        state_data_pool.push_back(buffer.get());
-        StateID id = insert_id_or_pop_state();
+        initial_state.unpack();
+        state_packer.pack_all(
+            initial_state.get_unpacked_values().data(), buffer.get());
+        push_state_data(buffer.get());
+        StateID id = insert_id_or_pop_state(compute_hash(buffer.get()));
         cached_initial_state = make_unique<State>(lookup_state(id));
     }
     return *cached_initial_state;
@@ -73,17 +235,19 @@ const State &StateRegistry::get_initial_state() {
 State StateRegistry::get_successor_state(
     const State &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
+    PROFILE_SCOPE(utils::ProfilerComponent::STATE_REGISTRATION);
     /*
       TODO: ideally, we would not modify state_data_pool here and in
       insert_id_or_pop_state, but only at one place, to avoid errors like
       buffer becoming a dangling pointer. This used to be a bug before being
       fixed in https://issues.fast-downward.org/issue1115.
     */
-    state_data_pool.push_back(predecessor.get_buffer());
-    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
+    assert(predecessor.get_registry() == this);
+    PackedStateBin *buffer = push_state_data(predecessor.get_buffer());
+    uint64_t hash = get_stored_hash(predecessor.get_id());
     /* Experiments for issue348 showed that for tasks with axioms it's faster
        to compute successor states using unpacked data. */
-    if (task_properties::has_axioms(task_proxy)) {
+    if (task_has_axioms) {
         predecessor.unpack();
         vector<int> new_values = predecessor.get_unpacked_values();
         for (EffectProxy effect : op.get_effects()) {
@@ -93,31 +257,98 @@ State StateRegistry::get_successor_state(
             }
         }
         axiom_evaluator.evaluate(new_values);
-        for (size_t i = 0; i < new_values.size(); ++i) {
-            state_packer.set(buffer, i, new_values[i]);
-        }
+        state_packer.pack_all(new_values.data(), buffer);
+        hash = update_hash(hash, predecessor.get_buffer(), buffer);
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
         */
-        StateID id = insert_id_or_pop_state();
-        return lookup_state(id, move(new_values));
+        StateID id = insert_id_or_pop_state(hash);
+        return create_new_state(id, move(new_values));
     } else {
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+        if (packed_effects_start.empty() && !state_packer.uses_mixed_radix()) {
+            /*
+              Many registries never generate successor states (e.g., the
+              registries of layered searches), so we compute the packed
+              effects on demand.
+            */
+            compute_packed_effects();
+        }
+        int op_id = op.get_id();
+        if (!has_packed_effects.empty() && has_packed_effects[op_id]) {
+            for (int i = packed_effects_start[op_id];
+                 i < packed_effects_start[op_id + 1]; ++i) {
+                const PackedEffect &effect = packed_effects[i];
+                PackedStateBin old_bin = buffer[effect.bin];
+                PackedStateBin new_bin =
+                    (old_bin & ~effect.write_mask) | effect.value_bits;
+                buffer[effect.bin] = new_bin;
+                hash ^= get_bin_hash(effect.bin, old_bin) ^
+                        get_bin_hash(effect.bin, new_bin);
+            }
+        } else {
+            for (EffectProxy effect : op.get_effects()) {
+                if (does_fire(effect, predecessor)) {
+                    FactPair effect_pair = effect.get_fact().get_pair();
+                    state_packer.set(
+                        buffer, effect_pair.var, effect_pair.value);
+                }
             }
+            hash = update_hash(hash, predecessor.get_buffer(), buffer);
         }
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
         */
-        StateID id = insert_id_or_pop_state();
-        return lookup_state(id);
+        StateID id = insert_id_or_pop_state(hash);
+        return create_new_state(id);
     }
 }
 
+State StateRegistry::register_state(const PackedStateBin *buffer) {
+    PROFILE_SCOPE(utils::ProfilerComponent::STATE_REGISTRATION);
+    push_state_data(buffer);
+    StateID id = insert_id_or_pop_state(compute_hash(buffer));
+    return create_new_state(id);
+}
+
+StateID StateRegistry::find_state(const PackedStateBin *buffer) const {
+    uint64_t hash = compute_hash(buffer);
+    int id = registered_states.find(fold_hash(hash), [&](int key) {
+        if (hash_compaction) {
+            return fingerprints[key] == hash;
+        }
+        const PackedStateBin *data = state_data_pool[key];
+        return equal(data, data + get_bins_per_state(), buffer);
+    });
+    return id == -1 ? StateID::no_state : StateID(id);
+}
+
+void StateRegistry::release_state_data(StateID id) {
+    assert(hash_compaction);
+    if (cached_initial_state && id == cached_initial_state->get_id()) {
+        return;
+    }
+    int &slot = state_slots[id.value];
+    if (slot != RELEASED) {
+        free_slot(slot);
+        slot = RELEASED;
+        ++num_released_states;
+    }
+}
+
+void StateRegistry::hold_freed_slots() {
+    assert(!is_holding_freed_slots);
+    is_holding_freed_slots = true;
+}
+
+void StateRegistry::reuse_held_slots() {
+    assert(is_holding_freed_slots);
+    free_slots.insert(free_slots.end(), held_slots.begin(), held_slots.end());
+    held_slots.clear();
+    is_holding_freed_slots = false;
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -129,4 +360,32 @@ int StateRegistry::get_state_size_in_bytes() const {
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics(log);
+    if (size() > 0) {
+        /*
+          Each bucket of the hash set stores a key and a hash (see
+          IntHashSet). We ignore the partially filled last segment of the
+          state data pool.
+        */
+        double hash_set_bytes = static_cast<double>(
+            registered_states.get_num_buckets() * 2 *
+            sizeof(int_hash_set::KeyType));
+        if (hash_compaction) {
+            double state_data_bytes = static_cast<double>(
+                state_data_pool.size() * get_state_size_in_bytes());
+            log << "Hash compaction: released the state data of "
+                << num_released_states << " state(s), "
+                << state_data_pool.size() << " state data slot(s) allocated"
+                << endl;
+            log << "Bytes per registered state: " << state_data_bytes / size()
+                << " (state data) + "
+                << sizeof(uint64_t) + sizeof(int)
+                << " (fingerprint and slot) + " << hash_set_bytes / size()
+                << " (hash set)" << endl;
+        } else {
+            log << "Bytes per registered state: " << get_state_size_in_bytes()
+                << " (state data) + " << sizeof(int_hash_set::HashType)
+                << " (stored hash) + " << hash_set_bytes / size()
+                << " (hash set)" << endl;
+        }
+    }
 }
@@ -11,7 +11,9 @@
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include <cstdint>
 #include <set>
+#include <vector>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -58,6 +60,27 @@
     This class is used to store the actual (packed) state data for all states
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
+    The registry additionally stores the hash of each state. The hash of a
+    successor state is derived from the hash of its predecessor by only
+    rehashing the modified bins.
+
+    With hash compaction (command-line option --hash-compaction), the
+    registry stores a 64-bit fingerprint for each state and considers two
+    states equal if their fingerprints are equal. Different states with
+    equal fingerprints are wrongly treated as duplicates, which can make the
+    search incomplete or lead to invalid plans, but this is very unlikely.
+    Since states are no longer compared by their data, the search can
+    release the data of states it does not need anymore (e.g., closed states
+    that are never reopened). The state data is then stored in slots that are
+    reused for new states, while the IDs stay valid: looking up a released
+    state yields a state without data, which can still be used to access
+    per-state information (e.g., to trace the plan).
+
+  ConcurrentStateRegistry
+    A thread-safe variant of StateRegistry for registering and looking up
+    states from several threads at once. It stores the state data in a
+    ConcurrentSegmentedArrayVector and its IDs in a ConcurrentIntHashSet.
+    It cannot be used with PerStateInformation.
 
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
@@ -79,19 +102,21 @@
 
   Solution:
 
-    SearchNodeInfo
-      Remaining part of a search node besides the state that needs to be stored.
+    SearchNodeInfoLayout
+      Describes how the remaining part of a search node besides the state is
+      stored in an array of ints. The layout depends on the task, so only
+      the information that cannot be derived otherwise needs to be stored.
 
     SearchNode
-      A SearchNode combines a StateID, a reference to a SearchNodeInfo and
-      OperatorCost. It is generated for easier access and not intended for long
-      term storage. The state data is only stored once an can be accessed
-      through the StateID.
+      A SearchNode combines a State, a view of its search node information
+      and the SearchSpace. It is generated for easier access and not
+      intended for long term storage. The state data is only stored once an
+      can be accessed through the StateID.
 
     SearchSpace
-      The SearchSpace uses PerStateInformation<SearchNodeInfo> to map StateIDs
-  to SearchNodeInfos. The open lists only have to store StateIDs which can be
-      used to look up a search node in the SearchSpace on demand.
+      The SearchSpace uses PerStateArray<int> to map StateIDs to the search
+      node information. The open lists only have to store StateIDs which can
+      be used to look up a search node in the SearchSpace on demand.
 
   ---------------
   Usage example 2
@@ -111,43 +136,46 @@ class IntPacker;
 
 using PackedStateBin = int_packer::IntPacker::Bin;
 
+/*
+  Set by the command-line option --hash-compaction before any state registry
+  is created.
+*/
+extern bool g_hash_compaction;
+
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    /*
+      The hash of a state is computed once when the state is generated (see
+      compute_hash() and update_hash()) and stored in state_hashes or, with
+      hash compaction, in fingerprints.
+    */
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin>
-            &state_data_pool;
-        int state_size;
-        StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin>
-                &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool), state_size(state_size) {
+        const StateRegistry &registry;
+        explicit StateIDSemanticHash(const StateRegistry &registry)
+            : registry(registry) {
         }
 
         int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
+            if (registry.hash_compaction) {
+                return fold_hash(registry.fingerprints[id]);
             }
-            return hash_state.get_hash32();
+            return registry.state_hashes[id];
         }
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin>
-            &state_data_pool;
-        int state_size;
-        StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin>
-                &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool), state_size(state_size) {
+        const StateRegistry &registry;
+        explicit StateIDSemanticEqual(const StateRegistry &registry)
+            : registry(registry) {
         }
 
         bool operator()(int lhs, int rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs];
-            const PackedStateBin *rhs_data = state_data_pool[rhs];
-            return std::equal(lhs_data, lhs_data + state_size, rhs_data);
+            if (registry.hash_compaction) {
+                return registry.fingerprints[lhs] == registry.fingerprints[rhs];
+            }
+            const PackedStateBin *lhs_data = registry.state_data_pool[lhs];
+            const PackedStateBin *rhs_data = registry.state_data_pool[rhs];
+            return std::equal(
+                lhs_data, lhs_data + registry.get_bins_per_state(), rhs_data);
         }
     };
 
@@ -159,18 +187,78 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     using StateIDSet =
         int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
 
+    /*
+      Change of one bin of the packed state data caused by applying an
+      operator: bin = (bin & ~write_mask) | value_bits.
+    */
+    struct PackedEffect {
+        int bin;
+        PackedStateBin write_mask;
+        PackedStateBin value_bits;
+    };
+
+    static const int RELEASED = -1;
+
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
+    const bool task_has_axioms;
+    const bool hash_compaction;
 
+    /*
+      For tasks without axioms and without mixed-radix bins, we compute the
+      packed effects of all operators without conditional effects when the
+      first successor state is generated, so successor states can be
+      generated with one word operation per modified bin. The packed effects
+      of operator i are stored in packed_effects[packed_effects_start[i]] to
+      packed_effects[packed_effects_start[i + 1] - 1]. Operators with
+      conditional effects (and all operators if the vectors are empty) use
+      the generic code path.
+    */
+    std::vector<PackedEffect> packed_effects;
+    std::vector<int> packed_effects_start;
+    std::vector<bool> has_packed_effects;
+
+    /*
+      Without hash compaction, the data of the state with ID i is stored at
+      index i of state_data_pool. With hash compaction, it is stored at index
+      state_slots[i] (or RELEASED), and the indices of released data are
+      kept in free_slots for reuse. Slots that are freed while
+      is_holding_freed_slots is true are kept in held_slots instead.
+      new_state_slot is the index of the data of the state that is currently
+      being registered.
+    */
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    segmented_vector::SegmentedVector<int_hash_set::HashType> state_hashes;
+    segmented_vector::SegmentedVector<std::uint64_t> fingerprints;
+    segmented_vector::SegmentedVector<int> state_slots;
+    std::vector<int> free_slots;
+    std::vector<int> held_slots;
+    bool is_holding_freed_slots;
+    int new_state_slot;
+    int num_released_states;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
 
-    StateID insert_id_or_pop_state();
+    static int_hash_set::HashType fold_hash(std::uint64_t hash) {
+        return static_cast<int_hash_set::HashType>(hash ^ (hash >> 32));
+    }
+
+    PackedStateBin *push_state_data(const PackedStateBin *buffer);
+    void free_slot(int slot);
+    StateID insert_id_or_pop_state(std::uint64_t hash);
+    const PackedStateBin *get_state_data(StateID id) const;
+    State create_new_state(StateID id) const;
+    State create_new_state(StateID id, std::vector<int> &&state_values) const;
     int get_bins_per_state() const;
+    std::uint64_t get_stored_hash(StateID id) const;
+    std::uint64_t compute_hash(const PackedStateBin *buffer) const;
+    std::uint64_t update_hash(
+        std::uint64_t hash, const PackedStateBin *old_buffer,
+        const PackedStateBin *new_buffer) const;
+    void compute_packed_effects();
 public:
     explicit StateRegistry(const TaskProxy &task_proxy);
 
@@ -215,6 +303,45 @@ public:
     State get_successor_state(
         const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The buffer must have been packed with this
+      registry's state packer (e.g., by another registry for the same task)
+      and is copied, so the caller keeps ownership of it.
+    */
+    State register_state(const PackedStateBin *buffer);
+
+    /*
+      Returns the ID of the registered state with the given packed data, or
+      StateID::no_state if there is no such state. Does not register the
+      state.
+    */
+    StateID find_state(const PackedStateBin *buffer) const;
+
+    bool uses_hash_compaction() const {
+        return hash_compaction;
+    }
+
+    /*
+      With hash compaction, release the data of the given state, so that its
+      memory can be reused for new states. Afterwards, lookup_state() returns
+      a state without data for this ID, which can only be used to access
+      per-state information. If the state is generated again, the returned
+      state has data, but it is only valid until the next state is generated
+      or registered (see hold_freed_slots()). The data of the initial state
+      is never released.
+    */
+    void release_state_data(StateID id);
+
+    /*
+      With hash compaction, slots that are freed between hold_freed_slots()
+      and reuse_held_slots() are only reused afterwards, so that the data of
+      all states generated in between stays valid. This allows generating
+      all successors of a state before processing them.
+    */
+    void hold_freed_slots();
+    void reuse_held_slots();
+
     /*
       Returns the number of states registered so far.
     */
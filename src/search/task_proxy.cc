@@ -6,6 +6,7 @@
 #include "task_utils/causal_graph.h"
 #include "task_utils/task_properties.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -17,11 +18,11 @@ State::State(
       registry(&registry),
       id(id),
       buffer(buffer),
-      values(nullptr),
+      values(),
       state_packer(&registry.get_state_packer()),
       num_variables(registry.get_num_variables()) {
+    // The buffer is null if the registry released the data of the state.
     assert(id != StateID::no_state);
-    assert(buffer);
     assert(num_variables == task.get_num_variables());
 }
 
@@ -30,15 +31,19 @@ State::State(
     const PackedStateBin *buffer, vector<int> &&values)
     : State(task, registry, id, buffer) {
     assert(num_variables == static_cast<int>(values.size()));
-    this->values = make_shared<vector<int>>(move(values));
+    this->values = PooledStateValues::create(move(values));
 }
 
 State::State(const AbstractTask &task, vector<int> &&values)
+    : State(task, PooledStateValues::create(move(values))) {
+}
+
+State::State(const AbstractTask &task, PooledStateValues &&values)
     : task(&task),
       registry(nullptr),
       id(StateID::no_state),
       buffer(nullptr),
-      values(make_shared<vector<int>>(move(values))),
+      values(move(values)),
       state_packer(nullptr),
       num_variables(this->values->size()) {
     assert(num_variables == task.get_num_variables());
@@ -48,7 +53,10 @@ State State::get_unregistered_successor(const OperatorProxy &op) const {
     assert(!op.is_axiom());
     assert(task_properties::is_applicable(op, *this));
     assert(values);
-    vector<int> new_values = get_unpacked_values();
+    PooledStateValues successor_values = PooledStateValues::create(
+        num_variables);
+    vector<int> &new_values = successor_values.get_values_for_initialization();
+    copy(values->begin(), values->end(), new_values.begin());
 
     for (EffectProxy effect : op.get_effects()) {
         if (does_fire(effect, *this)) {
@@ -61,7 +69,7 @@ State State::get_unregistered_successor(const OperatorProxy &op) const {
         AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*task)];
         axiom_evaluator.evaluate(new_values);
     }
-    return State(*task, move(new_values));
+    return State(*task, move(successor_values));
 }
 
 const causal_graph::CausalGraph &TaskProxy::get_causal_graph() const {
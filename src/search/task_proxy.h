@@ -3,6 +3,7 @@
 
 #include "abstract_task.h"
 #include "operator_id.h"
+#include "pooled_state_values.h"
 #include "state_id.h"
 #include "task_id.h"
 
@@ -580,9 +581,12 @@ class State {
       const here to mean "const from the perspective of the state space
       semantics of the state".
     */
-    mutable std::shared_ptr<std::vector<int>> values;
+    mutable PooledStateValues values;
     const int_packer::IntPacker *state_packer;
     int num_variables;
+
+    friend class TaskProxy;
+    State(const AbstractTask &task, PooledStateValues &&values);
 public:
     using ItemType = FactProxy;
 
@@ -721,10 +725,12 @@ public:
         TaskProxy ancestor_task_proxy = ancestor_state.get_task();
         // Create a copy of the state values for the new state.
         ancestor_state.unpack();
-        std::vector<int> state_values = ancestor_state.get_unpacked_values();
+        PooledStateValues values = PooledStateValues::create(0);
+        std::vector<int> &state_values = values.get_values_for_initialization();
+        state_values = ancestor_state.get_unpacked_values();
         task->convert_ancestor_state_values(
             state_values, ancestor_task_proxy.task);
-        return create_state(std::move(state_values));
+        return State(*task, std::move(values));
     }
 
     const causal_graph::CausalGraph &get_causal_graph() const;
@@ -785,15 +791,12 @@ inline void State::unpack() const {
           more obvious reserve/push_back. Although, the benchmark did not
           profile this specific code.
 
-          We might consider a bulk-unpack method in state_packer that could be
-          more efficient. (One can imagine state packer to have extra data
-          structures that exploit sequentially unpacking each entry, by doing
-          things bin by bin.)
+          The state packer unpacks all variables at once, which is much faster
+          than unpacking them one by one.
         */
-        values = std::make_shared<std::vector<int>>(num_variables);
-        for (int var = 0; var < num_variables; ++var) {
-            (*values)[var] = state_packer->get(buffer, var);
-        }
+        values = PooledStateValues::create(num_variables);
+        state_packer->unpack_all(
+            get_buffer(), values.get_values_for_initialization().data());
     }
 }
 
@@ -835,8 +838,9 @@ inline const PackedStateBin *State::get_buffer() const {
       not costly, but the 'cerr <<' stuff might prevent inlining.
     */
     if (!buffer) {
-        std::cerr << "Accessing the packed values of an unregistered state is "
-                  << "treated as an error." << std::endl;
+        std::cerr << "Accessing the packed values of an unregistered state "
+                  << "or a state whose data was released is treated as an "
+                  << "error." << std::endl;
         utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
     }
     return buffer;
@@ -110,6 +110,7 @@ void print_variable_statistics(const TaskProxy &task_proxy) {
     utils::g_log << "Bytes per state: "
                  << state_packer.get_num_bins() *
                         sizeof(int_packer::IntPacker::Bin)
+                 << (state_packer.uses_mixed_radix() ? " (mixed-radix bins)" : "")
                  << endl;
 }
 
@@ -166,6 +167,8 @@ void dump_task(const TaskProxy &task_proxy) {
     dump_goals(task_proxy.get_goals());
 }
 
+bool g_compress_states = false;
+
 PerTaskInformation<int_packer::IntPacker> g_state_packers(
     [](const TaskProxy &task_proxy) {
         VariablesProxy variables = task_proxy.get_variables();
@@ -174,6 +177,7 @@ PerTaskInformation<int_packer::IntPacker> g_state_packers(
         for (VariableProxy var : variables) {
             variable_ranges.push_back(var.get_domain_size());
         }
-        return make_unique<int_packer::IntPacker>(variable_ranges);
+        return make_unique<int_packer::IntPacker>(
+            variable_ranges, g_compress_states);
     });
 }
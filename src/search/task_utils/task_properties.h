@@ -82,6 +82,12 @@ extern void dump_fdr(const State &state);
 extern void dump_goals(const GoalsProxy &goals);
 extern void dump_task(const TaskProxy &task_proxy);
 
+/*
+  If set before the state packer of a task is created, states are packed
+  into mixed-radix bins (see IntPacker), which needs less memory per state
+  but makes accessing packed states slower.
+*/
+extern bool g_compress_states;
 extern PerTaskInformation<int_packer::IntPacker> g_state_packers;
 }
 
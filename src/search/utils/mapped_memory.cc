@@ -0,0 +1,235 @@
+#include "mapped_memory.h"
+
+#include "logging.h"
+#include "system.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+#if OPERATING_SYSTEM != WINDOWS
+static const size_t CHUNK_BYTES = 16 * 1024 * 1024;
+static const size_t ALIGNMENT = alignof(max_align_t);
+
+class MappedMemoryPool {
+    struct Chunk {
+        char *data;
+        size_t size;
+    };
+
+    const size_t resident_budget;
+    int fd;
+    size_t file_size;
+    vector<Chunk> chunks;
+    // Maps the start address of each chunk to its index in chunks.
+    map<const char *, size_t> chunk_index_by_address;
+    char *next_free;
+    size_t remaining_bytes;
+    unordered_map<size_t, vector<char *>> free_blocks;
+    size_t num_resident_chunks;
+    size_t next_cold_chunk;
+    size_t num_page_outs;
+    mutex pool_mutex;
+
+    NO_RETURN
+    void fail(const string &msg) const {
+        cerr << "Mapped memory: " << msg << ": " << strerror(errno) << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+
+    void page_out(const Chunk &chunk) {
+#ifdef MADV_PAGEOUT
+        int result = madvise(chunk.data, chunk.size, MADV_PAGEOUT);
+#else
+        int result = msync(chunk.data, chunk.size, MS_ASYNC);
+        if (result == 0) {
+            result = madvise(chunk.data, chunk.size, MADV_DONTNEED);
+        }
+#endif
+        /* Paging out is only an optimization, so we ignore failures (e.g.,
+           if the kernel does not support MADV_PAGEOUT). */
+        if (result == 0) {
+            ++num_page_outs;
+        }
+    }
+
+    /*
+      Page out the chunk that just left the resident window and one further
+      cold chunk in round-robin order, since cold chunks are paged in again
+      when they are accessed.
+    */
+    void page_out_cold_chunks() {
+        if (chunks.size() <= num_resident_chunks) {
+            return;
+        }
+        size_t num_cold_chunks = chunks.size() - num_resident_chunks;
+        page_out(chunks[num_cold_chunks - 1]);
+        if (num_cold_chunks > 1) {
+            next_cold_chunk %= num_cold_chunks - 1;
+            page_out(chunks[next_cold_chunk++]);
+        }
+    }
+
+    char *map_chunk(size_t size) {
+        if (ftruncate(fd, file_size + size) != 0) {
+            fail("could not extend file");
+        }
+        void *data = mmap(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, file_size);
+        if (data == MAP_FAILED) {
+            fail("could not map file");
+        }
+        file_size += size;
+        chunk_index_by_address[static_cast<char *>(data)] = chunks.size();
+        chunks.push_back({static_cast<char *>(data), size});
+        page_out_cold_chunks();
+        return static_cast<char *>(data);
+    }
+
+    const Chunk *find_chunk(const char *ptr) const {
+        auto it = chunk_index_by_address.upper_bound(ptr);
+        if (it == chunk_index_by_address.begin()) {
+            return nullptr;
+        }
+        const Chunk &chunk = chunks[prev(it)->second];
+        if (ptr < chunk.data + chunk.size) {
+            return &chunk;
+        }
+        return nullptr;
+    }
+
+public:
+    MappedMemoryPool(size_t resident_budget, const string &directory)
+        : resident_budget(resident_budget),
+          fd(-1),
+          file_size(0),
+          next_free(nullptr),
+          remaining_bytes(0),
+          num_resident_chunks(max(resident_budget / CHUNK_BYTES, size_t(1))),
+          next_cold_chunk(0),
+          num_page_outs(0) {
+        string path = directory + "/downward-mapped-memory-XXXXXX";
+        vector<char> path_buffer(path.begin(), path.end());
+        path_buffer.push_back('\0');
+        fd = mkstemp(path_buffer.data());
+        if (fd == -1) {
+            fail("could not create file in " + directory);
+        }
+        // The file is removed as soon as the planner terminates.
+        unlink(path_buffer.data());
+    }
+
+    void *allocate(size_t num_bytes) {
+        size_t size = (num_bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        lock_guard<mutex> lock(pool_mutex);
+        auto it = free_blocks.find(size);
+        if (it != free_blocks.end() && !it->second.empty()) {
+            char *block = it->second.back();
+            it->second.pop_back();
+            return block;
+        }
+        if (size > CHUNK_BYTES) {
+            size_t page_size = sysconf(_SC_PAGESIZE);
+            return map_chunk((size + page_size - 1) / page_size * page_size);
+        }
+        if (size > remaining_bytes) {
+            next_free = map_chunk(CHUNK_BYTES);
+            remaining_bytes = CHUNK_BYTES;
+        }
+        char *block = next_free;
+        next_free += size;
+        remaining_bytes -= size;
+        return block;
+    }
+
+    bool deallocate(void *ptr, size_t num_bytes) {
+        char *block = static_cast<char *>(ptr);
+        size_t size = (num_bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        lock_guard<mutex> lock(pool_mutex);
+        if (!find_chunk(block)) {
+            return false;
+        }
+        // Blocks are reused for allocations of the same size.
+        free_blocks[size].push_back(block);
+        return true;
+    }
+
+    void print_statistics(LogProxy &log) {
+        lock_guard<mutex> lock(pool_mutex);
+        log << "Mapped memory: " << file_size / 1024 << " KB in "
+            << chunks.size() << " chunk(s), resident budget "
+            << resident_budget / 1024 << " KB" << endl;
+        log << "Mapped memory page-outs: " << num_page_outs << endl;
+    }
+};
+
+/*
+  The pool is never destroyed because segments might be deallocated during
+  static destruction. The operating system unmaps the file on exit.
+*/
+static MappedMemoryPool *mapped_memory_pool = nullptr;
+
+void enable_mapped_memory(
+    int resident_budget_in_mb, const string &directory) {
+    assert(!mapped_memory_pool);
+    mapped_memory_pool = new MappedMemoryPool(
+        static_cast<size_t>(resident_budget_in_mb) * 1024 * 1024, directory);
+}
+
+bool mapped_memory_is_enabled() {
+    return mapped_memory_pool;
+}
+
+void *allocate_mapped_memory(size_t num_bytes) {
+    assert(mapped_memory_pool);
+    return mapped_memory_pool->allocate(num_bytes);
+}
+
+bool deallocate_mapped_memory(void *ptr, size_t num_bytes) {
+    if (!mapped_memory_pool) {
+        return false;
+    }
+    return mapped_memory_pool->deallocate(ptr, num_bytes);
+}
+
+void print_mapped_memory_statistics(LogProxy &log) {
+    if (mapped_memory_pool) {
+        mapped_memory_pool->print_statistics(log);
+    }
+}
+#else
+void enable_mapped_memory(int, const string &) {
+    cerr << "Mapped memory is not supported on Windows." << endl;
+    utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+bool mapped_memory_is_enabled() {
+    return false;
+}
+
+void *allocate_mapped_memory(size_t) {
+    ABORT("Mapped memory is not supported on Windows.");
+    return nullptr;
+}
+
+bool deallocate_mapped_memory(void *, size_t) {
+    return false;
+}
+
+void print_mapped_memory_statistics(LogProxy &) {
+}
+#endif
+}
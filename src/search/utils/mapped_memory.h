@@ -0,0 +1,82 @@
+#ifndef UTILS_MAPPED_MEMORY_H
+#define UTILS_MAPPED_MEMORY_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace utils {
+class LogProxy;
+
+/*
+  Memory-mapped storage for large, append-only data structures such as the
+  segments of SegmentedVector and SegmentedArrayVector, which hold the state
+  data of state registries and all per-state information.
+
+  Once enabled, memory is allocated in chunks that are mapped from an
+  (unlinked) temporary file in the given directory. Whenever the mapped memory
+  exceeds the resident budget, we advise the kernel to write the oldest chunks
+  back to the file and drop them from RAM. They are paged in again on demand.
+  Since older states are accessed much less frequently than recent ones in
+  most searches, this keeps the working set in RAM at a modest slowdown.
+
+  Note that mapped memory counts towards the address space of the process.
+  When using this feature, the memory limit of the planner (which limits the
+  address space) has to account for the mapped file, while the resident
+  budget limits the RAM usage.
+
+  Mapped memory has to be enabled before the search allocates per-state
+  data. Allocation and deallocation are thread-safe.
+*/
+extern void enable_mapped_memory(
+    int resident_budget_in_mb, const std::string &directory);
+extern bool mapped_memory_is_enabled();
+extern void *allocate_mapped_memory(size_t num_bytes);
+/*
+  Return false if ptr was not allocated with allocate_mapped_memory(), in
+  which case the memory is not released.
+*/
+extern bool deallocate_mapped_memory(void *ptr, size_t num_bytes);
+extern void print_mapped_memory_statistics(LogProxy &log);
+
+/*
+  Allocator that uses mapped memory if it is enabled and the standard
+  allocator otherwise.
+*/
+template<typename T>
+class MappedAllocator {
+public:
+    using value_type = T;
+
+    MappedAllocator() = default;
+
+    template<typename U>
+    MappedAllocator(const MappedAllocator<U> &) {
+    }
+
+    T *allocate(size_t n) {
+        if (mapped_memory_is_enabled()) {
+            return static_cast<T *>(allocate_mapped_memory(n * sizeof(T)));
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        if (!deallocate_mapped_memory(ptr, n * sizeof(T))) {
+            std::allocator<T>().deallocate(ptr, n);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const MappedAllocator<U> &) const {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const MappedAllocator<U> &) const {
+        return false;
+    }
+};
+}
+
+#endif
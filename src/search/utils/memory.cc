@@ -1,9 +1,12 @@
 #include "memory.h"
 
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -37,4 +40,105 @@ void release_extra_memory_padding() {
 bool extra_memory_padding_is_reserved() {
     return extra_memory_padding;
 }
+
+static const int NUM_MEMORY_PRESSURE_STAGES = 3;
+// Fraction of the memory budget at which each stage fires.
+static const double STAGE_THRESHOLDS[NUM_MEMORY_PRESSURE_STAGES] = {
+    0.8, 0.9, 1.0};
+static const char *STAGE_NAMES[NUM_MEMORY_PRESSURE_STAGES] = {
+    "drop caches", "compact data structures", "stop search"};
+// Querying the memory usage reads a file on Linux, so we do it rarely.
+static const int POLL_INTERVAL = 4096;
+
+static vector<const MemoryPressureHook *> memory_pressure_hooks;
+static int memory_budget_in_kb = -1;
+static int next_stage = 0;
+static int num_polls_since_check = 0;
+// Memory usage at which memory_budget_is_exhausted() returned true.
+static int exhausted_memory_in_kb = -1;
+
+MemoryPressureHook::MemoryPressureHook(
+    MemoryPressureStage stage, const string &description,
+    const function<void()> &callback)
+    : stage(stage), description(description), callback(callback) {
+    memory_pressure_hooks.push_back(this);
+}
+
+MemoryPressureHook::~MemoryPressureHook() {
+    auto it = find(
+        memory_pressure_hooks.begin(), memory_pressure_hooks.end(), this);
+    assert(it != memory_pressure_hooks.end());
+    memory_pressure_hooks.erase(it);
+}
+
+void set_memory_budget(int memory_in_mb) {
+    assert(memory_in_mb >= 0);
+    memory_budget_in_kb = memory_in_mb * 1024;
+    next_stage = 0;
+    num_polls_since_check = 0;
+}
+
+bool has_memory_budget() {
+    return memory_budget_in_kb != -1;
+}
+
+static void fire_memory_pressure_stage(int stage, int memory_in_kb) {
+    g_log << "Memory usage of " << memory_in_kb << " KB exceeds "
+          << static_cast<int>(STAGE_THRESHOLDS[stage] * 100)
+          << "% of the memory budget: " << STAGE_NAMES[stage] << endl;
+    bool found_hook = false;
+    for (const MemoryPressureHook *hook : memory_pressure_hooks) {
+        if (static_cast<int>(hook->get_stage()) == stage) {
+            g_log << "Memory pressure hook: " << hook->get_description()
+                  << endl;
+            hook->fire();
+            found_hook = true;
+        }
+    }
+    if (!found_hook) {
+        g_log << "No memory pressure hooks registered for this stage."
+              << endl;
+    }
+}
+
+void poll_memory_budget() {
+    if (memory_budget_in_kb == -1 ||
+        next_stage == NUM_MEMORY_PRESSURE_STAGES ||
+        ++num_polls_since_check < POLL_INTERVAL) {
+        return;
+    }
+    num_polls_since_check = 0;
+    int memory_in_kb = get_current_memory_in_kb();
+    if (memory_in_kb == -1) {
+        g_log << "Disabling the memory budget." << endl;
+        memory_budget_in_kb = -1;
+        return;
+    }
+    while (next_stage < NUM_MEMORY_PRESSURE_STAGES &&
+           memory_in_kb >= STAGE_THRESHOLDS[next_stage] * memory_budget_in_kb) {
+        fire_memory_pressure_stage(next_stage, memory_in_kb);
+        ++next_stage;
+    }
+}
+
+bool memory_budget_is_exhausted() {
+    if (memory_budget_in_kb == -1 ||
+        next_stage == NUM_MEMORY_PRESSURE_STAGES) {
+        return false;
+    }
+    int memory_in_kb = get_current_memory_in_kb();
+    if (memory_in_kb == -1 || memory_in_kb < memory_budget_in_kb) {
+        return false;
+    }
+    exhausted_memory_in_kb = memory_in_kb;
+    return true;
+}
+
+void fire_remaining_memory_pressure_stages() {
+    assert(exhausted_memory_in_kb != -1);
+    while (next_stage < NUM_MEMORY_PRESSURE_STAGES) {
+        fire_memory_pressure_stage(next_stage, exhausted_memory_in_kb);
+        ++next_stage;
+    }
+}
 }
@@ -1,6 +1,9 @@
 #ifndef UTILS_MEMORY_H
 #define UTILS_MEMORY_H
 
+#include <functional>
+#include <string>
+
 namespace utils {
 /*
   Reserve some memory that we can release and be able to continue
@@ -15,6 +18,87 @@ namespace utils {
 extern void reserve_extra_memory_padding(int memory_in_mb);
 extern void release_extra_memory_padding();
 extern bool extra_memory_padding_is_reserved();
+
+/*
+  Memory budget: instead of running until an allocation fails, the planner
+  can degrade gracefully when its memory usage approaches a given budget
+  (see the --memory-budget option). Components register memory pressure
+  hooks for one of the degradation stages below. During the search, the
+  memory usage is checked regularly (see poll_memory_budget()). When it
+  exceeds the threshold of a stage, the hooks of this stage (and of all
+  earlier stages that have not fired yet) are called once, in the order of
+  their registration.
+
+  The stages free memory in increasingly drastic ways:
+    DROP_CACHES: discard information that can be recomputed, such as
+      cached heuristic values (at 80% of the budget). Heuristics keep
+      their caches if a search algorithm relies on them (see
+      Evaluator::keep_cached_estimates()).
+    COMPACT_DATA_STRUCTURES: release unused capacity, for example of open
+      lists (at 90% of the budget).
+    STOP_SEARCH: stop the running search algorithms, which keeps the plans
+      found so far and lets memory_fallback() continue with a search
+      algorithm with bounded memory usage (at 100% of the budget).
+
+  The budget should be somewhat below the actual memory limit, because
+  freed memory cannot always be returned to the operating system and
+  hooks may need memory themselves.
+*/
+enum class MemoryPressureStage {
+    DROP_CACHES,
+    COMPACT_DATA_STRUCTURES,
+    STOP_SEARCH
+};
+
+/*
+  A MemoryPressureHook is registered while it exists, so objects that
+  register hooks should store them as members. The callback must not
+  create or destroy hooks.
+*/
+class MemoryPressureHook {
+    MemoryPressureStage stage;
+    std::string description;
+    std::function<void()> callback;
+public:
+    MemoryPressureHook(
+        MemoryPressureStage stage, const std::string &description,
+        const std::function<void()> &callback);
+    ~MemoryPressureHook();
+
+    MemoryPressureHook(const MemoryPressureHook &) = delete;
+    MemoryPressureHook &operator=(const MemoryPressureHook &) = delete;
+
+    MemoryPressureStage get_stage() const {
+        return stage;
+    }
+
+    const std::string &get_description() const {
+        return description;
+    }
+
+    void fire() const {
+        callback();
+    }
+};
+
+extern void set_memory_budget(int memory_in_mb);
+extern bool has_memory_budget();
+/*
+  Check the memory usage and fire the hooks of the stages whose threshold
+  is exceeded. This is cheap enough to call after every search step: the
+  memory usage is only queried every few thousand calls.
+*/
+extern void poll_memory_budget();
+/*
+  Return true if the memory usage has reached the budget and the
+  STOP_SEARCH stage has not fired yet. Unlike poll_memory_budget(), this
+  queries the memory usage on every call and does not fire any hooks, so
+  multi-threaded search algorithms can call it while their threads run.
+  Once the threads have stopped, they must call
+  fire_remaining_memory_pressure_stages().
+*/
+extern bool memory_budget_is_exhausted();
+extern void fire_remaining_memory_pressure_stages();
 }
 
 #endif
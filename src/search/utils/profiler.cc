@@ -0,0 +1,181 @@
+#include "profiler.h"
+
+#include "logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_USE_TSC
+#endif
+
+using namespace std;
+
+namespace utils {
+static uint64_t read_ticks() {
+#ifdef PROFILER_USE_TSC
+    return __rdtsc();
+#else
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/*
+  We convert ticks to seconds by comparing the ticks and the steady clock
+  at program start and when printing the profile.
+*/
+static const chrono::steady_clock::time_point start_time =
+    chrono::steady_clock::now();
+static const uint64_t start_ticks = read_ticks();
+
+struct ComponentProfile {
+    long long num_calls = 0;
+    uint64_t self_ticks = 0;
+};
+
+struct ThreadProfile {
+    vector<ComponentProfile> components;
+    ProfilerScope *current_scope = nullptr;
+};
+
+/*
+  Data shared between threads. Profiles of threads are never deleted, so
+  that we can print them after the threads have finished.
+*/
+struct Profiler {
+    mutex profiler_mutex;
+    vector<string> component_names = {
+        "successor generation", "state registration", "pruning", "open list"};
+    vector<unique_ptr<ThreadProfile>> thread_profiles;
+};
+
+static Profiler &get_profiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+static ThreadProfile &get_thread_profile() {
+    static thread_local ThreadProfile *thread_profile = nullptr;
+    if (!thread_profile) {
+        Profiler &profiler = get_profiler();
+        lock_guard<mutex> lock(profiler.profiler_mutex);
+        profiler.thread_profiles.push_back(make_unique<ThreadProfile>());
+        thread_profile = profiler.thread_profiles.back().get();
+    }
+    return *thread_profile;
+}
+
+int register_profiler_component(const string &name) {
+    Profiler &profiler = get_profiler();
+    lock_guard<mutex> lock(profiler.profiler_mutex);
+    vector<string> &names = profiler.component_names;
+    auto it = find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return it - names.begin();
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+ProfilerScope::ProfilerScope(int component)
+    : component(component), nested_ticks(0) {
+    ThreadProfile &profile = get_thread_profile();
+    parent = profile.current_scope;
+    profile.current_scope = this;
+    start = read_ticks();
+}
+
+ProfilerScope::~ProfilerScope() {
+    uint64_t ticks = read_ticks() - start;
+    ThreadProfile &profile = get_thread_profile();
+    if (component >= static_cast<int>(profile.components.size())) {
+        profile.components.resize(component + 1);
+    }
+    ComponentProfile &component_profile = profile.components[component];
+    ++component_profile.num_calls;
+    component_profile.self_ticks += ticks - nested_ticks;
+    if (parent) {
+        parent->nested_ticks += ticks;
+    }
+    profile.current_scope = parent;
+}
+
+void print_profile(LogProxy &log) {
+    double elapsed_seconds =
+        chrono::duration<double>(chrono::steady_clock::now() - start_time)
+            .count();
+    double seconds_per_tick =
+        elapsed_seconds / static_cast<double>(read_ticks() - start_ticks);
+
+    Profiler &profiler = get_profiler();
+    lock_guard<mutex> lock(profiler.profiler_mutex);
+    int num_components = profiler.component_names.size();
+    vector<ComponentProfile> totals(num_components);
+    for (const auto &thread_profile : profiler.thread_profiles) {
+        const vector<ComponentProfile> &components =
+            thread_profile->components;
+        for (size_t component = 0; component < components.size();
+             ++component) {
+            totals[component].num_calls += components[component].num_calls;
+            totals[component].self_ticks += components[component].self_ticks;
+        }
+    }
+
+    size_t name_width = 12;
+    double profiled_seconds = 0;
+    for (int component = 0; component < num_components; ++component) {
+        if (totals[component].num_calls > 0) {
+            name_width = max(
+                name_width, profiler.component_names[component].size());
+            profiled_seconds +=
+                totals[component].self_ticks * seconds_per_tick;
+        }
+    }
+    if (profiled_seconds == 0) {
+        return;
+    }
+
+    auto print_row = [&](const string &name, const string &calls,
+                         double seconds, const string &time_per_call) {
+        char row[64];
+        snprintf(
+            row, sizeof(row), "%12s %12.6fs %6.2f%%", calls.c_str(), seconds,
+            100 * seconds / elapsed_seconds);
+        log << name << string(name_width - name.size(), ' ') << " " << row;
+        if (!time_per_call.empty()) {
+            snprintf(row, sizeof(row), " %12s", time_per_call.c_str());
+            log << row;
+        }
+        log << endl;
+    };
+
+    log << "Profile (self time of each component, relative to the total "
+        << "time of " << elapsed_seconds << "s):" << endl;
+    for (int component = 0; component < num_components; ++component) {
+        const ComponentProfile &total = totals[component];
+        if (total.num_calls == 0) {
+            continue;
+        }
+        double seconds = total.self_ticks * seconds_per_tick;
+        char time_per_call[32];
+        snprintf(
+            time_per_call, sizeof(time_per_call), "%.0fns/call",
+            1e9 * seconds / total.num_calls);
+        print_row(
+            profiler.component_names[component], to_string(total.num_calls),
+            seconds, time_per_call);
+    }
+    print_row(
+        "unattributed", "", max(0.0, elapsed_seconds - profiled_seconds), "");
+}
+}
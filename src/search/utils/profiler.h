@@ -0,0 +1,71 @@
+#ifndef UTILS_PROFILER_H
+#define UTILS_PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+namespace utils {
+class LogProxy;
+
+/*
+  Low-overhead profiler that attributes the time of the planner to its
+  components, e.g., successor generation or the computation of each
+  evaluator. It is compiled in with the CMake option USE_PROFILER. Otherwise,
+  the PROFILE_SCOPE macro expands to nothing, so that instrumented hot paths
+  have no overhead.
+
+  PROFILE_SCOPE(component) measures the time until the end of the enclosing
+  scope with the time stamp counter of the CPU (or the steady clock on other
+  architectures). Scopes can be nested, and we attribute the time of a
+  scope to its component only if it is not spent in a nested scope
+  (self time). Each thread measures its time separately, and we sum the
+  times of all threads.
+*/
+enum class ProfilerComponent {
+    SUCCESSOR_GENERATION,
+    STATE_REGISTRATION,
+    PRUNING,
+    OPEN_LIST
+};
+
+/*
+  Register a further component, e.g., for an evaluator, and return its ID.
+  Components with the same name are merged.
+*/
+extern int register_profiler_component(const std::string &name);
+
+class ProfilerScope {
+    int component;
+    ProfilerScope *parent;
+    uint64_t start;
+    uint64_t nested_ticks;
+public:
+    explicit ProfilerScope(int component);
+    explicit ProfilerScope(ProfilerComponent component)
+        : ProfilerScope(static_cast<int>(component)) {
+    }
+    ~ProfilerScope();
+
+    ProfilerScope(const ProfilerScope &) = delete;
+    ProfilerScope &operator=(const ProfilerScope &) = delete;
+};
+
+/*
+  Print the number of calls and the self time of each component that has
+  been measured. Does nothing if no time has been measured, e.g., because
+  the profiler is not compiled in.
+*/
+extern void print_profile(LogProxy &log);
+}
+
+#ifdef USE_PROFILER
+#define PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_(a, b)
+#define PROFILE_SCOPE(component) \
+    utils::ProfilerScope PROFILE_SCOPE_CONCAT(profiler_scope_, __LINE__)( \
+        component)
+#else
+#define PROFILE_SCOPE(component)
+#endif
+
+#endif
@@ -33,6 +33,7 @@
 #include <limits>
 #include <new>
 #include <stdlib.h>
+#include <string>
 #include <unistd.h>
 
 #if OPERATING_SYSTEM == OSX
@@ -185,6 +186,31 @@ static void signal_handler(int signal_number) {
         print_peak_memory_in_kb_reentrant() is used in signal handlers.
         The latter is slower but guarantees reentrancy.
 */
+#if OPERATING_SYSTEM == LINUX
+/*
+  Return the value of the given field of /proc/self/status, which is given
+  in KB for the memory fields, or -1 on error.
+*/
+static int read_proc_status_field(const string &field) {
+    int value = -1;
+    ifstream procfile;
+    procfile.open("/proc/self/status");
+    string word;
+    while (procfile.good()) {
+        procfile >> word;
+        if (word == field) {
+            procfile >> value;
+            break;
+        }
+        // Skip to end of line.
+        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    if (procfile.fail())
+        value = -1;
+    return value;
+}
+#endif
+
 int get_peak_memory_in_kb() {
     // On error, produces a warning on cerr and returns -1.
     int memory_in_kb = -1;
@@ -201,20 +227,7 @@ int get_peak_memory_in_kb() {
         memory_in_kb = t_info.virtual_size / 1024;
     }
 #else
-    ifstream procfile;
-    procfile.open("/proc/self/status");
-    string word;
-    while (procfile.good()) {
-        procfile >> word;
-        if (word == "VmPeak:") {
-            procfile >> memory_in_kb;
-            break;
-        }
-        // Skip to end of line.
-        procfile.ignore(numeric_limits<streamsize>::max(), '\n');
-    }
-    if (procfile.fail())
-        memory_in_kb = -1;
+    memory_in_kb = read_proc_status_field("VmPeak:");
 #endif
 
     if (memory_in_kb == -1)
@@ -222,6 +235,28 @@ int get_peak_memory_in_kb() {
     return memory_in_kb;
 }
 
+int get_current_memory_in_kb() {
+    int memory_in_kb = -1;
+
+#if OPERATING_SYSTEM == OSX
+    task_basic_info t_info;
+    mach_msg_type_number_t t_info_count = TASK_BASIC_INFO_COUNT;
+
+    if (task_info(
+            mach_task_self(), TASK_BASIC_INFO,
+            reinterpret_cast<task_info_t>(&t_info),
+            &t_info_count) == KERN_SUCCESS) {
+        memory_in_kb = t_info.resident_size / 1024;
+    }
+#else
+    memory_in_kb = read_proc_status_field("VmRSS:");
+#endif
+
+    if (memory_in_kb == -1)
+        cerr << "warning: could not determine current memory" << endl;
+    return memory_in_kb;
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
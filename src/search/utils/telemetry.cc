@@ -0,0 +1,240 @@
+#include "telemetry.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+bool g_telemetry_enabled = false;
+
+/*
+  State shared by the search and the background thread. The background
+  thread keeps it alive, so that we can detach the thread if it is still
+  blocked in opening a named pipe when the planner exits.
+*/
+struct TelemetryQueue {
+    // Maximum number of lines waiting to be written.
+    static constexpr size_t MAX_QUEUED_LINES = 1024;
+
+    mutex queue_mutex;
+    condition_variable lines_available;
+    condition_variable writer_finished;
+    deque<string> lines;
+    bool stop_requested = false;
+    bool finished = false;
+    atomic<long long> num_dropped_lines{0};
+};
+
+static void write_lines(shared_ptr<TelemetryQueue> queue, string path) {
+    ofstream file(path);
+    if (!file) {
+        cerr << "Could not open telemetry file " << path << endl;
+    }
+    unique_lock<mutex> lock(queue->queue_mutex);
+    while (true) {
+        queue->lines_available.wait(lock, [&queue]() {
+            return queue->stop_requested || !queue->lines.empty();
+        });
+        if (queue->lines.empty()) {
+            break;
+        }
+        deque<string> batch;
+        swap(batch, queue->lines);
+        lock.unlock();
+        for (const string &line : batch) {
+            file << line << '\n';
+        }
+        file.flush();
+        lock.lock();
+    }
+    queue->finished = true;
+    queue->writer_finished.notify_all();
+}
+
+class TelemetryWriter {
+    shared_ptr<TelemetryQueue> queue;
+    thread writer_thread;
+public:
+    explicit TelemetryWriter(const string &path)
+        : queue(make_shared<TelemetryQueue>()),
+          writer_thread(write_lines, queue, path) {
+    }
+
+    ~TelemetryWriter() {
+        unique_lock<mutex> lock(queue->queue_mutex);
+        queue->stop_requested = true;
+        queue->lines_available.notify_all();
+        /*
+          Give the writer some time to write the remaining lines. It can
+          block indefinitely if no reader opens the named pipe.
+        */
+        bool finished = queue->writer_finished.wait_for(
+            lock, chrono::seconds(5), [this]() {return queue->finished;});
+        lock.unlock();
+        if (finished) {
+            writer_thread.join();
+        } else {
+            writer_thread.detach();
+        }
+    }
+
+    void push(string &&line) {
+        {
+            lock_guard<mutex> lock(queue->queue_mutex);
+            if (queue->lines.size() >= TelemetryQueue::MAX_QUEUED_LINES) {
+                ++queue->num_dropped_lines;
+                return;
+            }
+            queue->lines.push_back(move(line));
+        }
+        queue->lines_available.notify_one();
+    }
+
+    long long get_num_dropped_lines() const {
+        return queue->num_dropped_lines;
+    }
+};
+
+static unique_ptr<TelemetryWriter> telemetry_writer;
+static chrono::steady_clock::duration telemetry_interval;
+static chrono::steady_clock::time_point next_telemetry_time;
+static thread::id telemetry_thread;
+// Protects the timers, which can be registered from any thread.
+static mutex timer_mutex;
+static vector<string> timer_names;
+static vector<double> timer_seconds;
+
+void enable_telemetry(const string &path, double interval) {
+    telemetry_writer = make_unique<TelemetryWriter>(path);
+    telemetry_interval = chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double>(interval));
+    next_telemetry_time = chrono::steady_clock::now();
+    telemetry_thread = this_thread::get_id();
+    g_telemetry_enabled = true;
+}
+
+bool is_telemetry_thread() {
+    return this_thread::get_id() == telemetry_thread;
+}
+
+bool is_telemetry_due() {
+    if (!g_telemetry_enabled) {
+        return false;
+    }
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (now < next_telemetry_time) {
+        return false;
+    }
+    next_telemetry_time = now + telemetry_interval;
+    return true;
+}
+
+static void write_json_string(string &json, const string &value) {
+    json += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[7];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            json += escaped;
+        } else {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+void TelemetryRecord::add_key(const string &key) {
+    json += json.empty() ? '{' : ',';
+    write_json_string(json, key);
+    json += ':';
+}
+
+void TelemetryRecord::add(const string &key, int value) {
+    add(key, static_cast<long long>(value));
+}
+
+void TelemetryRecord::add(const string &key, long long value) {
+    add_key(key);
+    json += std::to_string(value);
+}
+
+void TelemetryRecord::add(const string &key, double value) {
+    if (!isfinite(value)) {
+        add_null(key);
+        return;
+    }
+    add_key(key);
+    char formatted[32];
+    snprintf(formatted, sizeof(formatted), "%.6g", value);
+    json += formatted;
+}
+
+void TelemetryRecord::add(const string &key, const string &value) {
+    add_key(key);
+    write_json_string(json, value);
+}
+
+void TelemetryRecord::add(const string &key, const TelemetryRecord &object) {
+    add_key(key);
+    json += object.to_string();
+}
+
+void TelemetryRecord::add_null(const string &key) {
+    add_key(key);
+    json += "null";
+}
+
+string TelemetryRecord::to_string() const {
+    return json.empty() ? "{}" : json + '}';
+}
+
+void write_telemetry_record(TelemetryRecord &&record) {
+    if (!telemetry_writer) {
+        return;
+    }
+    record.add("dropped_lines", telemetry_writer->get_num_dropped_lines());
+    telemetry_writer->push(record.to_string());
+}
+
+int get_telemetry_timer(const string &name) {
+    lock_guard<mutex> lock(timer_mutex);
+    for (size_t timer = 0; timer < timer_names.size(); ++timer) {
+        if (timer_names[timer] == name) {
+            return timer;
+        }
+    }
+    timer_names.push_back(name);
+    timer_seconds.push_back(0);
+    return timer_names.size() - 1;
+}
+
+void add_telemetry_time(int timer, double seconds) {
+    assert(is_telemetry_thread());
+    lock_guard<mutex> lock(timer_mutex);
+    timer_seconds[timer] += seconds;
+}
+
+TelemetryRecord get_telemetry_times() {
+    lock_guard<mutex> lock(timer_mutex);
+    TelemetryRecord times;
+    for (size_t timer = 0; timer < timer_names.size(); ++timer) {
+        times.add(timer_names[timer], timer_seconds[timer]);
+    }
+    return times;
+}
+}
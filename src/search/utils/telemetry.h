@@ -0,0 +1,79 @@
+#ifndef UTILS_TELEMETRY_H
+#define UTILS_TELEMETRY_H
+
+#include <string>
+
+namespace utils {
+/*
+  Machine-readable telemetry for monitoring running searches (see the
+  --telemetry option). The search regularly writes one JSON object per line
+  to a file or named pipe. The lines are written by a background thread, so
+  the search only formats a line and appends it to a queue. If the reader
+  cannot keep up, we drop lines instead of blocking the search and report
+  the number of dropped lines in the following lines.
+
+  Telemetry is disabled by default, in which case users should only check
+  is_telemetry_enabled() in hot loops.
+
+  Lines are only written and evaluator times are only measured on the
+  thread that enabled telemetry (the main thread). Search algorithms that
+  run their whole search in worker threads (e.g., hdastar or eager_greedy
+  with threads > 1) therefore only write the final line, and their
+  evaluator times do not contain the evaluations of the workers.
+*/
+extern bool g_telemetry_enabled;
+
+/*
+  Start the background thread, which opens the file at the given path.
+  Opening a named pipe blocks until a reader opens it, but this only delays
+  the background thread.
+*/
+extern void enable_telemetry(const std::string &path, double interval);
+
+inline bool is_telemetry_enabled() {
+    return g_telemetry_enabled;
+}
+
+// Return true if the calling thread is the thread that enabled telemetry.
+extern bool is_telemetry_thread();
+
+/*
+  Return true if telemetry is enabled and the interval has passed since the
+  last time this function returned true.
+*/
+extern bool is_telemetry_due();
+
+// JSON object with one member per call of add().
+class TelemetryRecord {
+    std::string json;
+
+    void add_key(const std::string &key);
+public:
+    void add(const std::string &key, int value);
+    void add(const std::string &key, long long value);
+    // Non-finite values are written as null.
+    void add(const std::string &key, double value);
+    void add(const std::string &key, const std::string &value);
+    void add(const std::string &key, const TelemetryRecord &object);
+    void add_null(const std::string &key);
+
+    std::string to_string() const;
+};
+
+// Queue the record for writing, adding the number of dropped lines.
+extern void write_telemetry_record(TelemetryRecord &&record);
+
+/*
+  Timers accumulate the time of named activities, such as the computation
+  of evaluator values, while telemetry is enabled. Timers with the same name
+  are merged. They can be registered from any thread (e.g., when worker
+  threads construct evaluators), but times must only be added on the
+  telemetry thread.
+*/
+extern int get_telemetry_timer(const std::string &name);
+extern void add_telemetry_time(int timer, double seconds);
+// Return an object that maps the names of all timers to their times.
+extern TelemetryRecord get_telemetry_times();
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "thread_pool.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+ThreadPool::ThreadPool(int num_threads)
+    : tasks(nullptr),
+      next_task(0),
+      num_unfinished_tasks(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    workers.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        shutting_down = true;
+    }
+    work_available.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::has_pending_task() const {
+    return tasks && next_task < tasks->size();
+}
+
+void ThreadPool::execute_pending_tasks(unique_lock<std::mutex> &lock) {
+    while (has_pending_task()) {
+        const function<void()> &task = (*tasks)[next_task++];
+        lock.unlock();
+        task();
+        lock.lock();
+        if (--num_unfinished_tasks == 0) {
+            work_finished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::work() {
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_available.wait(
+            lock, [this]() { return shutting_down || has_pending_task(); });
+        if (shutting_down) {
+            return;
+        }
+        execute_pending_tasks(lock);
+    }
+}
+
+int ThreadPool::get_num_threads() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::run(const vector<function<void()>> &new_tasks) {
+    if (workers.empty() || new_tasks.size() <= 1) {
+        for (const function<void()> &task : new_tasks) {
+            task();
+        }
+        return;
+    }
+    lock_guard<std::mutex> run_lock(run_mutex);
+    unique_lock<std::mutex> lock(mutex);
+    assert(!tasks);
+    tasks = &new_tasks;
+    next_task = 0;
+    num_unfinished_tasks = new_tasks.size();
+    work_available.notify_all();
+    execute_pending_tasks(lock);
+    work_finished.wait(lock, [this]() { return num_unfinished_tasks == 0; });
+    tasks = nullptr;
+}
+}
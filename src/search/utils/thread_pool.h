@@ -0,0 +1,53 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Fixed set of worker threads for fork-join parallelism.
+
+  run() distributes the given tasks over the worker threads and the calling
+  thread and returns once all tasks have finished. The pool is meant for a
+  small number of expensive tasks (e.g., evaluating several heuristics for
+  the same state), so tasks are handed out under a single lock.
+
+  Calls of run() from several threads (e.g., from the threads of a parallel
+  search) are serialized. Tasks must not call run() on the same pool.
+*/
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex run_mutex;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    // The following members are protected by the mutex.
+    const std::vector<std::function<void()>> *tasks;
+    size_t next_task;
+    size_t num_unfinished_tasks;
+    bool shutting_down;
+
+    bool has_pending_task() const;
+    void execute_pending_tasks(std::unique_lock<std::mutex> &lock);
+    void work();
+public:
+    /*
+      Create a pool that runs tasks on num_threads threads in total,
+      including the thread that calls run().
+    */
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const;
+    void run(const std::vector<std::function<void()>> &tasks);
+};
+}
+
+#endif